@@ -23,23 +23,343 @@
 /******************************************************************************
  * Macro Declarations
  ******************************************************************************/
-#define LIS3MDL_I2C_BUS_ADDRESS		0x10
-#define LIS3MDL_SPEED_MASK			0x1C	/* Bit DO0, DO1, DO2 */
-#define LIS3MDL_FAST_ODR_MASK		0x01
+#define LIS3MDL_SPEED_MASK			(LIS3MDL_CTRL1_OM_MASK | LIS3MDL_CTRL1_DO_MASK | LIS3MDL_CTRL1_FAST_ODR)
+#define LIS3MDL_ARRAY_LEN(a)		((uint16_t)(sizeof(a) / sizeof((a)[0])))
+#define LIS3MDL_XYZ_BURST_LEN		6u		/* OUT_X_L .. OUT_Z_H */
+#define LIS3MDL_XYZ8_BURST_LEN		3u		/* OUT_X_H, OUT_Y_H, OUT_Z_H with FAST_READ */
+#define LIS3MDL_TEMP_LSB_PER_DEGC	8.0f	/* TEMP_OUT sensitivity */
+#define LIS3MDL_TEMP_ZERO_DEGC		25.0f	/* Temperature read as TEMP_OUT = 0 */
+#define LIS3MDL_COHERENT_ATTEMPTS	4u		/* Bursts tried by a BDU read before it gives up */
+
+/******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+/* Output data rate in mHz with FAST_ODR clear, indexed by Lis3mdlDataRate_t (CTRL_REG1 DO) */
+static const uint32_t Lis3mdlOdrMilliHz_au32[] =
+{
+	625u, 1250u, 2500u, 5000u, 10000u, 20000u, 40000u, 80000u
+};
+
+/* Output data rate in mHz with FAST_ODR set, indexed by Lis3mdlOperatingMode_t (CTRL_REG1 OM) */
+static const uint32_t Lis3mdlFastOdrMilliHz_au32[] =
+{
+	1000000u, 560000u, 300000u, 155000u
+};
+
+/* LSB per gauss of the 16-bit output, indexed by Lis3mdlScale_t */
+static const uint16_t Lis3mdlSensitivity_au16[] = { 6842u, 3421u, 2281u, 1711u };
+
+/******************************************************************************
+ * Static Function Definitions
+ ******************************************************************************/
+static void Lis3mdlUnpackXYZ(const uint8_t *burst_pu8, Lis3mdlSampleXYZ_st *sample_pst)
+{
+	sample_pst->x_s16 = (int16_t)((burst_pu8[1] << 8) | burst_pu8[0]);
+	sample_pst->y_s16 = (int16_t)((burst_pu8[3] << 8) | burst_pu8[2]);
+	sample_pst->z_s16 = (int16_t)((burst_pu8[5] << 8) | burst_pu8[4]);
+}
+
+
+/* STATUS_REG..OUT_Z_H, extended to TEMP_OUT_H when a temperature read is due. */
+static uint8_t Lis3mdlStatusBurstLen(const Lis3mdlDevice_st *dev_pst)
+{
+	if((dev_pst->shadow_st.valid_u8 != 0u) &&
+	   ((dev_pst->shadow_st.ctrlReg_au8[0] & LIS3MDL_CTRL1_TEMP_EN) != 0u) &&
+	   (dev_pst->temperature_st.countdown_u16 == 0u))
+	{
+		return LIS3MDL_TEMP_BURST_LEN;
+	}
+
+	return LIS3MDL_STATUS_BURST_LEN;
+}
+
+
+/* Decode a STATUS_REG..OUT_Z_H (or ..TEMP_OUT_H) burst; returns 1 when the sample was updated. */
+static uint8_t Lis3mdlDecodeStatusBurst(Lis3mdlDevice_st *dev_pst, const uint8_t *burst_pu8, uint8_t burstLen_u8,
+										Lis3mdlSampleXYZ_st *sample_pst)
+{
+	Lis3mdlTemperature_st *temperature_pst = &dev_pst->temperature_st;
+
+	if((burst_pu8[0] & LIS3MDL_STATUS_ZYXOR) != 0u)
+	{
+		dev_pst->stats_st.overruns_u32++;
+	}
+
+	/* A burst carrying the temperature counts as one of the decimation reads, new sample or not */
+	if(burstLen_u8 == LIS3MDL_TEMP_BURST_LEN)
+	{
+		temperature_pst->raw_s16 = (int16_t)((burst_pu8[LIS3MDL_STATUS_BURST_LEN + 1u] << 8) |
+											 burst_pu8[LIS3MDL_STATUS_BURST_LEN]);
+		temperature_pst->countdown_u16 = (uint16_t)(temperature_pst->decimation_u16 - 1u);
+	}
+	else if(((burst_pu8[0] & LIS3MDL_STATUS_ZYXDA) != 0u) && (temperature_pst->countdown_u16 != 0u))
+	{
+		temperature_pst->countdown_u16--;
+	}
+
+	if((burst_pu8[0] & LIS3MDL_STATUS_ZYXDA) != 0u)
+	{
+		Lis3mdlUnpackXYZ(&burst_pu8[1], sample_pst);
+		return 1u;
+	}
+
+	return 0u;
+}
+
+
+static void Lis3mdlAsyncReadComplete(status_t status, void *context_pv)
+{
+	Lis3mdlDevice_st *dev_pst = (Lis3mdlDevice_st *)context_pv;
+	Lis3mdlAsyncRead_st request_st = dev_pst->asyncRead_st;
+	uint8_t newData_u8 = 0u;
+
+	if(status == STATUS_OK)
+	{
+		newData_u8 = Lis3mdlDecodeStatusBurst(dev_pst, request_st.burst_au8, request_st.burstLen_u8,
+											  request_st.sample_pst);
+	}
+
+	/* Release before calling back so the callback can chain the next read. */
+	/* Pairs with the acquire in Lis3mdlReadXYZIfReadyAsync: the decoded state is published with it. */
+	__atomic_store_n(&dev_pst->asyncRead_st.busy_u8, 0u, __ATOMIC_RELEASE);
+
+	if(request_st.callback_pfn != (Lis3mdlSampleCallback_t)0)
+	{
+		request_st.callback_pfn(status, newData_u8, request_st.context_pv);
+	}
+}
+
+/* FAST_READ breaks the 16-bit bursts; the shadow answers without bus traffic. */
+static uint8_t Lis3mdlFastReadEnabled(const Lis3mdlDevice_st *dev_pst)
+{
+	return (uint8_t)((dev_pst->shadow_st.valid_u8 != 0u) &&
+					 ((dev_pst->shadow_st.ctrlReg_au8[LIS3MDL_CTRL_REG5 - LIS3MDL_CTRL_REG1] &
+					   LIS3MDL_CTRL5_FAST_READ) != 0u));
+}
+
+
+static uint8_t Lis3mdlBduEnabled(const Lis3mdlDevice_st *dev_pst)
+{
+	return (uint8_t)((dev_pst->shadow_st.valid_u8 != 0u) &&
+					 ((dev_pst->shadow_st.ctrlReg_au8[LIS3MDL_CTRL_REG5 - LIS3MDL_CTRL_REG1] &
+					   LIS3MDL_CTRL5_BDU) != 0u));
+}
+
+
+/*
+ * STATUS_REG read right after an output burst. A conversion publishes by setting every
+ * axis' DA bit and the burst then consumes the axes it has yet to read, so X (or Y) still
+ * pending with Z consumed, or a second conversion on top (ZYXOR), means the axes came
+ * from two conversions. One conversion after the Z read leaves all three set: coherent.
+ */
+static uint8_t Lis3mdlBurstTorn(uint8_t status_u8)
+{
+	return (uint8_t)(((status_u8 & (LIS3MDL_STATUS_XDA | LIS3MDL_STATUS_YDA)) != 0u) &&
+					 (((status_u8 & LIS3MDL_STATUS_ZDA) == 0u) || ((status_u8 & LIS3MDL_STATUS_ZYXOR) != 0u)));
+}
+
+
+/*
+ * Read a burst covering OUT_X_L..OUT_Z_H. BDU holds each axis whole but not the set, so
+ * with BDU on the burst is followed by STATUS_REG in the same transaction and repeated
+ * while that reports a conversion between the axes; STATUS_ERROR once every attempt did.
+ */
+static status_t Lis3mdlReadCoherent(Lis3mdlDevice_st *dev_pst, uint8_t regAddress_u8, uint16_t length_u16,
+									uint8_t *burst_pu8)
+{
+	uint8_t after_u8 = 0u;
+	i2c_msg_t msgs_ast[] =
+	{
+		{ (uint8_t)(regAddress_u8 | LIS3MDL_AUTO_INCREMENT), I2C_MSG_READ, length_u16, burst_pu8 },
+		{ LIS3MDL_STATUS_REG, I2C_MSG_READ, 1u, &after_u8 },
+	};
+	status_t status = STATUS_ERROR;
+
+	if(!Lis3mdlBduEnabled(dev_pst))
+	{
+		return i2c_bus_read(dev_pst->bus_u8, dev_pst->address_u8, msgs_ast[0].register_address,
+							length_u16, burst_pu8);
+	}
+
+	for(uint32_t attempt_u32 = 0u; attempt_u32 < LIS3MDL_COHERENT_ATTEMPTS; attempt_u32++)
+	{
+		status = i2c_transfer(dev_pst->bus_u8, dev_pst->address_u8, msgs_ast, LIS3MDL_ARRAY_LEN(msgs_ast));
+
+		if((status != STATUS_OK) || !Lis3mdlBurstTorn(after_u8))
+		{
+			return status;
+		}
+	}
+
+	return STATUS_ERROR;
+}
+
+
+static uint8_t * Lis3mdlShadowReg(Lis3mdlShadow_st *shadow_pst, uint8_t regAddress_u8)
+{
+	if((regAddress_u8 >= LIS3MDL_CTRL_REG1) && (regAddress_u8 <= LIS3MDL_CTRL_REG5))
+	{
+		return &shadow_pst->ctrlReg_au8[regAddress_u8 - LIS3MDL_CTRL_REG1];
+	}
+	else if(regAddress_u8 == LIS3MDL_INT_CFG)
+	{
+		return &shadow_pst->intCfg_u8;
+	}
+	else if((regAddress_u8 == LIS3MDL_INT_THS_L) || (regAddress_u8 == LIS3MDL_INT_THS_H))
+	{
+		return &shadow_pst->intThs_au8[regAddress_u8 - LIS3MDL_INT_THS_L];
+	}
+	else
+	{
+		return (uint8_t *)0;
+	}
+}
+
+
+/* Fill the shadow on first use so getters keep working without an explicit Lis3mdlInit. */
+static status_t Lis3mdlShadowEnsure(Lis3mdlDevice_st *dev_pst)
+{
+	if(dev_pst->shadow_st.valid_u8 != 0u)
+	{
+		return STATUS_OK;
+	}
+
+	return Lis3mdlResync(dev_pst);
+}
+
+
+/* Write one shadowed register and keep the shadow in step with the device. */
+static status_t Lis3mdlWriteReg(Lis3mdlDevice_st *dev_pst, uint8_t regAddress_u8, uint8_t regVal_u8)
+{
+	uint8_t *shadow_pu8 = Lis3mdlShadowReg(&dev_pst->shadow_st, regAddress_u8);
+	status_t status = i2c_bus_write(dev_pst->bus_u8, dev_pst->address_u8, regAddress_u8, 1u, &regVal_u8);
+
+	if((status == STATUS_OK) && (shadow_pu8 != (uint8_t *)0))
+	{
+		*shadow_pu8 = regVal_u8;
+	}
+
+	return status;
+}
+
+
+/* Read-modify-write of a shadowed register; no bus traffic when nothing changes. */
+static status_t Lis3mdlUpdateBits(Lis3mdlDevice_st *dev_pst, uint8_t regAddress_u8, uint8_t mask_u8,
+								  uint8_t value_u8)
+{
+	uint8_t regVal_u8;
+	uint8_t newVal_u8;
+	status_t status = STATUS_DEFAULT;
+
+	status = Lis3mdlShadowEnsure(dev_pst);
+
+	if(status == STATUS_OK)
+	{
+		regVal_u8 = *Lis3mdlShadowReg(&dev_pst->shadow_st, regAddress_u8);
+		newVal_u8 = (uint8_t)((regVal_u8 & ~mask_u8) | (value_u8 & mask_u8));
+
+		if(newVal_u8 != regVal_u8)
+		{
+			status = Lis3mdlWriteReg(dev_pst, regAddress_u8, newVal_u8);
+		}
+	}
+
+	return status;
+}
 
 /******************************************************************************
  * Extern Function Definitions
  ******************************************************************************/
-extern status_t Lis3mdlGetFullScaleConfig(Lis3mdlScale_t *configScale_pen)
+extern status_t Lis3mdlInit(Lis3mdlDevice_st * dev_pst, uint8_t bus_u8, uint8_t address_u8)
+{
+	Lis3mdlDevice_st device_st = { 0 };
+	status_t status = STATUS_DEFAULT;
+
+	device_st.bus_u8 = bus_u8;
+	device_st.address_u8 = address_u8;
+	device_st.temperature_st.raw_s16 = LIS3MDL_TEMP_INVALID;
+	device_st.temperature_st.decimation_u16 = 1u;
+	*dev_pst = device_st;
+
+	status = Lis3mdlResync(dev_pst);
+
+	if(status == STATUS_OK)
+	{
+		status = Lis3mdlSetBlockDataUpdate(dev_pst, 1u);
+	}
+
+	return status;
+}
+
+
+extern status_t Lis3mdlResync(Lis3mdlDevice_st * dev_pst)
+{
+	Lis3mdlShadow_st shadow_st = { 0 };
+	status_t status = STATUS_DEFAULT;
+
+	/* INT_SRC (0x31) is skipped on purpose: reading it clears a latched interrupt. */
+	i2c_msg_t msgs_ast[] =
+	{
+		{ (LIS3MDL_CTRL_REG1 | LIS3MDL_AUTO_INCREMENT), I2C_MSG_READ, LIS3MDL_CTRL_REG_COUNT, shadow_st.ctrlReg_au8 },
+		{ LIS3MDL_INT_CFG, I2C_MSG_READ, 1u, &shadow_st.intCfg_u8 },
+		{ (LIS3MDL_INT_THS_L | LIS3MDL_AUTO_INCREMENT), I2C_MSG_READ, LIS3MDL_INT_THS_LEN, shadow_st.intThs_au8 }
+	};
+
+	dev_pst->shadow_st.valid_u8 = 0u;
+
+	status = i2c_transfer(dev_pst->bus_u8, dev_pst->address_u8, msgs_ast, LIS3MDL_ARRAY_LEN(msgs_ast));
+
+	if(status == STATUS_OK)
+	{
+		shadow_st.valid_u8 = 1u;
+		dev_pst->shadow_st = shadow_st;
+	}
+
+	return status;
+}
+
+
+extern status_t Lis3mdlWriteConfig(Lis3mdlDevice_st * dev_pst, const Lis3mdlShadow_st * config_pst)
+{
+	Lis3mdlShadow_st write_st = *config_pst;
+	Lis3mdlShadow_st readBack_st = { 0 };
+	status_t status = STATUS_DEFAULT;
+
+	i2c_msg_t msgs_ast[] =
+	{
+		{ (LIS3MDL_CTRL_REG1 | LIS3MDL_AUTO_INCREMENT), I2C_MSG_WRITE, LIS3MDL_CTRL_REG_COUNT, write_st.ctrlReg_au8 },
+		{ LIS3MDL_INT_CFG, I2C_MSG_WRITE, 1u, &write_st.intCfg_u8 },
+		{ (LIS3MDL_INT_THS_L | LIS3MDL_AUTO_INCREMENT), I2C_MSG_WRITE, LIS3MDL_INT_THS_LEN, write_st.intThs_au8 },
+		{ (LIS3MDL_CTRL_REG1 | LIS3MDL_AUTO_INCREMENT), I2C_MSG_READ, LIS3MDL_CTRL_REG_COUNT, readBack_st.ctrlReg_au8 },
+		{ LIS3MDL_INT_CFG, I2C_MSG_READ, 1u, &readBack_st.intCfg_u8 },
+		{ (LIS3MDL_INT_THS_L | LIS3MDL_AUTO_INCREMENT), I2C_MSG_READ, LIS3MDL_INT_THS_LEN, readBack_st.intThs_au8 }
+	};
+
+	dev_pst->shadow_st.valid_u8 = 0u;
+
+	status = i2c_transfer(dev_pst->bus_u8, dev_pst->address_u8, msgs_ast, LIS3MDL_ARRAY_LEN(msgs_ast));
+
+	if(status == STATUS_OK)
+	{
+		readBack_st.valid_u8 = 1u;
+		dev_pst->shadow_st = readBack_st;
+	}
+
+	return status;
+}
+
+
+extern status_t Lis3mdlGetFullScaleConfig(Lis3mdlDevice_st * dev_pst, Lis3mdlScale_t *configScale_pen)
 {
     uint8_t readBuffer_u8;
     status_t status = STATUS_DEFAULT;
 
-    status = i2c_read(LIS3MDL_I2C_BUS_ADDRESS, LIS3MDL_CTRL_REG2, 1u, &readBuffer_u8);
+    status = Lis3mdlShadowEnsure(dev_pst);
+    readBuffer_u8 = dev_pst->shadow_st.ctrlReg_au8[LIS3MDL_CTRL_REG2 - LIS3MDL_CTRL_REG1];
 
     if (status == STATUS_OK) 
     {
-        uint8_t scaleBits_u8 = (readBuffer_u8 >> 6) & 0x03;
+        uint8_t scaleBits_u8 = (readBuffer_u8 & LIS3MDL_CTRL2_FS_MASK) >> LIS3MDL_CTRL2_FS_SHIFT;
 
         switch (scaleBits_u8)
         {
@@ -52,11 +372,9 @@ extern status_t Lis3mdlGetFullScaleConfig(Lis3mdlScale_t *configScale_pen)
 		case 0x02:
 			*configScale_pen = LIS3MDL_SCALE_12G;
 			break;
-		case 0x03:
-			*configScale_pen = LIS3MDL_SCALE_16G;
-			break;
 		default:
-			*configScale_pen = LIS3MDL_SCALE_UNKNOWN;
+			/* 0x03: every value of the 2-bit field is a valid scale */
+			*configScale_pen = LIS3MDL_SCALE_16G;
 			break;
         }
 
@@ -69,60 +387,222 @@ extern status_t Lis3mdlGetFullScaleConfig(Lis3mdlScale_t *configScale_pen)
 }
 
 
-extern status_t Lis3mdlSetOutputDataRate(Lis3mdlSpeedConfig_st  config_st)
+extern status_t Lis3mdlSetOutputDataRate(Lis3mdlDevice_st * dev_pst, Lis3mdlSpeedConfig_st  config_st)
 {
-	uint8_t regVal_u8 = ((config_st.dataRate_en << 2) & LIS3MDL_SPEED_MASK) | (config_st.operatingMode_en & 0x03) | (config_st.fastOdr_u8 & LIS3MDL_FAST_ODR_MASK);
-	
-	
-	status_t status = i2c_write(LIS3MDL_I2C_BUS_ADDRESS, LIS3MDL_CTRL_REG1,
-								 1u, &regVal_u8);
-	
+	uint8_t *ctrl1_pu8 = &dev_pst->shadow_st.ctrlReg_au8[LIS3MDL_CTRL_REG1 - LIS3MDL_CTRL_REG1];
+	uint8_t *ctrl4_pu8 = &dev_pst->shadow_st.ctrlReg_au8[LIS3MDL_CTRL_REG4 - LIS3MDL_CTRL_REG1];
+	uint8_t ctrl1_u8;
+	uint8_t ctrl4_u8;
+	uint16_t count_u16 = 0u;
+	i2c_msg_t msgs_ast[2];
+	status_t status = STATUS_DEFAULT;
+
+	if(((uint32_t)config_st.dataRate_en >= LIS3MDL_ARRAY_LEN(Lis3mdlOdrMilliHz_au32)) ||
+	   ((uint32_t)config_st.operatingMode_en >= LIS3MDL_ARRAY_LEN(Lis3mdlFastOdrMilliHz_au32)))
+	{
+		return STATUS_ERROR;
+	}
+
+	status = Lis3mdlShadowEnsure(dev_pst);
+
+	if(status == STATUS_OK)
+	{
+		/* TEMP_EN and ST are kept; Z follows the X/Y operating mode */
+		ctrl1_u8 = (uint8_t)((*ctrl1_pu8 & ~LIS3MDL_SPEED_MASK) |
+							 ((uint8_t)config_st.operatingMode_en << LIS3MDL_CTRL1_OM_SHIFT) |
+							 ((uint8_t)config_st.dataRate_en << LIS3MDL_CTRL1_DO_SHIFT) |
+							 ((config_st.fastOdr_u8 != 0u) ? LIS3MDL_CTRL1_FAST_ODR : 0u));
+		ctrl4_u8 = (uint8_t)((*ctrl4_pu8 & ~LIS3MDL_CTRL4_OMZ_MASK) |
+							 ((uint8_t)config_st.operatingMode_en << LIS3MDL_CTRL4_OMZ_SHIFT));
+
+		if(ctrl4_u8 != *ctrl4_pu8)
+		{
+			msgs_ast[count_u16++] = (i2c_msg_t){ LIS3MDL_CTRL_REG4, I2C_MSG_WRITE, 1u, &ctrl4_u8 };
+		}
+		if(ctrl1_u8 != *ctrl1_pu8)
+		{
+			msgs_ast[count_u16++] = (i2c_msg_t){ LIS3MDL_CTRL_REG1, I2C_MSG_WRITE, 1u, &ctrl1_u8 };
+		}
+
+		if(count_u16 != 0u)
+		{
+			status = i2c_transfer(dev_pst->bus_u8, dev_pst->address_u8, msgs_ast, count_u16);
+		}
+
+		if(status == STATUS_OK)
+		{
+			*ctrl1_pu8 = ctrl1_u8;
+			*ctrl4_pu8 = ctrl4_u8;
+		}
+		else
+		{
+			/* Unknown which segment landed */
+			dev_pst->shadow_st.valid_u8 = 0u;
+		}
+	}
+
 	return status;
 }
 
 
-extern status_t Lis3mdlGetOutputDataRate(Lis3mdlSpeedConfig_st * config_st)
+extern status_t Lis3mdlGetOutputDataRate(Lis3mdlDevice_st * dev_pst, Lis3mdlSpeedConfig_st * config_st)
+{
+	uint8_t regVal_u8;
+	status_t status = STATUS_DEFAULT;
+
+	status = Lis3mdlShadowEnsure(dev_pst);
+	regVal_u8 = dev_pst->shadow_st.ctrlReg_au8[0];
+
+	if(status == STATUS_OK)
+	{
+		config_st->dataRate_en 		= (Lis3mdlDataRate_t)((regVal_u8 & LIS3MDL_CTRL1_DO_MASK) >> LIS3MDL_CTRL1_DO_SHIFT);
+		config_st->operatingMode_en = (Lis3mdlOperatingMode_t)((regVal_u8 & LIS3MDL_CTRL1_OM_MASK) >> LIS3MDL_CTRL1_OM_SHIFT);
+		config_st->fastOdr_u8 		= (uint8_t)((regVal_u8 & LIS3MDL_CTRL1_FAST_ODR) != 0u);
+	}
+
+	return status;
+}
+
+
+extern status_t Lis3mdlGetOutputDataRateMilliHz(const Lis3mdlSpeedConfig_st * config_pst, uint32_t * rate_pu32)
+{
+	if(config_pst->fastOdr_u8 != 0u)
+	{
+		if((uint32_t)config_pst->operatingMode_en >= LIS3MDL_ARRAY_LEN(Lis3mdlFastOdrMilliHz_au32))
+		{
+			return STATUS_ERROR;
+		}
+
+		*rate_pu32 = Lis3mdlFastOdrMilliHz_au32[config_pst->operatingMode_en];
+	}
+	else
+	{
+		if((uint32_t)config_pst->dataRate_en >= LIS3MDL_ARRAY_LEN(Lis3mdlOdrMilliHz_au32))
+		{
+			return STATUS_ERROR;
+		}
+
+		*rate_pu32 = Lis3mdlOdrMilliHz_au32[config_pst->dataRate_en];
+	}
+
+	return STATUS_OK;
+}
+
+
+extern status_t Lis3mdlFindSpeedConfig(uint32_t minRateMilliHz_u32, Lis3mdlOperatingMode_t mode_en,
+									   Lis3mdlSpeedConfig_st * config_pst)
+{
+	uint16_t index_u16;
+
+	if((uint32_t)mode_en >= LIS3MDL_ARRAY_LEN(Lis3mdlFastOdrMilliHz_au32))
+	{
+		return STATUS_ERROR;
+	}
+
+	config_pst->operatingMode_en = mode_en;
+
+	/* Slowest DO rate that is fast enough */
+	for(index_u16 = 0u; index_u16 < LIS3MDL_ARRAY_LEN(Lis3mdlOdrMilliHz_au32); index_u16++)
+	{
+		if(Lis3mdlOdrMilliHz_au32[index_u16] >= minRateMilliHz_u32)
+		{
+			config_pst->dataRate_en = (Lis3mdlDataRate_t)index_u16;
+			config_pst->fastOdr_u8 = 0u;
+			return STATUS_OK;
+		}
+	}
+
+	/* Above 80 Hz only FAST_ODR is left, and its rate is set by the operating mode */
+	if(Lis3mdlFastOdrMilliHz_au32[mode_en] >= minRateMilliHz_u32)
+	{
+		config_pst->dataRate_en = LIS3MDL_ODR_80_HZ;
+		config_pst->fastOdr_u8 = 1u;
+		return STATUS_OK;
+	}
+
+	return STATUS_ERROR;
+}
+
+
+extern status_t Lis3mdlSetSystemMode(Lis3mdlDevice_st * dev_pst, Lis3mdlSystemMode_t mode_en)
 {
+	uint8_t *ctrl3_pu8 = &dev_pst->shadow_st.ctrlReg_au8[LIS3MDL_CTRL_REG3 - LIS3MDL_CTRL_REG1];
 	uint8_t regVal_u8;
 	status_t status = STATUS_DEFAULT;
 
-	status = i2c_read(LIS3MDL_I2C_BUS_ADDRESS, LIS3MDL_CTRL_REG1,
-								1u, &regVal_u8);
+	switch(mode_en)
+	{
+		case LIS3MDL_SYSTEM_CONTINUOUS:
+			return Lis3mdlUpdateBits(dev_pst, LIS3MDL_CTRL_REG3, LIS3MDL_CTRL3_MD_MASK, LIS3MDL_CTRL3_MD_CONTINUOUS);
+
+		case LIS3MDL_SYSTEM_POWER_DOWN:
+			return Lis3mdlUpdateBits(dev_pst, LIS3MDL_CTRL_REG3, LIS3MDL_CTRL3_MD_MASK, LIS3MDL_CTRL3_MD_POWER_DOWN);
+
+		case LIS3MDL_SYSTEM_SINGLE:
+			break;
+
+		default:
+			return STATUS_ERROR;
+	}
+
+	status = Lis3mdlShadowEnsure(dev_pst);
+
+	if(status == STATUS_OK)
+	{
+		/* Unconditional write: each one starts a conversion */
+		regVal_u8 = (uint8_t)((*ctrl3_pu8 & ~LIS3MDL_CTRL3_MD_MASK) | LIS3MDL_CTRL3_MD_SINGLE);
+		status = i2c_bus_write(dev_pst->bus_u8, dev_pst->address_u8, LIS3MDL_CTRL_REG3, 1u, &regVal_u8);
+	}
+
+	if(status == STATUS_OK)
+	{
+		*ctrl3_pu8 = (uint8_t)((*ctrl3_pu8 & ~LIS3MDL_CTRL3_MD_MASK) | LIS3MDL_CTRL3_MD_POWER_DOWN);
+	}
+
+	return status;
+}
+
+
+extern status_t Lis3mdlGetSystemMode(Lis3mdlDevice_st * dev_pst, Lis3mdlSystemMode_t * mode_pen)
+{
+	uint8_t md_u8;
+	status_t status = STATUS_DEFAULT;
+
+	status = Lis3mdlShadowEnsure(dev_pst);
+	md_u8 = dev_pst->shadow_st.ctrlReg_au8[LIS3MDL_CTRL_REG3 - LIS3MDL_CTRL_REG1] & LIS3MDL_CTRL3_MD_MASK;
 
 	if(status == STATUS_OK)
 	{
-		config_st->dataRate_en 		= (regVal_u8 & LIS3MDL_SPEED_MASK) >> 2;
-		config_st->operatingMode_en = (regVal_u8 & 0x03);
-		config_st->fastOdr_u8 		= (regVal_u8 & LIS3MDL_FAST_ODR_MASK);
+		/* MD = 1x is power-down; 01 only lasts one conversion */
+		*mode_pen = (md_u8 == LIS3MDL_CTRL3_MD_CONTINUOUS) ? LIS3MDL_SYSTEM_CONTINUOUS : LIS3MDL_SYSTEM_POWER_DOWN;
 	}
 
 	return status;
 }
 
 
-extern status_t Lis3mdlToggleInterrupt(Lis3mdlInterruptState_t state_en)
+extern status_t Lis3mdlToggleInterrupt(Lis3mdlDevice_st * dev_pst, Lis3mdlInterruptState_t state_en)
 {
 	uint8_t regVal_u8;
 	status_t status = STATUS_DEFAULT;
 
-	status = i2c_read(LIS3MDL_I2C_BUS_ADDRESS, LIS3MDL_INT_CFG, 1u, &regVal_u8);
+	status = Lis3mdlShadowEnsure(dev_pst);
+	regVal_u8 = dev_pst->shadow_st.intCfg_u8;
 
 	if(status == STATUS_OK)
 	{
 		if(state_en == LIS3MDL_INTR_EN)
 		{
-			if((regVal_u8 & 0x01) == 0u)
+			if((regVal_u8 & LIS3MDL_INT_CFG_IEN) == 0u)
 			{
-				regVal_u8 |= 0x01;
-				(void)i2c_write(LIS3MDL_I2C_BUS_ADDRESS, LIS3MDL_INT_CFG, 1u, &regVal_u8);
+				status = Lis3mdlWriteReg(dev_pst, LIS3MDL_INT_CFG, (uint8_t)(regVal_u8 | LIS3MDL_INT_CFG_IEN));
 			}
 		}
 		else if(state_en == LIS3MDL_INTR_DIS)
 		{
-			if((regVal_u8 & 0x01) != 0u)
+			if((regVal_u8 & LIS3MDL_INT_CFG_IEN) != 0u)
 			{
-				regVal_u8 &= ~0x01;
-				(void)i2c_write(LIS3MDL_I2C_BUS_ADDRESS, LIS3MDL_INT_CFG, 1u, &regVal_u8);
+				status = Lis3mdlWriteReg(dev_pst, LIS3MDL_INT_CFG, (uint8_t)(regVal_u8 & ~LIS3MDL_INT_CFG_IEN));
 			}
 		}
 		else
@@ -135,43 +615,366 @@ extern status_t Lis3mdlToggleInterrupt(Lis3mdlInterruptState_t state_en)
 }
 
 
-extern status_t Lis3mdlReadOutputData(Lis3mdlOutputAxisData_t axisSelect_en, int16_t * axisData_pu8)
+extern status_t Lis3mdlSetInterruptThreshold(Lis3mdlDevice_st * dev_pst, uint16_t threshold_u16)
+{
+	uint8_t ths_au8[LIS3MDL_INT_THS_LEN];
+	status_t status = STATUS_DEFAULT;
+
+	if(threshold_u16 > LIS3MDL_INT_THS_MAX)
+	{
+		return STATUS_ERROR;
+	}
+
+	status = Lis3mdlShadowEnsure(dev_pst);
+
+	if(status == STATUS_OK)
+	{
+		ths_au8[0] = (uint8_t)(threshold_u16 & 0xFFu);
+		ths_au8[1] = (uint8_t)(threshold_u16 >> 8);
+
+		if((ths_au8[0] != dev_pst->shadow_st.intThs_au8[0]) || (ths_au8[1] != dev_pst->shadow_st.intThs_au8[1]))
+		{
+			status = i2c_bus_write(dev_pst->bus_u8, dev_pst->address_u8,
+								   (LIS3MDL_INT_THS_L | LIS3MDL_AUTO_INCREMENT), LIS3MDL_INT_THS_LEN, ths_au8);
+
+			if(status == STATUS_OK)
+			{
+				dev_pst->shadow_st.intThs_au8[0] = ths_au8[0];
+				dev_pst->shadow_st.intThs_au8[1] = ths_au8[1];
+			}
+		}
+	}
+
+	return status;
+}
+
+
+extern status_t Lis3mdlSetInterruptSources(Lis3mdlDevice_st * dev_pst, uint8_t axes_u8, uint8_t latch_u8)
 {
-	uint8_t lowReg_u8;
-	uint8_t highReg_u8;
-	uint8_t regAddessLow_u8;
-	uint8_t regAddessHi_u8;
+	const uint8_t axesMask_u8 = (uint8_t)(LIS3MDL_INT_CFG_XIEN | LIS3MDL_INT_CFG_YIEN | LIS3MDL_INT_CFG_ZIEN);
+
+	if((axes_u8 & (uint8_t)~axesMask_u8) != 0u)
+	{
+		return STATUS_ERROR;
+	}
+
+	return Lis3mdlUpdateBits(dev_pst, LIS3MDL_INT_CFG, (uint8_t)(axesMask_u8 | LIS3MDL_INT_CFG_LIR),
+							 (uint8_t)(axes_u8 | (latch_u8 ? LIS3MDL_INT_CFG_LIR : 0u)));
+}
+
+
+extern status_t Lis3mdlReadInterruptSample(Lis3mdlDevice_st * dev_pst, Lis3mdlSample_st * sample_pst,
+										   uint8_t * intSrc_pu8)
+{
+	uint8_t burst_au8[LIS3MDL_INT_BURST_LEN];
+	status_t status = STATUS_DEFAULT;
+
+	if(Lis3mdlFastReadEnabled(dev_pst))
+	{
+		return STATUS_ERROR;
+	}
+
+	status = i2c_bus_read(dev_pst->bus_u8, dev_pst->address_u8,
+						(LIS3MDL_STATUS_REG | LIS3MDL_AUTO_INCREMENT),
+						LIS3MDL_INT_BURST_LEN, burst_au8);
+
+	if(status == STATUS_OK)
+	{
+		if((dev_pst->shadow_st.valid_u8 != 0u) &&
+		   ((dev_pst->shadow_st.ctrlReg_au8[0] & LIS3MDL_CTRL1_TEMP_EN) != 0u))
+		{
+			dev_pst->temperature_st.raw_s16 = (int16_t)((burst_au8[LIS3MDL_STATUS_BURST_LEN + 1u] << 8) |
+														burst_au8[LIS3MDL_STATUS_BURST_LEN]);
+		}
+
+		sample_pst->status_u8 = burst_au8[0];
+		Lis3mdlUnpackXYZ(&burst_au8[1], &sample_pst->xyz_st);
+		sample_pst->temperature_s16 = dev_pst->temperature_st.raw_s16;
+		*intSrc_pu8 = burst_au8[LIS3MDL_INT_BURST_LEN - 1u];
+	}
+
+	return status;
+}
+
+
+extern status_t Lis3mdlReadOutputData(Lis3mdlDevice_st * dev_pst, Lis3mdlOutputAxisData_t axisSelect_en,
+									  int16_t * axisData_ps16)
+{
+	uint8_t burst_au8[2];
+	uint8_t regAddressLow_u8;
 	status_t status = STATUS_DEFAULT;
 
+	/* FAST_READ limits auto-increment reads to the high bytes */
+	if(Lis3mdlFastReadEnabled(dev_pst))
+	{
+		return STATUS_ERROR;
+	}
+
 	switch(axisSelect_en)
 	{
 	case LIS3MDL_OUT_AXIS_X:
-		regAddessLow_u8 = LIS3MDL_OUT_X_L;
-		regAddessHi_u8 = LIS3MDL_OUT_X_H;
+		regAddressLow_u8 = LIS3MDL_OUT_X_L;
 		break;
 
 	case LIS3MDL_OUT_AXIS_Y:
-		regAddessLow_u8 = LIS3MDL_OUT_Y_L;
-		regAddessHi_u8 = LIS3MDL_OUT_Y_H;
+		regAddressLow_u8 = LIS3MDL_OUT_Y_L;
 		break;
 
 	case LIS3MDL_OUT_AXIS_Z:
-		regAddessLow_u8 = LIS3MDL_OUT_Z_L;
-		regAddessHi_u8 = LIS3MDL_OUT_Z_H;
+		regAddressLow_u8 = LIS3MDL_OUT_Z_L;
 		break;
 
 	default:
-		break;
+		return STATUS_ERROR;
+	}
+
+	/* Low and high byte in one transfer, so both come from the same conversion */
+	status = i2c_bus_read(dev_pst->bus_u8, dev_pst->address_u8,
+						(regAddressLow_u8 | LIS3MDL_AUTO_INCREMENT), 2u, burst_au8);
+
+	if(status == STATUS_OK)
+	{
+		*axisData_ps16 = (int16_t)((burst_au8[1] << 8) | burst_au8[0]);
+	}
+
+	return status;
+}
+
+
+extern status_t Lis3mdlReadXYZ(Lis3mdlDevice_st * dev_pst, Lis3mdlSampleXYZ_st * sample_pst)
+{
+	uint8_t burst_au8[LIS3MDL_XYZ_BURST_LEN];
+	status_t status = STATUS_DEFAULT;
 
+	if(Lis3mdlFastReadEnabled(dev_pst))
+	{
+		return STATUS_ERROR;
 	}
 
-	status |= i2c_read(LIS3MDL_I2C_BUS_ADDRESS, regAddessLow_u8, 1u, &lowReg_u8);
-	status |= i2c_read(LIS3MDL_I2C_BUS_ADDRESS, regAddessHi_u8, 1u, &highReg_u8);
+	status = Lis3mdlReadCoherent(dev_pst, LIS3MDL_OUT_X_L, LIS3MDL_XYZ_BURST_LEN, burst_au8);
 
 	if(status == STATUS_OK)
 	{
-		*axisData_pu8 = (int16_t)((highReg_u8 << 8) | (lowReg_u8));
+		Lis3mdlUnpackXYZ(burst_au8, sample_pst);
 	}
 
 	return status;
 }
+
+
+extern status_t Lis3mdlSetFastRead(Lis3mdlDevice_st * dev_pst, uint8_t enable_u8)
+{
+	return Lis3mdlUpdateBits(dev_pst, LIS3MDL_CTRL_REG5, LIS3MDL_CTRL5_FAST_READ,
+							 (enable_u8 != 0u) ? LIS3MDL_CTRL5_FAST_READ : 0u);
+}
+
+
+extern status_t Lis3mdlSetBlockDataUpdate(Lis3mdlDevice_st * dev_pst, uint8_t enable_u8)
+{
+	return Lis3mdlUpdateBits(dev_pst, LIS3MDL_CTRL_REG5, LIS3MDL_CTRL5_BDU,
+							 (enable_u8 != 0u) ? LIS3MDL_CTRL5_BDU : 0u);
+}
+
+
+extern status_t Lis3mdlReadXYZ8(Lis3mdlDevice_st * dev_pst, Lis3mdlSample8_st * sample_pst)
+{
+	uint8_t burst_au8[LIS3MDL_XYZ8_BURST_LEN];
+	status_t status = STATUS_DEFAULT;
+
+	if(!Lis3mdlFastReadEnabled(dev_pst))
+	{
+		return STATUS_ERROR;
+	}
+
+	/* Auto-increment steps X_H -> Y_H -> Z_H while FAST_READ is set */
+	status = i2c_bus_read(dev_pst->bus_u8, dev_pst->address_u8,
+						(LIS3MDL_OUT_X_H | LIS3MDL_AUTO_INCREMENT),
+						LIS3MDL_XYZ8_BURST_LEN, burst_au8);
+
+	if(status == STATUS_OK)
+	{
+		sample_pst->x_s8 = (int8_t)burst_au8[0];
+		sample_pst->y_s8 = (int8_t)burst_au8[1];
+		sample_pst->z_s8 = (int8_t)burst_au8[2];
+	}
+
+	return status;
+}
+
+
+extern status_t Lis3mdlGetSensitivity(Lis3mdlScale_t scale_en, uint16_t * lsbPerGauss_pu16)
+{
+	if((uint32_t)scale_en >= LIS3MDL_ARRAY_LEN(Lis3mdlSensitivity_au16))
+	{
+		return STATUS_ERROR;
+	}
+
+	*lsbPerGauss_pu16 = Lis3mdlSensitivity_au16[scale_en];
+
+	return STATUS_OK;
+}
+
+
+extern status_t Lis3mdlConvertToGauss(Lis3mdlScale_t scale_en, const Lis3mdlSampleXYZ_st * sample_pst,
+									  Lis3mdlFieldGauss_st * field_pst)
+{
+	float gaussPerLsb_f32;
+
+	if((uint32_t)scale_en >= (uint32_t)LIS3MDL_SCALE_UNKNOWN)
+	{
+		return STATUS_ERROR;
+	}
+
+	gaussPerLsb_f32 = 1.0f / (float)Lis3mdlSensitivity_au16[scale_en];
+	field_pst->x_f32 = (float)sample_pst->x_s16 * gaussPerLsb_f32;
+	field_pst->y_f32 = (float)sample_pst->y_s16 * gaussPerLsb_f32;
+	field_pst->z_f32 = (float)sample_pst->z_s16 * gaussPerLsb_f32;
+
+	return STATUS_OK;
+}
+
+
+extern status_t Lis3mdlConvert8ToGauss(Lis3mdlScale_t scale_en, const Lis3mdlSample8_st * sample_pst,
+									   Lis3mdlFieldGauss_st * field_pst)
+{
+	float gaussPerLsb_f32;
+
+	if((uint32_t)scale_en >= (uint32_t)LIS3MDL_SCALE_UNKNOWN)
+	{
+		return STATUS_ERROR;
+	}
+
+	/* The high byte alone carries bits 15:8 of the 16-bit output */
+	gaussPerLsb_f32 = 256.0f / (float)Lis3mdlSensitivity_au16[scale_en];
+	field_pst->x_f32 = (float)sample_pst->x_s8 * gaussPerLsb_f32;
+	field_pst->y_f32 = (float)sample_pst->y_s8 * gaussPerLsb_f32;
+	field_pst->z_f32 = (float)sample_pst->z_s8 * gaussPerLsb_f32;
+
+	return STATUS_OK;
+}
+
+
+extern status_t Lis3mdlReadXYZIfReady(Lis3mdlDevice_st * dev_pst, Lis3mdlSampleXYZ_st * sample_pst,
+									  uint8_t * newData_pu8)
+{
+	uint8_t burst_au8[LIS3MDL_TEMP_BURST_LEN];
+	uint8_t burstLen_u8 = Lis3mdlStatusBurstLen(dev_pst);
+	status_t status = STATUS_DEFAULT;
+
+	*newData_pu8 = 0u;
+
+	if(Lis3mdlFastReadEnabled(dev_pst))
+	{
+		return STATUS_ERROR;
+	}
+
+	status = Lis3mdlReadCoherent(dev_pst, LIS3MDL_STATUS_REG, burstLen_u8, burst_au8);
+
+	if(status == STATUS_OK)
+	{
+		*newData_pu8 = Lis3mdlDecodeStatusBurst(dev_pst, burst_au8, burstLen_u8, sample_pst);
+	}
+
+	return status;
+}
+
+
+extern status_t Lis3mdlReadXYZIfReadyAsync(Lis3mdlDevice_st * dev_pst, Lis3mdlSampleXYZ_st * sample_pst,
+										   Lis3mdlSampleCallback_t callback_pfn, void * context_pv)
+{
+	Lis3mdlAsyncRead_st *request_pst = &dev_pst->asyncRead_st;
+	status_t status = STATUS_DEFAULT;
+
+	if(Lis3mdlFastReadEnabled(dev_pst) ||
+	   (__atomic_exchange_n(&request_pst->busy_u8, 1u, __ATOMIC_ACQUIRE) != 0u))
+	{
+		return STATUS_ERROR;
+	}
+
+	request_pst->sample_pst = sample_pst;
+	request_pst->callback_pfn = callback_pfn;
+	request_pst->context_pv = context_pv;
+	request_pst->burstLen_u8 = Lis3mdlStatusBurstLen(dev_pst);
+
+	status = i2c_read_async(dev_pst->bus_u8, dev_pst->address_u8,
+							(LIS3MDL_STATUS_REG | LIS3MDL_AUTO_INCREMENT),
+							request_pst->burstLen_u8, request_pst->burst_au8,
+							Lis3mdlAsyncReadComplete, dev_pst);
+
+	if(status != STATUS_OK)
+	{
+		__atomic_store_n(&request_pst->busy_u8, 0u, __ATOMIC_RELEASE);
+	}
+
+	return status;
+}
+
+
+extern status_t Lis3mdlSetTemperatureSensor(Lis3mdlDevice_st * dev_pst, uint8_t enable_u8)
+{
+	status_t status = Lis3mdlUpdateBits(dev_pst, LIS3MDL_CTRL_REG1, LIS3MDL_CTRL1_TEMP_EN,
+										(enable_u8 != 0u) ? LIS3MDL_CTRL1_TEMP_EN : 0u);
+
+	if(status == STATUS_OK)
+	{
+		/* First temperature comes with the next sample */
+		dev_pst->temperature_st.raw_s16 = LIS3MDL_TEMP_INVALID;
+		dev_pst->temperature_st.countdown_u16 = 0u;
+	}
+
+	return status;
+}
+
+
+extern status_t Lis3mdlSetTemperatureDecimation(Lis3mdlDevice_st * dev_pst, uint16_t decimation_u16)
+{
+	Lis3mdlTemperature_st *temperature_pst = &dev_pst->temperature_st;
+
+	if(decimation_u16 == 0u)
+	{
+		return STATUS_ERROR;
+	}
+
+	temperature_pst->decimation_u16 = decimation_u16;
+
+	if(temperature_pst->countdown_u16 >= decimation_u16)
+	{
+		temperature_pst->countdown_u16 = (uint16_t)(decimation_u16 - 1u);
+	}
+
+	return STATUS_OK;
+}
+
+
+extern status_t Lis3mdlGetTemperature(Lis3mdlDevice_st * dev_pst, int16_t * raw_ps16)
+{
+	if(dev_pst->temperature_st.raw_s16 == LIS3MDL_TEMP_INVALID)
+	{
+		return STATUS_ERROR;
+	}
+
+	*raw_ps16 = dev_pst->temperature_st.raw_s16;
+
+	return STATUS_OK;
+}
+
+
+extern status_t Lis3mdlConvertTemperature(int16_t raw_s16, float * celsius_pf32)
+{
+	if(raw_s16 == LIS3MDL_TEMP_INVALID)
+	{
+		return STATUS_ERROR;
+	}
+
+	*celsius_pf32 = ((float)raw_s16 / LIS3MDL_TEMP_LSB_PER_DEGC) + LIS3MDL_TEMP_ZERO_DEGC;
+
+	return STATUS_OK;
+}
+
+
+extern status_t Lis3mdlGetOverrunCount(Lis3mdlDevice_st * dev_pst, uint32_t * overruns_pu32)
+{
+	*overruns_pu32 = dev_pst->stats_st.overruns_u32;
+
+	return STATUS_OK;
+}
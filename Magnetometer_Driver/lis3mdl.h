@@ -20,6 +20,20 @@
  ******************************************************************************/
 #include "stdint.h"
 
+/******************************************************************************
+ * Macro Declarations
+ ******************************************************************************/
+#define LIS3MDL_I2C_ADDRESS_SA1_LOW     0x1C    /* SDO/SA1 pin tied to GND */
+#define LIS3MDL_I2C_ADDRESS_SA1_HIGH    0x1E    /* SDO/SA1 pin tied to VDD */
+
+#define LIS3MDL_CTRL_REG_COUNT          5u      /* CTRL_REG1 .. CTRL_REG5 */
+#define LIS3MDL_INT_THS_LEN             2u      /* INT_THS_L .. INT_THS_H */
+#define LIS3MDL_STATUS_BURST_LEN        7u      /* STATUS_REG .. OUT_Z_H */
+#define LIS3MDL_TEMP_BURST_LEN          9u      /* STATUS_REG .. TEMP_OUT_H */
+#define LIS3MDL_INT_BURST_LEN           11u     /* STATUS_REG .. INT_SRC */
+#define LIS3MDL_INT_THS_MAX             0x7FFFu /* INT_THS is an unsigned 15-bit magnitude */
+#define LIS3MDL_TEMP_INVALID            INT16_MIN   /* No temperature decoded yet */
+
 /******************************************************************************
  * Types Declarations
  ******************************************************************************/
@@ -39,6 +53,7 @@ typedef enum
     LIS3MDL_ODR_2_5_HZ,        /* Output data rate: 2.5 Hz */
     LIS3MDL_ODR_5_HZ,          /* Output data rate: 5 Hz */
     LIS3MDL_ODR_10_HZ,         /* Output data rate: 10 Hz */
+    LIS3MDL_ODR_20_HZ,         /* Output data rate: 20 Hz */
     LIS3MDL_ODR_40_HZ,         /* Output data rate: 40 Hz */
     LIS3MDL_ODR_80_HZ          /* Output data rate: 80 Hz */
 } Lis3mdlDataRate_t;
@@ -51,12 +66,19 @@ typedef enum
 
 typedef enum
 {
-    LIS3MDL_MODE_LP,           /* Low-power mode */
-    LIS3MDL_MODE_MP,           /* Medium-performance mode */
-    LIS3MDL_MODE_HP,           /* High-performance mode */
-    LIS3MDL_MODE_UHP           /* Ultra-high-performance mode */
+    LIS3MDL_MODE_LP,           /* Low-power mode, 1000 Hz with FAST_ODR */
+    LIS3MDL_MODE_MP,           /* Medium-performance mode, 560 Hz with FAST_ODR */
+    LIS3MDL_MODE_HP,           /* High-performance mode, 300 Hz with FAST_ODR */
+    LIS3MDL_MODE_UHP           /* Ultra-high-performance mode, 155 Hz with FAST_ODR */
 } Lis3mdlOperatingMode_t;
 
+typedef enum
+{
+    LIS3MDL_SYSTEM_CONTINUOUS, /* MD = 00: continuous conversion */
+    LIS3MDL_SYSTEM_SINGLE,     /* MD = 01: one conversion, then power-down */
+    LIS3MDL_SYSTEM_POWER_DOWN  /* MD = 11: power-down */
+} Lis3mdlSystemMode_t;
+
 typedef enum
 {
     LIS3MDL_OUT_AXIS_X,        /* Output data for X-axis */
@@ -64,62 +86,532 @@ typedef enum
     LIS3MDL_OUT_AXIS_Z         /* Output data for Z-axis */
 } Lis3mdlOutputAxisData_t;
 
+/*
+ * With fastOdr_u8 clear the rate is dataRate_en; with it set the rate is fixed by the
+ * operating mode (1000/560/300/155 Hz for LP/MP/HP/UHP) and dataRate_en is ignored.
+ */
 typedef struct
 {
     Lis3mdlDataRate_t dataRate_en;              /* Output data rate configuration */
-    Lis3mdlOperatingMode_t operatingMode_en;    /* Operating mode configuration */
+    Lis3mdlOperatingMode_t operatingMode_en;    /* Operating mode configuration, all three axes */
     uint8_t fastOdr_u8;                         /* Fast output data rate configuration */
 } Lis3mdlSpeedConfig_st;
 
+typedef struct
+{
+    int16_t x_s16;                              /* Raw X-axis output */
+    int16_t y_s16;                              /* Raw Y-axis output */
+    int16_t z_s16;                              /* Raw Z-axis output */
+} Lis3mdlSampleXYZ_st;
+
+/*
+ * High bytes only, as returned with FAST_READ enabled: 8-bit resolution, i.e. one LSB is
+ * 256 LSB of the 16-bit output (about 37 mgauss at ±4 gauss).
+ */
+typedef struct
+{
+    int8_t x_s8;                                /* OUT_X_H */
+    int8_t y_s8;                                /* OUT_Y_H */
+    int8_t z_s8;                                /* OUT_Z_H */
+} Lis3mdlSample8_st;
+
+typedef struct
+{
+    float x_f32;                                /* X-axis field in gauss */
+    float y_f32;                                /* Y-axis field in gauss */
+    float z_f32;                                /* Z-axis field in gauss */
+} Lis3mdlFieldGauss_st;
+
+typedef struct
+{
+    uint64_t timestamp_u64;                     /* Acquisition time in nanoseconds */
+    Lis3mdlSampleXYZ_st xyz_st;                 /* Raw X, Y and Z output */
+    int16_t temperature_s16;                    /* Latest TEMP_OUT, or LIS3MDL_TEMP_INVALID */
+    uint8_t status_u8;                          /* STATUS_REG at acquisition (overrun flags) */
+} Lis3mdlSample_st;
+
+typedef struct
+{
+    uint8_t ctrlReg_au8[LIS3MDL_CTRL_REG_COUNT];    /* CTRL_REG1 .. CTRL_REG5 */
+    uint8_t intCfg_u8;                              /* INT_CFG */
+    uint8_t intThs_au8[LIS3MDL_INT_THS_LEN];        /* INT_THS_L .. INT_THS_H */
+    uint8_t valid_u8;                               /* Shadow holds device contents */
+} Lis3mdlShadow_st;
+
+/*
+ * Completion callback of Lis3mdlReadXYZIfReadyAsync. newData_u8 is 1 when the sample
+ * passed at submission was updated with a new conversion.
+ */
+typedef void (*Lis3mdlSampleCallback_t)(status_t status, uint8_t newData_u8, void *context_pv);
+
+typedef struct
+{
+    uint8_t burst_au8[LIS3MDL_TEMP_BURST_LEN];      /* Transfer buffer, owned by the bus while busy */
+    uint8_t burstLen_u8;                            /* Bytes requested, with or without TEMP_OUT */
+    Lis3mdlSampleXYZ_st *sample_pst;                /* Caller's destination sample */
+    Lis3mdlSampleCallback_t callback_pfn;           /* Caller's completion callback */
+    void *context_pv;                               /* Caller's callback context */
+    uint8_t busy_u8;                                /* A read is in flight; __atomic acquire/release only */
+} Lis3mdlAsyncRead_st;
+
+typedef struct
+{
+    uint32_t overruns_u32;                      /* ZYXOR flags seen by status-gated reads */
+} Lis3mdlStats_st;
+
+/*
+ * Temperature carried by the status-gated reads while TEMP_EN is set: one in every
+ * decimation_u16 samples is read with the burst extended to TEMP_OUT_H. The extended
+ * burst counts as one of those whether or not ZYXDA was set in it.
+ */
+typedef struct
+{
+    int16_t raw_s16;                            /* Latest TEMP_OUT, or LIS3MDL_TEMP_INVALID */
+    uint16_t decimation_u16;                    /* Samples per temperature read, 1 for every sample */
+    uint16_t countdown_u16;                     /* Samples left before the next temperature read */
+} Lis3mdlTemperature_st;
+
+/*
+ * One instance per physical sensor. The caller owns the storage (typically a static),
+ * so several sensors on one or more buses can be driven from the same binary.
+ */
+typedef struct
+{
+    uint8_t bus_u8;                             /* I2C bus the sensor is attached to */
+    uint8_t address_u8;                         /* 7-bit I2C address of the sensor */
+    Lis3mdlShadow_st shadow_st;                 /* Shadow of the configuration registers */
+    Lis3mdlStats_st stats_st;                   /* Driver statistics */
+    Lis3mdlTemperature_st temperature_st;       /* Temperature decoding state */
+    Lis3mdlAsyncRead_st asyncRead_st;           /* State of the in-flight asynchronous read */
+} Lis3mdlDevice_st;
+
 /******************************************************************************
  * Extern Functions Declarations
  ******************************************************************************/
+/**
+ * @brief Initialise a LIS3MDL device instance.
+ *
+ *        Binds the instance to its bus and address, clears its statistics and fills
+ *        the register shadow (CTRL_REG1..5, INT_CFG, INT_THS) from the device.
+ *        Once filled, configuration getters are served from the shadow without any bus
+ *        traffic and setters cost a single write. Block data update is then enabled
+ *        (see Lis3mdlSetBlockDataUpdate) so that no axis is read with bytes of two conversions.
+ *
+ * @param[out] dev_pst     Device instance to initialise.
+ * @param[in]  bus_u8      I2C bus the sensor is attached to.
+ * @param[in]  address_u8  7-bit I2C address of the sensor (LIS3MDL_I2C_ADDRESS_SA1_LOW/HIGH).
+ *
+ * @return Status of the operation. Returns STATUS_OK on success, otherwise an error code.
+ */
+extern status_t Lis3mdlInit(Lis3mdlDevice_st *dev_pst, uint8_t bus_u8, uint8_t address_u8);
+
+/**
+ * @brief Re-read the register shadow from the device.
+ *
+ *        The configuration registers are read in a single repeated-start transfer.
+ *        Call this when the device may have been reset or reconfigured behind the
+ *        driver's back (e.g. after a brown-out or a REBOOT/SOFT_RST).
+ *
+ * @param[in,out] dev_pst Device instance.
+ *
+ * @return Status of the operation. Returns STATUS_OK on success, otherwise an error code.
+ */
+extern status_t Lis3mdlResync(Lis3mdlDevice_st *dev_pst);
+
+/**
+ * @brief Write the complete configuration and read it back in one bus operation.
+ *
+ *        CTRL_REG1..5, INT_CFG and INT_THS are written and then read back as a single
+ *        repeated-start transfer (six segments, one submission) instead of a sequence of
+ *        individual register accesses. The shadow is refreshed from the read-back values.
+ *
+ * @param[in,out] dev_pst Device instance.
+ * @param[in]  config_pst Register values to write; valid_u8 is ignored.
+ *
+ * @return Status of the operation. Returns STATUS_OK on success, otherwise an error code.
+ */
+extern status_t Lis3mdlWriteConfig(Lis3mdlDevice_st *dev_pst, const Lis3mdlShadow_st *config_pst);
+
 /**
  * @brief Get the full-scale configuration of the LIS3MDL sensor.
  *
+ * @param[in,out] dev_pst Device instance.
  * @param[out] configScale_pen Pointer to a variable to store the full-scale configuration.
  *                             The value will be one of the values from Lis3mdlScale_t enum.
  *
  * @return Status of the operation. Returns STATUS_OK on success, otherwise an error code.
  */
-extern status_t Lis3mdlGetFullScaleConfig(Lis3mdlScale_t *configScale_pen);
+extern status_t Lis3mdlGetFullScaleConfig(Lis3mdlDevice_st *dev_pst, Lis3mdlScale_t *configScale_pen);
 
 /**
  * @brief Get the output data rate configuration of the LIS3MDL sensor.
  *
+ * @param[in,out] dev_pst Device instance.
  * @param[out] config_st Pointer to a structure to store the output data rate configuration.
  *
  * @return Status of the operation. Returns STATUS_OK on success, otherwise an error code.
  */
-extern status_t Lis3mdlGetOutputDataRate(Lis3mdlSpeedConfig_st *config_st);
+extern status_t Lis3mdlGetOutputDataRate(Lis3mdlDevice_st *dev_pst, Lis3mdlSpeedConfig_st *config_st);
 
 /**
  * @brief Set the output data rate configuration of the LIS3MDL sensor.
  *
+ *        Programs OM, DO and FAST_ODR in CTRL_REG1 and the matching Z-axis OMZ in
+ *        CTRL_REG4, keeping the other bits of both registers. Only registers whose value
+ *        changes are written, as one transfer with CTRL_REG4 first so the Z axis is
+ *        already in the new mode when the new rate starts.
+ *
+ * @param[in,out] dev_pst Device instance.
  * @param[in] config_st Configuration structure containing the desired data rate, operating mode, and fast ODR.
  *
+ * @return STATUS_OK on success, STATUS_ERROR for an out-of-range rate or mode or a bus error.
+ */
+extern status_t Lis3mdlSetOutputDataRate(Lis3mdlDevice_st *dev_pst, Lis3mdlSpeedConfig_st config_st);
+
+/**
+ * @brief Get the output data rate a speed configuration results in.
+ *
+ * @param[in]  config_pst Speed configuration.
+ * @param[out] rate_pu32  Output data rate in mHz (625 for 0.625 Hz .. 1000000 for 1 kHz).
+ *
+ * @return STATUS_OK on success, STATUS_ERROR for an out-of-range rate or mode.
+ */
+extern status_t Lis3mdlGetOutputDataRateMilliHz(const Lis3mdlSpeedConfig_st *config_pst, uint32_t *rate_pu32);
+
+/**
+ * @brief Find the slowest speed configuration reaching a rate in a given operating mode.
+ *
+ *        Up to 80 Hz the slowest sufficient DO rate is chosen; above that FAST_ODR is
+ *        used, which runs at the operating mode's fixed rate.
+ *
+ * @param[in]  minRateMilliHz_u32 Minimum output data rate in mHz.
+ * @param[in]  mode_en            Operating mode for all three axes.
+ * @param[out] config_pst         Speed configuration, for Lis3mdlSetOutputDataRate.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR when the mode cannot reach the rate.
+ */
+extern status_t Lis3mdlFindSpeedConfig(uint32_t minRateMilliHz_u32, Lis3mdlOperatingMode_t mode_en,
+                                       Lis3mdlSpeedConfig_st *config_pst);
+
+/**
+ * @brief Select the system operating mode (CTRL_REG3 MD).
+ *
+ *        LIS3MDL_SYSTEM_SINGLE starts one conversion; it is written on every call, even
+ *        when the shadow already matches, since each write triggers a new conversion.
+ *        The device drops back to power-down by itself once the conversion is done, so
+ *        the shadow records power-down. The other modes are only written when MD changes.
+ *
+ * @param[in,out] dev_pst Device instance.
+ * @param[in] mode_en System mode to select.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR for an out-of-range mode or a bus error.
+ */
+extern status_t Lis3mdlSetSystemMode(Lis3mdlDevice_st *dev_pst, Lis3mdlSystemMode_t mode_en);
+
+/**
+ * @brief Get the resting system operating mode from the shadow.
+ *
+ * @param[in,out] dev_pst Device instance.
+ * @param[out] mode_pen LIS3MDL_SYSTEM_CONTINUOUS or LIS3MDL_SYSTEM_POWER_DOWN.
+ *
  * @return Status of the operation. Returns STATUS_OK on success, otherwise an error code.
  */
-extern status_t Lis3mdlSetOutputDataRate(Lis3mdlSpeedConfig_st config_st);
+extern status_t Lis3mdlGetSystemMode(Lis3mdlDevice_st *dev_pst, Lis3mdlSystemMode_t *mode_pen);
 
 /**
  * @brief Enable or Disable interrupt of the LIS3MDL sensor.
  *
+ * @param[in,out] dev_pst Device instance.
  * @param[in] state_en State of the interrupt to be set.
  *
  * @return Status of the operation. Returns STATUS_OK on success, otherwise an error code.
  */
-extern status_t Lis3mdlToggleInterrupt(Lis3mdlInterruptState_t state_en);
+extern status_t Lis3mdlToggleInterrupt(Lis3mdlDevice_st *dev_pst, Lis3mdlInterruptState_t state_en);
+
+/**
+ * @brief Set the threshold of the INT pin comparator (INT_THS_L/H).
+ *
+ *        An enabled axis raises the interrupt when its output exceeds +threshold or
+ *        falls below -threshold, evaluated by the sensor at every conversion. Both bytes
+ *        are written in one transfer, and only when the value changes.
+ *
+ * @param[in,out] dev_pst Device instance.
+ * @param[in] threshold_u16 Threshold in LSB of the 16-bit output, at most LIS3MDL_INT_THS_MAX.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR for an out-of-range threshold or a bus error.
+ */
+extern status_t Lis3mdlSetInterruptThreshold(Lis3mdlDevice_st *dev_pst, uint16_t threshold_u16);
+
+/**
+ * @brief Select the axes watched by the threshold interrupt and its latching (INT_CFG).
+ *
+ *        With the request latched (LIR) the INT pin and INT_SRC hold every source seen
+ *        until INT_SRC is read; otherwise they follow the latest conversion. The
+ *        register is only written when the bits change.
+ *
+ * @param[in,out] dev_pst Device instance.
+ * @param[in] axes_u8  Any combination of LIS3MDL_INT_CFG_XIEN, _YIEN and _ZIEN.
+ * @param[in] latch_u8 1 to latch the interrupt request, 0 otherwise.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR for other bits in axes_u8 or a bus error.
+ */
+extern status_t Lis3mdlSetInterruptSources(Lis3mdlDevice_st *dev_pst, uint8_t axes_u8, uint8_t latch_u8);
+
+/**
+ * @brief Read INT_SRC and the sample that raised it in one transaction.
+ *
+ *        STATUS_REG through INT_SRC are fetched as a single 11-byte auto-increment
+ *        transfer: the output registers hold the conversion the comparator last judged,
+ *        and reading INT_SRC at the end of the burst releases a latched request. The
+ *        sample is stored whether or not ZYXDA is set and overruns are not counted,
+ *        since nothing reads the outputs between interrupts. While the temperature
+ *        sensor is enabled the TEMP_OUT bytes of the burst are decoded as well.
+ *
+ * @param[in,out] dev_pst Device instance.
+ * @param[out] sample_pst  X, Y and Z output, STATUS_REG and temperature; the timestamp is left to the caller.
+ * @param[out] intSrc_pu8  INT_SRC (LIS3MDL_INT_SRC_* bits).
+ *
+ * @return STATUS_OK on success, STATUS_ERROR if FAST_READ is enabled or the bus failed.
+ */
+extern status_t Lis3mdlReadInterruptSample(Lis3mdlDevice_st *dev_pst, Lis3mdlSample_st *sample_pst,
+                                           uint8_t *intSrc_pu8);
 
 /**
  * @brief Read the output data of a specified axis from the LIS3MDL sensor.
  *
+ *        Low and high bytes are fetched in one 2-byte auto-increment transfer, so they
+ *        always belong to the same conversion. Reading several axes this way can still
+ *        mix conversions across axes; use Lis3mdlReadXYZ for all three in one burst.
+ *
+ * @param[in,out] dev_pst Device instance.
  * @param[in]  axisSelect_en Enum identifying the axis from which to read the output data.
- * @param[out] axisData_pu8  Pointer to a variable to store the output data of the specified axis.
+ * @param[out] axisData_ps16 Pointer to a variable to store the output data of the specified axis.
  *                           The variable will contain a 16-bit signed integer value representing the output data.
  *
+ * @return STATUS_OK on success, STATUS_ERROR for an unknown axis, if FAST_READ is enabled
+ *         (auto-increment reads are then limited to the high bytes) or the bus failed.
+ */
+extern status_t Lis3mdlReadOutputData(Lis3mdlDevice_st *dev_pst, Lis3mdlOutputAxisData_t axisSelect_en,
+                                      int16_t *axisData_ps16);
+
+/**
+ * @brief Read the output data of all three axes from the LIS3MDL sensor.
+ *
+ *        OUT_X_L through OUT_Z_H are fetched as a single 6-byte auto-increment
+ *        transfer, i.e. one bus transaction per sample instead of six. With BDU enabled
+ *        (the default) the sample is always coherent: STATUS_REG is read after the burst
+ *        in the same transaction, and a burst a conversion landed in is repeated (see
+ *        Lis3mdlSetBlockDataUpdate).
+ *
+ * @param[in,out] dev_pst Device instance.
+ * @param[out] sample_pst Pointer to a structure to store the X, Y and Z output data.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR if FAST_READ is enabled, the bus failed or,
+ *         with BDU, every attempt was split by a conversion.
+ */
+extern status_t Lis3mdlReadXYZ(Lis3mdlDevice_st *dev_pst, Lis3mdlSampleXYZ_st *sample_pst);
+
+/**
+ * @brief Enable or disable FAST_READ (CTRL_REG5) for high-byte-only acquisition.
+ *
+ *        With FAST_READ enabled the auto-increment skips the output low bytes, so
+ *        Lis3mdlReadXYZ8 gets all three axes in a 3-byte burst. The 16-bit multi-byte
+ *        reads (Lis3mdlReadOutputData, Lis3mdlReadXYZ, Lis3mdlReadXYZIfReady and its
+ *        asynchronous variant) are refused while it is enabled. The register is only
+ *        written when the bit changes.
+ *
+ * @param[in,out] dev_pst Device instance.
+ * @param[in] enable_u8 1 to enable FAST_READ, 0 to disable it.
+ *
+ * @return Status of the operation. Returns STATUS_OK on success, otherwise an error code.
+ */
+extern status_t Lis3mdlSetFastRead(Lis3mdlDevice_st *dev_pst, uint8_t enable_u8);
+
+/**
+ * @brief Enable or disable Block Data Update (CTRL_REG5 BDU).
+ *
+ *        With BDU enabled the output registers are not refreshed between the read of an
+ *        axis' low byte and its high byte, so no axis mixes the bytes of two conversions,
+ *        even when one lands mid-transfer at 1 kHz FAST_ODR. The hold is per axis: a
+ *        conversion landing inside a multi-axis burst is published after the MSB read
+ *        of the current axis, so the axes read after it come from the new conversion.
+ *        While BDU is enabled, Lis3mdlReadXYZ and Lis3mdlReadXYZIfReady therefore append a
+ *        STATUS_REG read to their burst (one transaction, 4 more bytes on the wire) and
+ *        repeat the burst, up to 4 times, when it shows a conversion between the axes.
+ *        The cost is latency: such a conversion waits for the MSB read, and one that
+ *        completes while a read is stalled is lost (ZYXOR). Disable it only
+ *        when the reads are known not to overlap a conversion and raw throughput matters.
+ *        Lis3mdlInit enables it. The register is only written when the bit changes.
+ *
+ * @param[in,out] dev_pst Device instance.
+ * @param[in] enable_u8 1 to enable BDU, 0 to disable it.
+ *
+ * @return Status of the operation. Returns STATUS_OK on success, otherwise an error code.
+ */
+extern status_t Lis3mdlSetBlockDataUpdate(Lis3mdlDevice_st *dev_pst, uint8_t enable_u8);
+
+/**
+ * @brief Read the high bytes of all three axes in a single 3-byte transfer.
+ *
+ *        Requires FAST_READ (Lis3mdlSetFastRead): OUT_X_H, OUT_Y_H and OUT_Z_H are
+ *        fetched as one auto-increment burst, half the payload of Lis3mdlReadXYZ.
+ *
+ * @param[in,out] dev_pst Device instance.
+ * @param[out] sample_pst Pointer to a structure to store the 8-bit X, Y and Z output data.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR if FAST_READ is not enabled or the bus failed.
+ */
+extern status_t Lis3mdlReadXYZ8(Lis3mdlDevice_st *dev_pst, Lis3mdlSample8_st *sample_pst);
+
+/**
+ * @brief Get the sensitivity of the 16-bit output for a full-scale setting.
+ *
+ * @param[in]  scale_en          Full-scale setting.
+ * @param[out] lsbPerGauss_pu16  Sensitivity in LSB/gauss (6842, 3421, 2281 or 1711).
+ *
+ * @return STATUS_OK on success, STATUS_ERROR for LIS3MDL_SCALE_UNKNOWN.
+ */
+extern status_t Lis3mdlGetSensitivity(Lis3mdlScale_t scale_en, uint16_t *lsbPerGauss_pu16);
+
+/**
+ * @brief Convert a raw 16-bit sample to gauss.
+ *
+ *        Single-sample form of Lis3mdlConvertToFloat (lis3mdl_convert.h), with
+ *        identical results.
+ *
+ * @param[in]  scale_en    Full-scale setting the sample was taken with.
+ * @param[in]  sample_pst  Raw sample.
+ * @param[out] field_pst   Field in gauss.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR for LIS3MDL_SCALE_UNKNOWN.
+ */
+extern status_t Lis3mdlConvertToGauss(Lis3mdlScale_t scale_en, const Lis3mdlSampleXYZ_st *sample_pst,
+                                      Lis3mdlFieldGauss_st *field_pst);
+
+/**
+ * @brief Convert a FAST_READ 8-bit sample to gauss.
+ *
+ *        Each high byte is weighted by 256 LSB of the full-resolution sensitivity; the
+ *        result is truncated towards minus infinity by up to one 8-bit step.
+ *
+ * @param[in]  scale_en    Full-scale setting the sample was taken with.
+ * @param[in]  sample_pst  8-bit sample.
+ * @param[out] field_pst   Field in gauss.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR for LIS3MDL_SCALE_UNKNOWN.
+ */
+extern status_t Lis3mdlConvert8ToGauss(Lis3mdlScale_t scale_en, const Lis3mdlSample8_st *sample_pst,
+                                       Lis3mdlFieldGauss_st *field_pst);
+
+/**
+ * @brief Read STATUS_REG and the output data of all three axes in one transaction.
+ *
+ *        STATUS_REG through OUT_Z_H are fetched as a single 7-byte auto-increment
+ *        transfer. The sample is only written when ZYXDA reports new data, so the
+ *        sensor can be polled faster than the ODR without re-reading stale data.
+ *        Every ZYXOR flag seen is added to the overrun counter. While the temperature
+ *        sensor is enabled, the burst is extended to TEMP_OUT_H (9 bytes) once every
+ *        decimation samples and the temperature is decoded from it (Lis3mdlGetTemperature).
+ *        With BDU enabled the sample is coherent across axes as for Lis3mdlReadXYZ.
+ *
+ * @param[in,out] dev_pst Device instance.
+ * @param[out] sample_pst   Pointer to a structure to store the X, Y and Z output data.
+ *                          Left untouched when no new data is available.
+ * @param[out] newData_pu8  Set to 1 when a new sample was stored, 0 otherwise.
+ *
+ * @return Status of the operation. Returns STATUS_OK on success, otherwise an error code.
+ */
+extern status_t Lis3mdlReadXYZIfReady(Lis3mdlDevice_st *dev_pst, Lis3mdlSampleXYZ_st *sample_pst,
+                                      uint8_t *newData_pu8);
+
+/**
+ * @brief Asynchronous variant of Lis3mdlReadXYZIfReady.
+ *
+ *        Submits the STATUS_REG..OUT_Z_H burst (extended to TEMP_OUT_H as in
+ *        Lis3mdlReadXYZIfReady) on the non-blocking I2C API and
+ *        returns immediately; the calling task is free while the bus is busy. When the
+ *        transfer completes the status byte is decoded as in Lis3mdlReadXYZIfReady and
+ *        callback_pfn is invoked from the I2C completion context. Only one asynchronous
+ *        read may be in flight per device; the callback may submit the next one.
+ *        The non-blocking API carries one segment, so unlike the blocking read the burst
+ *        is not checked for a conversion between axes: submit it on data-ready.
+ *
+ *        The completion context also updates the device's stats_st (overruns) and
+ *        temperature_st, so from submission until the callback returns the request owns
+ *        the device: no other Lis3mdl* call may use it and those fields must not be read.
+ *        They are safe to read in the callback, and from the submitting thread once a later
+ *        submission has succeeded or it has otherwise synchronised with the callback.
+ *
+ * @param[in,out] dev_pst    Device instance.
+ * @param[out] sample_pst    Destination sample, must remain valid until the callback runs.
+ * @param[in]  callback_pfn  Completion callback.
+ * @param[in]  context_pv    Opaque pointer handed back to the callback.
+ *
+ * @return STATUS_OK if the read was submitted, STATUS_ERROR if one is already in flight or
+ *         the bus queue is full (the callback will not be invoked).
+ */
+extern status_t Lis3mdlReadXYZIfReadyAsync(Lis3mdlDevice_st *dev_pst, Lis3mdlSampleXYZ_st *sample_pst,
+                                           Lis3mdlSampleCallback_t callback_pfn, void *context_pv);
+
+/**
+ * @brief Enable or disable the temperature sensor (CTRL_REG1 TEMP_EN).
+ *
+ *        While enabled, the status-gated reads fetch TEMP_OUT in the same transaction as
+ *        the field, every Lis3mdlSetTemperatureDecimation samples; the first such read
+ *        happens with the next sample. Disabling it forgets the last temperature. The
+ *        register is only written when the bit changes.
+ *
+ * @param[in,out] dev_pst Device instance.
+ * @param[in] enable_u8 1 to enable the temperature sensor, 0 to disable it.
+ *
+ * @return Status of the operation. Returns STATUS_OK on success, otherwise an error code.
+ */
+extern status_t Lis3mdlSetTemperatureSensor(Lis3mdlDevice_st *dev_pst, uint8_t enable_u8);
+
+/**
+ * @brief Set how often the status-gated reads include the temperature.
+ *
+ *        Temperature drifts far slower than the field changes: with a decimation of N only
+ *        one sample in N pays for the two extra bytes and their decoding. Lis3mdlInit sets 1.
+ *        The extended burst counts as one of the N whether or not ZYXDA was set in it;
+ *        the next one follows the N-1 bursts after it that returned a sample, so a burst
+ *        that finds no new data never stretches the period to N+1.
+ *
+ * @param[in,out] dev_pst Device instance.
+ * @param[in] decimation_u16 Samples per temperature read, at least 1.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR for a decimation of 0.
+ */
+extern status_t Lis3mdlSetTemperatureDecimation(Lis3mdlDevice_st *dev_pst, uint16_t decimation_u16);
+
+/**
+ * @brief Get the latest temperature decoded by the status-gated reads.
+ *
+ * @param[in,out] dev_pst Device instance.
+ * @param[out] raw_ps16 TEMP_OUT: 8 LSB per degree Celsius, 0 at 25 degrees Celsius.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR when no temperature was read since it was enabled.
+ */
+extern status_t Lis3mdlGetTemperature(Lis3mdlDevice_st *dev_pst, int16_t *raw_ps16);
+
+/**
+ * @brief Convert a raw TEMP_OUT value to degrees Celsius.
+ *
+ * @param[in]  raw_s16      TEMP_OUT value.
+ * @param[out] celsius_pf32 Temperature in degrees Celsius.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR for LIS3MDL_TEMP_INVALID.
+ */
+extern status_t Lis3mdlConvertTemperature(int16_t raw_s16, float *celsius_pf32);
+
+/**
+ * @brief Get the number of data overruns (ZYXOR) seen by Lis3mdlReadXYZIfReady.
+ *
+ * @param[in,out] dev_pst Device instance.
+ * @param[out] overruns_pu32 Pointer to a variable to store the overrun count.
+ *
  * @return Status of the operation. Returns STATUS_OK on success, otherwise an error code.
  */
-extern status_t Lis3mdlReadOutputData(Lis3mdlOutputAxisData_t axisSelect_en, int16_t *axisData_pu8);
+extern status_t Lis3mdlGetOverrunCount(Lis3mdlDevice_st *dev_pst, uint32_t *overruns_pu32);
 
 #endif /* LIS3MDL_H_ */
@@ -0,0 +1,273 @@
+/**
+ * @file       lis3mdl_acq.c
+ *
+ * @brief      Implementation file for the LIS3MDL interrupt-driven acquisition engine.
+ *
+ * @author     Aniket SAHA
+ * @date       Oct 16, 2026
+ */
+
+/******************************************************************************
+ * Include Header Files
+ ******************************************************************************/
+#define _POSIX_C_SOURCE 200809L		/* clock_gettime, pthread_condattr_setclock */
+
+#include "i2c.h"
+#include "lis3mdl.h"
+#include "lis3mdl_register.h"
+#include "lis3mdl_acq.h"
+#include "stdint.h"
+#include <time.h>
+
+/******************************************************************************
+ * Macro Declarations
+ ******************************************************************************/
+#define LIS3MDL_ACQ_NS_PER_SEC		1000000000L
+
+/******************************************************************************
+ * Static Function Definitions
+ ******************************************************************************/
+static void * Lis3mdlAcqThread(void *arg_pv)
+{
+	Lis3mdlAcq_st *acq_pst = (Lis3mdlAcq_st *)arg_pv;
+	uint64_t timestamp_u64;
+
+	pthread_mutex_lock(&acq_pst->lock);
+
+	for(;;)
+	{
+		while((acq_pst->pendingEdges_u32 == 0u) && (acq_pst->running_u8 != 0u))
+		{
+			pthread_cond_wait(&acq_pst->edge, &acq_pst->lock);
+		}
+
+		if(acq_pst->running_u8 == 0u)
+		{
+			break;
+		}
+
+		/* Several pending edges are served by one burst: the device only holds the latest sample. */
+		acq_pst->stats_st.coalesced_u32 += acq_pst->pendingEdges_u32 - 1u;
+		acq_pst->pendingEdges_u32 = 0u;
+		timestamp_u64 = acq_pst->edgeTimestamp_u64;
+
+		pthread_mutex_unlock(&acq_pst->lock);
+		(void)Lis3mdlAcqHandleEdge(acq_pst, timestamp_u64);
+		pthread_mutex_lock(&acq_pst->lock);
+
+		if((acq_pst->batchWanted_u32 != 0u) &&
+		   (Lis3mdlRingCount(acq_pst->ring_pst) >= acq_pst->batchWanted_u32))
+		{
+			acq_pst->batchWanted_u32 = 0u;
+			pthread_cond_signal(&acq_pst->batch);
+		}
+	}
+
+	pthread_mutex_unlock(&acq_pst->lock);
+
+	return (void *)0;
+}
+
+/******************************************************************************
+ * Extern Function Definitions
+ ******************************************************************************/
+extern status_t Lis3mdlAcqInit(Lis3mdlAcq_st * acq_pst, Lis3mdlDevice_st * dev_pst, Lis3mdlRing_st * ring_pst)
+{
+	Lis3mdlAcqStats_st stats_st = { 0 };
+	pthread_condattr_t batchAttr;
+	status_t status = STATUS_OK;
+
+	acq_pst->dev_pst = dev_pst;
+	acq_pst->ring_pst = ring_pst;
+	acq_pst->stats_st = stats_st;
+	acq_pst->pendingEdges_u32 = 0u;
+	acq_pst->edgeTimestamp_u64 = 0u;
+	acq_pst->running_u8 = 0u;
+	acq_pst->started_u8 = 0u;
+	acq_pst->batchWanted_u32 = 0u;
+
+	if(pthread_mutex_init(&acq_pst->lock, (void *)0) != 0)
+	{
+		return STATUS_ERROR;
+	}
+
+	if(pthread_cond_init(&acq_pst->edge, (void *)0) != 0)
+	{
+		(void)pthread_mutex_destroy(&acq_pst->lock);
+		return STATUS_ERROR;
+	}
+
+	if(pthread_condattr_init(&batchAttr) != 0)
+	{
+		(void)pthread_cond_destroy(&acq_pst->edge);
+		(void)pthread_mutex_destroy(&acq_pst->lock);
+		return STATUS_ERROR;
+	}
+
+	/* Reader timeouts must not jump with the wall clock */
+	if((pthread_condattr_setclock(&batchAttr, CLOCK_MONOTONIC) != 0) ||
+	   (pthread_cond_init(&acq_pst->batch, &batchAttr) != 0))
+	{
+		(void)pthread_cond_destroy(&acq_pst->edge);
+		(void)pthread_mutex_destroy(&acq_pst->lock);
+		status = STATUS_ERROR;
+	}
+
+	(void)pthread_condattr_destroy(&batchAttr);
+
+	return status;
+}
+
+
+extern status_t Lis3mdlAcqHandleEdge(Lis3mdlAcq_st * acq_pst, uint64_t timestamp_u64)
+{
+	Lis3mdlSample_st sample_st = { 0 };
+	uint8_t newData_u8 = 0u;
+	uint32_t overruns_u32 = acq_pst->dev_pst->stats_st.overruns_u32;
+	uint32_t *counter_pu32;
+	status_t status = STATUS_DEFAULT;
+
+	status = Lis3mdlReadXYZIfReady(acq_pst->dev_pst, &sample_st.xyz_st, &newData_u8);
+
+	if(status != STATUS_OK)
+	{
+		counter_pu32 = &acq_pst->stats_st.errors_u32;
+	}
+	else if(newData_u8 == 0u)
+	{
+		counter_pu32 = &acq_pst->stats_st.spurious_u32;
+	}
+	else
+	{
+		sample_st.timestamp_u64 = timestamp_u64;
+		sample_st.temperature_s16 = acq_pst->dev_pst->temperature_st.raw_s16;
+		sample_st.status_u8 = LIS3MDL_STATUS_ZYXDA;
+
+		if(acq_pst->dev_pst->stats_st.overruns_u32 != overruns_u32)
+		{
+			sample_st.status_u8 |= LIS3MDL_STATUS_ZYXOR;
+		}
+
+		status = Lis3mdlRingPush(acq_pst->ring_pst, &sample_st);
+		counter_pu32 = (status == STATUS_OK) ? &acq_pst->stats_st.samples_u32 : &acq_pst->stats_st.errors_u32;
+	}
+
+	/* No lock here: the edge context may not block. Lis3mdlAcqGetStats loads these atomically. */
+	(void)__atomic_fetch_add(counter_pu32, 1u, __ATOMIC_RELAXED);
+
+	return status;
+}
+
+
+extern status_t Lis3mdlAcqStart(Lis3mdlAcq_st * acq_pst)
+{
+	if(acq_pst->started_u8 != 0u)
+	{
+		return STATUS_ERROR;
+	}
+
+	pthread_mutex_lock(&acq_pst->lock);
+	acq_pst->running_u8 = 1u;
+	pthread_mutex_unlock(&acq_pst->lock);
+
+	if(pthread_create(&acq_pst->thread, (void *)0, Lis3mdlAcqThread, acq_pst) != 0)
+	{
+		pthread_mutex_lock(&acq_pst->lock);
+		acq_pst->running_u8 = 0u;
+		pthread_mutex_unlock(&acq_pst->lock);
+		return STATUS_ERROR;
+	}
+
+	acq_pst->started_u8 = 1u;
+
+	return STATUS_OK;
+}
+
+
+extern status_t Lis3mdlAcqStop(Lis3mdlAcq_st * acq_pst)
+{
+	/* Without a thread there is nothing to join */
+	if(acq_pst->started_u8 == 0u)
+	{
+		return STATUS_ERROR;
+	}
+
+	pthread_mutex_lock(&acq_pst->lock);
+	acq_pst->running_u8 = 0u;
+	pthread_cond_signal(&acq_pst->edge);
+	pthread_cond_signal(&acq_pst->batch);
+	pthread_mutex_unlock(&acq_pst->lock);
+
+	acq_pst->started_u8 = 0u;
+
+	return (pthread_join(acq_pst->thread, (void **)0) == 0) ? STATUS_OK : STATUS_ERROR;
+}
+
+
+extern void Lis3mdlAcqGetStats(Lis3mdlAcq_st * acq_pst, Lis3mdlAcqStats_st * stats_pst)
+{
+	pthread_mutex_lock(&acq_pst->lock);
+	stats_pst->edges_u32 = acq_pst->stats_st.edges_u32;
+	stats_pst->coalesced_u32 = acq_pst->stats_st.coalesced_u32;
+	stats_pst->readerWakeups_u32 = acq_pst->stats_st.readerWakeups_u32;
+	pthread_mutex_unlock(&acq_pst->lock);
+
+	/* Bumped by Lis3mdlAcqHandleEdge without the lock */
+	stats_pst->samples_u32 = __atomic_load_n(&acq_pst->stats_st.samples_u32, __ATOMIC_RELAXED);
+	stats_pst->spurious_u32 = __atomic_load_n(&acq_pst->stats_st.spurious_u32, __ATOMIC_RELAXED);
+	stats_pst->errors_u32 = __atomic_load_n(&acq_pst->stats_st.errors_u32, __ATOMIC_RELAXED);
+}
+
+
+extern status_t Lis3mdlAcqReadSamples(Lis3mdlAcq_st * acq_pst, Lis3mdlSample_st * samples_pst, uint32_t count_u32,
+									 uint32_t timeoutUs_u32, uint32_t * read_pu32)
+{
+	struct timespec deadline_st;
+	uint32_t read_u32;
+	int waitResult = 0;
+
+	read_u32 = Lis3mdlRingPopBatch(acq_pst->ring_pst, samples_pst, count_u32);
+
+	if((read_u32 < count_u32) && (timeoutUs_u32 != 0u))
+	{
+		clock_gettime(CLOCK_MONOTONIC, &deadline_st);
+		deadline_st.tv_sec += (time_t)(timeoutUs_u32 / 1000000u);
+		deadline_st.tv_nsec += (long)(timeoutUs_u32 % 1000000u) * 1000L;
+		if(deadline_st.tv_nsec >= LIS3MDL_ACQ_NS_PER_SEC)
+		{
+			deadline_st.tv_sec++;
+			deadline_st.tv_nsec -= LIS3MDL_ACQ_NS_PER_SEC;
+		}
+
+		pthread_mutex_lock(&acq_pst->lock);
+
+		/* The ring is re-checked under the lock so a batch completed meanwhile is not missed */
+		acq_pst->batchWanted_u32 = count_u32 - read_u32;
+		while((Lis3mdlRingCount(acq_pst->ring_pst) < (count_u32 - read_u32)) &&
+			  (acq_pst->running_u8 != 0u) && (waitResult == 0))
+		{
+			waitResult = pthread_cond_timedwait(&acq_pst->batch, &acq_pst->lock, &deadline_st);
+			acq_pst->stats_st.readerWakeups_u32++;
+		}
+		acq_pst->batchWanted_u32 = 0u;
+
+		pthread_mutex_unlock(&acq_pst->lock);
+
+		read_u32 += Lis3mdlRingPopBatch(acq_pst->ring_pst, &samples_pst[read_u32], count_u32 - read_u32);
+	}
+
+	*read_pu32 = read_u32;
+
+	return (read_u32 == count_u32) ? STATUS_OK : STATUS_ERROR;
+}
+
+
+extern void Lis3mdlAcqRaiseEdge(Lis3mdlAcq_st * acq_pst, uint64_t timestamp_u64)
+{
+	pthread_mutex_lock(&acq_pst->lock);
+	acq_pst->stats_st.edges_u32++;
+	acq_pst->pendingEdges_u32++;
+	acq_pst->edgeTimestamp_u64 = timestamp_u64;
+	pthread_cond_signal(&acq_pst->edge);
+	pthread_mutex_unlock(&acq_pst->lock);
+}
@@ -0,0 +1,152 @@
+/**
+ * @file       lis3mdl_acq.h
+ *
+ * @brief      Header file for the LIS3MDL interrupt-driven acquisition engine.
+ *
+ *             Instead of the application polling the sensor, every DRDY/INT edge triggers
+ *             exactly one fused STATUS_REG..OUT_Z_H burst whose result is pushed into a
+ *             sample ring. Sample latency is bounded by one transfer and no bus traffic is
+ *             generated while the sensor has nothing new.
+ *
+ *             Lis3mdlAcqHandleEdge is the portable core. On the host, Lis3mdlAcqStart runs
+ *             it on a thread woken through a condition variable by Lis3mdlAcqRaiseEdge, which
+ *             stands in for the GPIO edge interrupt. The simulated device reaches it through
+ *             a pin callback adapter (see bench/lis3mdl_acq_bench.c).
+ *
+ * @author     Aniket SAHA
+ * @date       Oct 16, 2026
+ */
+
+#ifndef LIS3MDL_ACQ_H_
+#define LIS3MDL_ACQ_H_
+
+/******************************************************************************
+ * Include Header Files
+ ******************************************************************************/
+#include <pthread.h>
+#include "stdint.h"
+#include "lis3mdl_ring.h"
+
+/******************************************************************************
+ * Types Declarations
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t edges_u32;                         /* Edges raised */
+    uint32_t coalesced_u32;                     /* Edges merged because a read was still pending */
+    uint32_t samples_u32;                       /* Samples pushed into the ring */
+    uint32_t spurious_u32;                      /* Edges whose burst reported no new data */
+    uint32_t errors_u32;                        /* Failed bursts or ring overflows */
+    uint32_t readerWakeups_u32;                 /* Wakeups of a Lis3mdlAcqReadSamples caller */
+} Lis3mdlAcqStats_st;
+
+typedef struct
+{
+    Lis3mdlDevice_st *dev_pst;                  /* Sensor serviced by this engine */
+    Lis3mdlRing_st *ring_pst;                   /* Destination of acquired samples */
+    uint8_t started_u8;                         /* Thread created by Lis3mdlAcqStart and not yet joined */
+
+    /* Host edge delivery */
+    pthread_t thread;                           /* Acquisition thread */
+    pthread_mutex_t lock;                       /* Protects the fields below */
+    Lis3mdlAcqStats_st stats_st;                /* Engine statistics, read with Lis3mdlAcqGetStats; samples,
+                                                   spurious and errors are __atomic relaxed instead */
+    pthread_cond_t edge;                        /* Signalled by Lis3mdlAcqRaiseEdge */
+    pthread_cond_t batch;                       /* Signalled when the waiting reader's batch is complete */
+    uint32_t pendingEdges_u32;                  /* Edges not yet serviced */
+    uint32_t batchWanted_u32;                   /* Ring fill the reader waits for, 0 when none waits */
+    uint64_t edgeTimestamp_u64;                 /* Timestamp of the latest pending edge */
+    uint8_t running_u8;                         /* Thread should keep servicing edges */
+} Lis3mdlAcq_st;
+
+/******************************************************************************
+ * Extern Functions Declarations
+ ******************************************************************************/
+/**
+ * @brief Initialise an acquisition engine for one sensor.
+ *
+ * @param[out] acq_pst  Engine to initialise.
+ * @param[in]  dev_pst  Initialised sensor instance; its INT/DRDY line must be routed to the engine.
+ * @param[in]  ring_pst Initialised ring receiving the samples; the engine is its single producer.
+ *
+ * @return Status of the operation. Returns STATUS_OK on success, otherwise an error code.
+ */
+extern status_t Lis3mdlAcqInit(Lis3mdlAcq_st *acq_pst, Lis3mdlDevice_st *dev_pst, Lis3mdlRing_st *ring_pst);
+
+/**
+ * @brief Service one data-ready edge: one fused burst read, one ring push.
+ *
+ *        Call from the edge handler context (or a deferred handler on target). Takes no
+ *        lock: its counters are bumped with relaxed atomics.
+ *
+ * @param[in,out] acq_pst     Engine instance.
+ * @param[in]  timestamp_u64  Time of the edge in nanoseconds, stored in the sample.
+ *
+ * @return Status of the operation. Returns STATUS_OK on success, otherwise an error code.
+ */
+extern status_t Lis3mdlAcqHandleEdge(Lis3mdlAcq_st *acq_pst, uint64_t timestamp_u64);
+
+/**
+ * @brief Start the host acquisition thread.
+ *
+ * @param[in,out] acq_pst Engine instance.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR when already started or the thread could not be created.
+ */
+extern status_t Lis3mdlAcqStart(Lis3mdlAcq_st *acq_pst);
+
+/**
+ * @brief Stop the host acquisition thread and wait for it to exit.
+ *
+ * @param[in,out] acq_pst Engine instance.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR when the engine was not started or the join failed.
+ */
+extern status_t Lis3mdlAcqStop(Lis3mdlAcq_st *acq_pst);
+
+/**
+ * @brief Take a consistent copy of the engine statistics.
+ *
+ *        The counters are updated by the acquisition thread, Lis3mdlAcqRaiseEdge and the
+ *        reader under the engine lock, and by Lis3mdlAcqHandleEdge atomically; read them
+ *        through this call only. Each counter is exact; counters of different groups may
+ *        be one edge apart.
+ *
+ * @param[in,out] acq_pst   Engine instance.
+ * @param[out] stats_pst    Copy of the statistics.
+ */
+extern void Lis3mdlAcqGetStats(Lis3mdlAcq_st *acq_pst, Lis3mdlAcqStats_st *stats_pst);
+
+/**
+ * @brief Read a block of count distinct samples into the caller's buffer.
+ *
+ *        Samples already in the ring are popped straight into samples_pst. If fewer than
+ *        count are available, the caller sleeps until the ring holds the rest of the
+ *        block or the timeout expires; the acquisition thread wakes it once per block,
+ *        not once per sample. Each sample carries its edge timestamp and ZYXDA/ZYXOR
+ *        status. Only one thread may read from an engine (it is the ring's consumer).
+ *
+ * @param[in,out] acq_pst      Engine instance, started with Lis3mdlAcqStart.
+ * @param[out] samples_pst     Caller's buffer of at least count samples.
+ * @param[in]  count_u32       Number of samples to read.
+ * @param[in]  timeoutUs_u32   Longest time to wait for the block, in microseconds; 0 does not wait.
+ * @param[out] read_pu32       Number of samples stored, count_u32 on success.
+ *
+ * @return STATUS_OK when count samples were stored, STATUS_ERROR on timeout or when the
+ *         engine stopped first (read_pu32 then holds the partial count).
+ */
+extern status_t Lis3mdlAcqReadSamples(Lis3mdlAcq_st *acq_pst, Lis3mdlSample_st *samples_pst, uint32_t count_u32,
+                                      uint32_t timeoutUs_u32, uint32_t *read_pu32);
+
+/**
+ * @brief Deliver a data-ready edge to the host acquisition thread.
+ *
+ *        Host stand-in for the GPIO edge interrupt. Never blocks on the bus; edges
+ *        raised while a read is pending are coalesced into it.
+ *
+ * @param[in,out] acq_pst     Engine instance.
+ * @param[in]  timestamp_u64  Time of the edge in nanoseconds.
+ */
+extern void Lis3mdlAcqRaiseEdge(Lis3mdlAcq_st *acq_pst, uint64_t timestamp_u64);
+
+#endif /* LIS3MDL_ACQ_H_ */
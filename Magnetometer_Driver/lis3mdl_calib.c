@@ -0,0 +1,711 @@
+/**
+ * @file       lis3mdl_calib.c
+ *
+ * @brief      Implementation file for the LIS3MDL hard-iron/soft-iron calibration engine.
+ *
+ * @author     Aniket SAHA
+ * @date       Oct 16, 2026
+ */
+
+/******************************************************************************
+ * Include Header Files
+ ******************************************************************************/
+#include "i2c.h"
+#include "lis3mdl_calib.h"
+#include "stdint.h"
+#include <math.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/******************************************************************************
+ * Macro Declarations
+ ******************************************************************************/
+#define LIS3MDL_CALIB_JACOBI_SWEEPS		16u
+#define LIS3MDL_CALIB_PIVOT_MIN			1e-12	/* Relative to the largest diagonal term */
+
+#if defined(__SSE2__)
+/* _mm_shuffle_ps lane selection, written in lane order */
+#define LIS3MDL_SHUF(i0, i1, i2, i3)	_MM_SHUFFLE(i3, i2, i1, i0)
+#define LIS3MDL_CALIB_SUM(k, v)			(sum_av[k] = _mm_add_pd(sum_av[k], (v)))
+#define LIS3MDL_CALIB_MUL(a, b)			_mm_mul_pd((a), (b))
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define LIS3MDL_CALIB_SUM(k, v)			(sum_av[k] = vaddq_f64(sum_av[k], (v)))
+#define LIS3MDL_CALIB_MUL(a, b)			vmulq_f64((a), (b))
+#endif
+
+/******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+/* Exponents of x, y, z of each accumulated sum, in Lis3mdlCalibFit_st.moment_af64 order */
+static const uint8_t Lis3mdlCalibMoment_au8[LIS3MDL_CALIB_MOMENTS][3] =
+{
+	{ 1u, 0u, 0u }, { 0u, 1u, 0u }, { 0u, 0u, 1u },
+	{ 2u, 0u, 0u }, { 0u, 2u, 0u }, { 0u, 0u, 2u }, { 1u, 1u, 0u }, { 1u, 0u, 1u }, { 0u, 1u, 1u },
+	{ 3u, 0u, 0u }, { 0u, 3u, 0u }, { 0u, 0u, 3u }, { 2u, 1u, 0u }, { 2u, 0u, 1u }, { 1u, 2u, 0u },
+	{ 0u, 2u, 1u }, { 1u, 0u, 2u }, { 0u, 1u, 2u }, { 1u, 1u, 1u },
+	{ 4u, 0u, 0u }, { 0u, 4u, 0u }, { 0u, 0u, 4u }, { 3u, 1u, 0u }, { 3u, 0u, 1u }, { 1u, 3u, 0u },
+	{ 0u, 3u, 1u }, { 1u, 0u, 3u }, { 0u, 1u, 3u }, { 2u, 2u, 0u }, { 2u, 0u, 2u }, { 0u, 2u, 2u },
+	{ 2u, 1u, 1u }, { 1u, 2u, 1u }, { 1u, 1u, 2u }
+};
+
+/* Quadric terms x^2, y^2, z^2, 2xy, 2xz, 2yz, 2x, 2y, 2z: exponents and factor */
+static const uint8_t Lis3mdlCalibTerm_au8[LIS3MDL_CALIB_PARAMS][3] =
+{
+	{ 2u, 0u, 0u }, { 0u, 2u, 0u }, { 0u, 0u, 2u }, { 1u, 1u, 0u }, { 1u, 0u, 1u }, { 0u, 1u, 1u },
+	{ 1u, 0u, 0u }, { 0u, 1u, 0u }, { 0u, 0u, 1u }
+};
+
+static const double Lis3mdlCalibTermScale_af64[LIS3MDL_CALIB_PARAMS] =
+{
+	1.0, 1.0, 1.0, 2.0, 2.0, 2.0, 2.0, 2.0, 2.0
+};
+
+/******************************************************************************
+ * Static Function Definitions
+ ******************************************************************************/
+/* Every monomial of degree 1 to 4 of one sample, in Lis3mdlCalibMoment_au8 order. */
+static inline void Lis3mdlCalibMonomials(const float *field_pf32, double term_af64[LIS3MDL_CALIB_MOMENTS])
+{
+	double x_f64 = field_pf32[0];
+	double y_f64 = field_pf32[1];
+	double z_f64 = field_pf32[2];
+	double xx_f64 = x_f64 * x_f64;
+	double yy_f64 = y_f64 * y_f64;
+	double zz_f64 = z_f64 * z_f64;
+	double xy_f64 = x_f64 * y_f64;
+	double xz_f64 = x_f64 * z_f64;
+	double yz_f64 = y_f64 * z_f64;
+
+	term_af64[0] = x_f64;
+	term_af64[1] = y_f64;
+	term_af64[2] = z_f64;
+	term_af64[3] = xx_f64;
+	term_af64[4] = yy_f64;
+	term_af64[5] = zz_f64;
+	term_af64[6] = xy_f64;
+	term_af64[7] = xz_f64;
+	term_af64[8] = yz_f64;
+	term_af64[9] = xx_f64 * x_f64;
+	term_af64[10] = yy_f64 * y_f64;
+	term_af64[11] = zz_f64 * z_f64;
+	term_af64[12] = xx_f64 * y_f64;
+	term_af64[13] = xx_f64 * z_f64;
+	term_af64[14] = xy_f64 * y_f64;
+	term_af64[15] = yy_f64 * z_f64;
+	term_af64[16] = x_f64 * zz_f64;
+	term_af64[17] = y_f64 * zz_f64;
+	term_af64[18] = xy_f64 * z_f64;
+	term_af64[19] = xx_f64 * xx_f64;
+	term_af64[20] = yy_f64 * yy_f64;
+	term_af64[21] = zz_f64 * zz_f64;
+	term_af64[22] = xx_f64 * xy_f64;
+	term_af64[23] = xx_f64 * xz_f64;
+	term_af64[24] = xy_f64 * yy_f64;
+	term_af64[25] = yy_f64 * yz_f64;
+	term_af64[26] = xz_f64 * zz_f64;
+	term_af64[27] = yz_f64 * zz_f64;
+	term_af64[28] = xx_f64 * yy_f64;
+	term_af64[29] = xx_f64 * zz_f64;
+	term_af64[30] = yy_f64 * zz_f64;
+	term_af64[31] = xx_f64 * yz_f64;
+	term_af64[32] = xy_f64 * yz_f64;
+	term_af64[33] = xy_f64 * zz_f64;
+}
+
+
+/* Accumulated sum of x^ex * y^ey * z^ez (degree 1 to 4). */
+static double Lis3mdlCalibMoment(const Lis3mdlCalibFit_st *fit_pst, uint8_t ex_u8, uint8_t ey_u8, uint8_t ez_u8)
+{
+	uint32_t k_u32;
+
+	for(k_u32 = 0u; k_u32 < LIS3MDL_CALIB_MOMENTS; k_u32++)
+	{
+		if((Lis3mdlCalibMoment_au8[k_u32][0] == ex_u8) && (Lis3mdlCalibMoment_au8[k_u32][1] == ey_u8) &&
+		   (Lis3mdlCalibMoment_au8[k_u32][2] == ez_u8))
+		{
+			return fit_pst->moment_af64[k_u32];
+		}
+	}
+
+	return 0.0;
+}
+
+
+/* out = W * m + b, with b = -W * o folded in once per batch. */
+static void Lis3mdlCalibApplyScalar(const float *w_pf32, const float *b_pf32, const float *field_pf32,
+									float *out_pf32, uint32_t count_u32)
+{
+	uint32_t index_u32;
+
+	for(index_u32 = 0u; index_u32 < count_u32; index_u32++)
+	{
+		float x_f32 = field_pf32[(3u * index_u32) + 0u];
+		float y_f32 = field_pf32[(3u * index_u32) + 1u];
+		float z_f32 = field_pf32[(3u * index_u32) + 2u];
+
+		out_pf32[(3u * index_u32) + 0u] = (w_pf32[0] * x_f32) + (w_pf32[1] * y_f32) + (w_pf32[2] * z_f32) + b_pf32[0];
+		out_pf32[(3u * index_u32) + 1u] = (w_pf32[3] * x_f32) + (w_pf32[4] * y_f32) + (w_pf32[5] * z_f32) + b_pf32[1];
+		out_pf32[(3u * index_u32) + 2u] = (w_pf32[6] * x_f32) + (w_pf32[7] * y_f32) + (w_pf32[8] * z_f32) + b_pf32[2];
+	}
+}
+
+
+#if defined(__SSE2__)
+
+/* Four samples per step: deinterleave 12 floats to X, Y, Z lanes, transform, reinterleave. */
+static uint32_t Lis3mdlCalibApplyKernel(const float *w_pf32, const float *b_pf32, const float *field_pf32,
+										float *out_pf32, uint32_t count_u32)
+{
+	uint32_t index_u32;
+
+	for(index_u32 = 0u; (index_u32 + 4u) <= count_u32; index_u32 += 4u)
+	{
+		const float *in_pf32 = &field_pf32[3u * index_u32];
+		__m128 a_v = _mm_loadu_ps(&in_pf32[0]);		/* x0 y0 z0 x1 */
+		__m128 b_v = _mm_loadu_ps(&in_pf32[4]);		/* y1 z1 x2 y2 */
+		__m128 c_v = _mm_loadu_ps(&in_pf32[8]);		/* z2 x3 y3 z3 */
+		__m128 x_v;
+		__m128 y_v;
+		__m128 z_v;
+		__m128 ox_v;
+		__m128 oy_v;
+		__m128 oz_v;
+
+		x_v = _mm_shuffle_ps(_mm_shuffle_ps(a_v, b_v, LIS3MDL_SHUF(0, 3, 2, 3)),
+							 _mm_shuffle_ps(b_v, c_v, LIS3MDL_SHUF(2, 2, 1, 1)), LIS3MDL_SHUF(0, 1, 0, 2));
+		y_v = _mm_shuffle_ps(_mm_shuffle_ps(a_v, b_v, LIS3MDL_SHUF(1, 1, 0, 0)),
+							 _mm_shuffle_ps(b_v, c_v, LIS3MDL_SHUF(3, 3, 2, 2)), LIS3MDL_SHUF(0, 2, 0, 2));
+		z_v = _mm_shuffle_ps(_mm_shuffle_ps(a_v, b_v, LIS3MDL_SHUF(2, 2, 1, 1)),
+							 _mm_shuffle_ps(c_v, c_v, LIS3MDL_SHUF(0, 0, 3, 3)), LIS3MDL_SHUF(0, 2, 0, 2));
+
+		ox_v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(w_pf32[0]), x_v), _mm_mul_ps(_mm_set1_ps(w_pf32[1]), y_v)),
+						  _mm_add_ps(_mm_mul_ps(_mm_set1_ps(w_pf32[2]), z_v), _mm_set1_ps(b_pf32[0])));
+		oy_v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(w_pf32[3]), x_v), _mm_mul_ps(_mm_set1_ps(w_pf32[4]), y_v)),
+						  _mm_add_ps(_mm_mul_ps(_mm_set1_ps(w_pf32[5]), z_v), _mm_set1_ps(b_pf32[1])));
+		oz_v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(w_pf32[6]), x_v), _mm_mul_ps(_mm_set1_ps(w_pf32[7]), y_v)),
+						  _mm_add_ps(_mm_mul_ps(_mm_set1_ps(w_pf32[8]), z_v), _mm_set1_ps(b_pf32[2])));
+
+		_mm_storeu_ps(&out_pf32[3u * index_u32],
+					  _mm_shuffle_ps(_mm_shuffle_ps(ox_v, oy_v, LIS3MDL_SHUF(0, 1, 0, 1)),
+									 _mm_shuffle_ps(oz_v, ox_v, LIS3MDL_SHUF(0, 0, 1, 1)), LIS3MDL_SHUF(0, 2, 0, 2)));
+		_mm_storeu_ps(&out_pf32[(3u * index_u32) + 4u],
+					  _mm_shuffle_ps(_mm_shuffle_ps(oy_v, oz_v, LIS3MDL_SHUF(1, 1, 1, 1)),
+									 _mm_shuffle_ps(ox_v, oy_v, LIS3MDL_SHUF(2, 2, 2, 2)), LIS3MDL_SHUF(0, 2, 0, 2)));
+		_mm_storeu_ps(&out_pf32[(3u * index_u32) + 8u],
+					  _mm_shuffle_ps(_mm_shuffle_ps(oz_v, ox_v, LIS3MDL_SHUF(2, 2, 3, 3)),
+									 _mm_shuffle_ps(oy_v, oz_v, LIS3MDL_SHUF(3, 3, 3, 3)), LIS3MDL_SHUF(0, 2, 0, 2)));
+	}
+
+	return index_u32;
+}
+
+#elif defined(__ARM_NEON)
+
+static uint32_t Lis3mdlCalibApplyKernel(const float *w_pf32, const float *b_pf32, const float *field_pf32,
+										float *out_pf32, uint32_t count_u32)
+{
+	uint32_t index_u32;
+
+	for(index_u32 = 0u; (index_u32 + 4u) <= count_u32; index_u32 += 4u)
+	{
+		float32x4x3_t in_v = vld3q_f32(&field_pf32[3u * index_u32]);
+		float32x4x3_t out_v;
+
+		out_v.val[0] = vmulq_n_f32(in_v.val[0], w_pf32[0]);
+		out_v.val[0] = vaddq_f32(out_v.val[0], vmulq_n_f32(in_v.val[1], w_pf32[1]));
+		out_v.val[0] = vaddq_f32(out_v.val[0], vaddq_f32(vmulq_n_f32(in_v.val[2], w_pf32[2]), vdupq_n_f32(b_pf32[0])));
+		out_v.val[1] = vmulq_n_f32(in_v.val[0], w_pf32[3]);
+		out_v.val[1] = vaddq_f32(out_v.val[1], vmulq_n_f32(in_v.val[1], w_pf32[4]));
+		out_v.val[1] = vaddq_f32(out_v.val[1], vaddq_f32(vmulq_n_f32(in_v.val[2], w_pf32[5]), vdupq_n_f32(b_pf32[1])));
+		out_v.val[2] = vmulq_n_f32(in_v.val[0], w_pf32[6]);
+		out_v.val[2] = vaddq_f32(out_v.val[2], vmulq_n_f32(in_v.val[1], w_pf32[7]));
+		out_v.val[2] = vaddq_f32(out_v.val[2], vaddq_f32(vmulq_n_f32(in_v.val[2], w_pf32[8]), vdupq_n_f32(b_pf32[2])));
+
+		vst3q_f32(&out_pf32[3u * index_u32], out_v);
+	}
+
+	return index_u32;
+}
+
+#else
+
+static uint32_t Lis3mdlCalibApplyKernel(const float *w_pf32, const float *b_pf32, const float *field_pf32,
+										float *out_pf32, uint32_t count_u32)
+{
+	(void)w_pf32;
+	(void)b_pf32;
+	(void)field_pf32;
+	(void)out_pf32;
+	(void)count_u32;
+
+	return 0u;
+}
+
+#endif
+
+
+/* Moments of samples [0, count), summed into moment_af64. */
+static void Lis3mdlCalibAccumulateScalar(const float *field_pf32, uint32_t count_u32, double *moment_af64)
+{
+	double sum_af64[LIS3MDL_CALIB_MOMENTS] = { 0.0 };
+	double term_af64[LIS3MDL_CALIB_MOMENTS];
+	uint32_t index_u32;
+	uint32_t k_u32;
+
+	for(index_u32 = 0u; index_u32 < count_u32; index_u32++)
+	{
+		Lis3mdlCalibMonomials(&field_pf32[3u * index_u32], term_af64);
+
+		for(k_u32 = 0u; k_u32 < LIS3MDL_CALIB_MOMENTS; k_u32++)
+		{
+			sum_af64[k_u32] += term_af64[k_u32];
+		}
+	}
+
+	for(k_u32 = 0u; k_u32 < LIS3MDL_CALIB_MOMENTS; k_u32++)
+	{
+		moment_af64[k_u32] += sum_af64[k_u32];
+	}
+}
+
+
+#if defined(__SSE2__) || (defined(__ARM_NEON) && defined(__aarch64__))
+
+#if defined(__SSE2__)
+typedef __m128d Lis3mdlCalibPair_t;
+#else
+typedef float64x2_t Lis3mdlCalibPair_t;
+#endif
+
+/* Two samples per step, one per double lane; returns the number of samples taken. */
+static uint32_t Lis3mdlCalibAccumulateKernel(const float *field_pf32, uint32_t count_u32, double *moment_af64)
+{
+	Lis3mdlCalibPair_t sum_av[LIS3MDL_CALIB_MOMENTS];
+	double lanes_af64[2];
+	uint32_t index_u32;
+	uint32_t k_u32;
+
+	for(k_u32 = 0u; k_u32 < LIS3MDL_CALIB_MOMENTS; k_u32++)
+	{
+#if defined(__SSE2__)
+		sum_av[k_u32] = _mm_setzero_pd();
+#else
+		sum_av[k_u32] = vdupq_n_f64(0.0);
+#endif
+	}
+
+	for(index_u32 = 0u; (index_u32 + 2u) <= count_u32; index_u32 += 2u)
+	{
+		const float *in_pf32 = &field_pf32[3u * index_u32];
+#if defined(__SSE2__)
+		Lis3mdlCalibPair_t x_v = _mm_set_pd(in_pf32[3], in_pf32[0]);
+		Lis3mdlCalibPair_t y_v = _mm_set_pd(in_pf32[4], in_pf32[1]);
+		Lis3mdlCalibPair_t z_v = _mm_set_pd(in_pf32[5], in_pf32[2]);
+#else
+		float32x2x3_t in_v = vld3_f32(in_pf32);
+		Lis3mdlCalibPair_t x_v = vcvt_f64_f32(in_v.val[0]);
+		Lis3mdlCalibPair_t y_v = vcvt_f64_f32(in_v.val[1]);
+		Lis3mdlCalibPair_t z_v = vcvt_f64_f32(in_v.val[2]);
+#endif
+		Lis3mdlCalibPair_t xx_v = LIS3MDL_CALIB_MUL(x_v, x_v);
+		Lis3mdlCalibPair_t yy_v = LIS3MDL_CALIB_MUL(y_v, y_v);
+		Lis3mdlCalibPair_t zz_v = LIS3MDL_CALIB_MUL(z_v, z_v);
+		Lis3mdlCalibPair_t xy_v = LIS3MDL_CALIB_MUL(x_v, y_v);
+		Lis3mdlCalibPair_t xz_v = LIS3MDL_CALIB_MUL(x_v, z_v);
+		Lis3mdlCalibPair_t yz_v = LIS3MDL_CALIB_MUL(y_v, z_v);
+
+		/* Same products, same order as Lis3mdlCalibMonomials */
+		LIS3MDL_CALIB_SUM(0, x_v);
+		LIS3MDL_CALIB_SUM(1, y_v);
+		LIS3MDL_CALIB_SUM(2, z_v);
+		LIS3MDL_CALIB_SUM(3, xx_v);
+		LIS3MDL_CALIB_SUM(4, yy_v);
+		LIS3MDL_CALIB_SUM(5, zz_v);
+		LIS3MDL_CALIB_SUM(6, xy_v);
+		LIS3MDL_CALIB_SUM(7, xz_v);
+		LIS3MDL_CALIB_SUM(8, yz_v);
+		LIS3MDL_CALIB_SUM(9, LIS3MDL_CALIB_MUL(xx_v, x_v));
+		LIS3MDL_CALIB_SUM(10, LIS3MDL_CALIB_MUL(yy_v, y_v));
+		LIS3MDL_CALIB_SUM(11, LIS3MDL_CALIB_MUL(zz_v, z_v));
+		LIS3MDL_CALIB_SUM(12, LIS3MDL_CALIB_MUL(xx_v, y_v));
+		LIS3MDL_CALIB_SUM(13, LIS3MDL_CALIB_MUL(xx_v, z_v));
+		LIS3MDL_CALIB_SUM(14, LIS3MDL_CALIB_MUL(xy_v, y_v));
+		LIS3MDL_CALIB_SUM(15, LIS3MDL_CALIB_MUL(yy_v, z_v));
+		LIS3MDL_CALIB_SUM(16, LIS3MDL_CALIB_MUL(x_v, zz_v));
+		LIS3MDL_CALIB_SUM(17, LIS3MDL_CALIB_MUL(y_v, zz_v));
+		LIS3MDL_CALIB_SUM(18, LIS3MDL_CALIB_MUL(xy_v, z_v));
+		LIS3MDL_CALIB_SUM(19, LIS3MDL_CALIB_MUL(xx_v, xx_v));
+		LIS3MDL_CALIB_SUM(20, LIS3MDL_CALIB_MUL(yy_v, yy_v));
+		LIS3MDL_CALIB_SUM(21, LIS3MDL_CALIB_MUL(zz_v, zz_v));
+		LIS3MDL_CALIB_SUM(22, LIS3MDL_CALIB_MUL(xx_v, xy_v));
+		LIS3MDL_CALIB_SUM(23, LIS3MDL_CALIB_MUL(xx_v, xz_v));
+		LIS3MDL_CALIB_SUM(24, LIS3MDL_CALIB_MUL(xy_v, yy_v));
+		LIS3MDL_CALIB_SUM(25, LIS3MDL_CALIB_MUL(yy_v, yz_v));
+		LIS3MDL_CALIB_SUM(26, LIS3MDL_CALIB_MUL(xz_v, zz_v));
+		LIS3MDL_CALIB_SUM(27, LIS3MDL_CALIB_MUL(yz_v, zz_v));
+		LIS3MDL_CALIB_SUM(28, LIS3MDL_CALIB_MUL(xx_v, yy_v));
+		LIS3MDL_CALIB_SUM(29, LIS3MDL_CALIB_MUL(xx_v, zz_v));
+		LIS3MDL_CALIB_SUM(30, LIS3MDL_CALIB_MUL(yy_v, zz_v));
+		LIS3MDL_CALIB_SUM(31, LIS3MDL_CALIB_MUL(xx_v, yz_v));
+		LIS3MDL_CALIB_SUM(32, LIS3MDL_CALIB_MUL(xy_v, yz_v));
+		LIS3MDL_CALIB_SUM(33, LIS3MDL_CALIB_MUL(xy_v, zz_v));
+	}
+
+	for(k_u32 = 0u; k_u32 < LIS3MDL_CALIB_MOMENTS; k_u32++)
+	{
+#if defined(__SSE2__)
+		_mm_storeu_pd(lanes_af64, sum_av[k_u32]);
+#else
+		vst1q_f64(lanes_af64, sum_av[k_u32]);
+#endif
+		moment_af64[k_u32] += lanes_af64[0] + lanes_af64[1];
+	}
+
+	return index_u32;
+}
+
+#else
+
+static uint32_t Lis3mdlCalibAccumulateKernel(const float *field_pf32, uint32_t count_u32, double *moment_af64)
+{
+	(void)field_pf32;
+	(void)count_u32;
+	(void)moment_af64;
+
+	return 0u;
+}
+
+#endif
+
+
+/* Solve the symmetric positive definite system a * x = b in place (Cholesky). */
+static status_t Lis3mdlCalibCholeskySolve(double a_af64[LIS3MDL_CALIB_PARAMS][LIS3MDL_CALIB_PARAMS],
+										  double b_af64[LIS3MDL_CALIB_PARAMS])
+{
+	double scale_f64 = 0.0;
+	uint32_t i_u32;
+	uint32_t j_u32;
+	uint32_t k_u32;
+
+	for(i_u32 = 0u; i_u32 < LIS3MDL_CALIB_PARAMS; i_u32++)
+	{
+		scale_f64 = fmax(scale_f64, a_af64[i_u32][i_u32]);
+	}
+
+	for(j_u32 = 0u; j_u32 < LIS3MDL_CALIB_PARAMS; j_u32++)
+	{
+		double pivot_f64 = a_af64[j_u32][j_u32];
+
+		for(k_u32 = 0u; k_u32 < j_u32; k_u32++)
+		{
+			pivot_f64 -= a_af64[j_u32][k_u32] * a_af64[j_u32][k_u32];
+		}
+
+		/* Samples confined to a plane or a line leave the quadric undetermined */
+		if(pivot_f64 <= (LIS3MDL_CALIB_PIVOT_MIN * scale_f64))
+		{
+			return STATUS_ERROR;
+		}
+
+		a_af64[j_u32][j_u32] = sqrt(pivot_f64);
+
+		for(i_u32 = j_u32 + 1u; i_u32 < LIS3MDL_CALIB_PARAMS; i_u32++)
+		{
+			double sum_f64 = a_af64[i_u32][j_u32];
+
+			for(k_u32 = 0u; k_u32 < j_u32; k_u32++)
+			{
+				sum_f64 -= a_af64[i_u32][k_u32] * a_af64[j_u32][k_u32];
+			}
+			a_af64[i_u32][j_u32] = sum_f64 / a_af64[j_u32][j_u32];
+		}
+	}
+
+	/* L y = b, then L' x = y */
+	for(i_u32 = 0u; i_u32 < LIS3MDL_CALIB_PARAMS; i_u32++)
+	{
+		for(k_u32 = 0u; k_u32 < i_u32; k_u32++)
+		{
+			b_af64[i_u32] -= a_af64[i_u32][k_u32] * b_af64[k_u32];
+		}
+		b_af64[i_u32] /= a_af64[i_u32][i_u32];
+	}
+
+	for(i_u32 = LIS3MDL_CALIB_PARAMS; i_u32-- > 0u;)
+	{
+		for(k_u32 = i_u32 + 1u; k_u32 < LIS3MDL_CALIB_PARAMS; k_u32++)
+		{
+			b_af64[i_u32] -= a_af64[k_u32][i_u32] * b_af64[k_u32];
+		}
+		b_af64[i_u32] /= a_af64[i_u32][i_u32];
+	}
+
+	return STATUS_OK;
+}
+
+
+/* Cyclic Jacobi: a = v * diag(d) * v' for a symmetric 3x3 matrix. */
+static void Lis3mdlCalibEigen3(double a_af64[3][3], double d_af64[3], double v_af64[3][3])
+{
+	uint32_t sweep_u32;
+	uint32_t i_u32;
+	uint32_t j_u32;
+	uint32_t k_u32;
+
+	for(i_u32 = 0u; i_u32 < 3u; i_u32++)
+	{
+		for(j_u32 = 0u; j_u32 < 3u; j_u32++)
+		{
+			v_af64[i_u32][j_u32] = (i_u32 == j_u32) ? 1.0 : 0.0;
+		}
+	}
+
+	for(sweep_u32 = 0u; sweep_u32 < LIS3MDL_CALIB_JACOBI_SWEEPS; sweep_u32++)
+	{
+		double offDiag_f64 = fabs(a_af64[0][1]) + fabs(a_af64[0][2]) + fabs(a_af64[1][2]);
+
+		if(offDiag_f64 == 0.0)
+		{
+			break;
+		}
+
+		for(i_u32 = 0u; i_u32 < 2u; i_u32++)
+		{
+			for(j_u32 = i_u32 + 1u; j_u32 < 3u; j_u32++)
+			{
+				double theta_f64;
+				double t_f64;
+				double c_f64;
+				double s_f64;
+
+				if(a_af64[i_u32][j_u32] == 0.0)
+				{
+					continue;
+				}
+
+				theta_f64 = (a_af64[j_u32][j_u32] - a_af64[i_u32][i_u32]) / (2.0 * a_af64[i_u32][j_u32]);
+				t_f64 = ((theta_f64 >= 0.0) ? 1.0 : -1.0) / (fabs(theta_f64) + sqrt((theta_f64 * theta_f64) + 1.0));
+				c_f64 = 1.0 / sqrt((t_f64 * t_f64) + 1.0);
+				s_f64 = t_f64 * c_f64;
+
+				/* a = R' a R, v = v R for the rotation in the (i, j) plane */
+				for(k_u32 = 0u; k_u32 < 3u; k_u32++)
+				{
+					double aki_f64 = a_af64[k_u32][i_u32];
+					double akj_f64 = a_af64[k_u32][j_u32];
+
+					a_af64[k_u32][i_u32] = (c_f64 * aki_f64) - (s_f64 * akj_f64);
+					a_af64[k_u32][j_u32] = (s_f64 * aki_f64) + (c_f64 * akj_f64);
+				}
+				for(k_u32 = 0u; k_u32 < 3u; k_u32++)
+				{
+					double aik_f64 = a_af64[i_u32][k_u32];
+					double ajk_f64 = a_af64[j_u32][k_u32];
+
+					a_af64[i_u32][k_u32] = (c_f64 * aik_f64) - (s_f64 * ajk_f64);
+					a_af64[j_u32][k_u32] = (s_f64 * aik_f64) + (c_f64 * ajk_f64);
+				}
+				for(k_u32 = 0u; k_u32 < 3u; k_u32++)
+				{
+					double vki_f64 = v_af64[k_u32][i_u32];
+					double vkj_f64 = v_af64[k_u32][j_u32];
+
+					v_af64[k_u32][i_u32] = (c_f64 * vki_f64) - (s_f64 * vkj_f64);
+					v_af64[k_u32][j_u32] = (s_f64 * vki_f64) + (c_f64 * vkj_f64);
+				}
+			}
+		}
+	}
+
+	for(i_u32 = 0u; i_u32 < 3u; i_u32++)
+	{
+		d_af64[i_u32] = a_af64[i_u32][i_u32];
+	}
+}
+
+/******************************************************************************
+ * Extern Function Definitions
+ ******************************************************************************/
+extern void Lis3mdlCalibInit(Lis3mdlCalib_st * calib_pst)
+{
+	Lis3mdlCalib_st identity_st = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f } };
+
+	*calib_pst = identity_st;
+}
+
+
+extern void Lis3mdlCalibApply(const Lis3mdlCalib_st * calib_pst, const float * field_pf32, float * out_pf32,
+							  uint32_t count_u32)
+{
+	const float *w_pf32 = calib_pst->softIron_af32;
+	const float *o_pf32 = calib_pst->offset_af32;
+	float b_af32[3];
+	uint32_t done_u32;
+
+	b_af32[0] = -((w_pf32[0] * o_pf32[0]) + (w_pf32[1] * o_pf32[1]) + (w_pf32[2] * o_pf32[2]));
+	b_af32[1] = -((w_pf32[3] * o_pf32[0]) + (w_pf32[4] * o_pf32[1]) + (w_pf32[5] * o_pf32[2]));
+	b_af32[2] = -((w_pf32[6] * o_pf32[0]) + (w_pf32[7] * o_pf32[1]) + (w_pf32[8] * o_pf32[2]));
+
+	done_u32 = Lis3mdlCalibApplyKernel(w_pf32, b_af32, field_pf32, out_pf32, count_u32);
+	Lis3mdlCalibApplyScalar(w_pf32, b_af32, &field_pf32[3u * done_u32], &out_pf32[3u * done_u32],
+							count_u32 - done_u32);
+}
+
+
+extern void Lis3mdlCalibFitInit(Lis3mdlCalibFit_st * fit_pst)
+{
+	Lis3mdlCalibFit_st empty_st = { { 0.0 }, 0u };
+
+	*fit_pst = empty_st;
+}
+
+
+extern void Lis3mdlCalibFitAccumulate(Lis3mdlCalibFit_st * fit_pst, const float * field_pf32, uint32_t count_u32)
+{
+	uint32_t done_u32;
+
+	done_u32 = Lis3mdlCalibAccumulateKernel(field_pf32, count_u32, fit_pst->moment_af64);
+	Lis3mdlCalibAccumulateScalar(&field_pf32[3u * done_u32], count_u32 - done_u32, fit_pst->moment_af64);
+	fit_pst->count_u64 += count_u32;
+}
+
+
+extern void Lis3mdlCalibFitMerge(Lis3mdlCalibFit_st * fit_pst, const Lis3mdlCalibFit_st * other_pst)
+{
+	uint32_t k_u32;
+
+	for(k_u32 = 0u; k_u32 < LIS3MDL_CALIB_MOMENTS; k_u32++)
+	{
+		fit_pst->moment_af64[k_u32] += other_pst->moment_af64[k_u32];
+	}
+	fit_pst->count_u64 += other_pst->count_u64;
+}
+
+
+extern status_t Lis3mdlCalibFitSolve(const Lis3mdlCalibFit_st * fit_pst, float fieldGauss_f32,
+									 Lis3mdlCalib_st * calib_pst)
+{
+	double normal_af64[LIS3MDL_CALIB_PARAMS][LIS3MDL_CALIB_PARAMS];
+	double p_af64[LIS3MDL_CALIB_PARAMS];
+	double shape_af64[3][3];
+	double inverse_af64[3][3];
+	double eigen_af64[3];
+	double vectors_af64[3][3];
+	double centre_af64[3];
+	double det_f64;
+	double k_f64;
+	double radius_f64;
+	uint32_t i_u32;
+	uint32_t j_u32;
+	uint32_t k_u32;
+
+	if(fit_pst->count_u64 < LIS3MDL_CALIB_MIN_SAMPLES)
+	{
+		return STATUS_ERROR;
+	}
+
+	/* D'1 and D'D: every entry is a scaled moment of the product of the terms */
+	for(i_u32 = 0u; i_u32 < LIS3MDL_CALIB_PARAMS; i_u32++)
+	{
+		const uint8_t *ti_pu8 = Lis3mdlCalibTerm_au8[i_u32];
+
+		p_af64[i_u32] = Lis3mdlCalibTermScale_af64[i_u32] * Lis3mdlCalibMoment(fit_pst, ti_pu8[0], ti_pu8[1], ti_pu8[2]);
+
+		for(j_u32 = i_u32; j_u32 < LIS3MDL_CALIB_PARAMS; j_u32++)
+		{
+			const uint8_t *tj_pu8 = Lis3mdlCalibTerm_au8[j_u32];
+
+			normal_af64[i_u32][j_u32] = Lis3mdlCalibTermScale_af64[i_u32] * Lis3mdlCalibTermScale_af64[j_u32] *
+										Lis3mdlCalibMoment(fit_pst, (uint8_t)(ti_pu8[0] + tj_pu8[0]),
+														   (uint8_t)(ti_pu8[1] + tj_pu8[1]),
+														   (uint8_t)(ti_pu8[2] + tj_pu8[2]));
+			normal_af64[j_u32][i_u32] = normal_af64[i_u32][j_u32];
+		}
+	}
+
+	/* Least squares of [x2 y2 z2 2xy 2xz 2yz 2x 2y 2z] p = 1 */
+	if(Lis3mdlCalibCholeskySolve(normal_af64, p_af64) != STATUS_OK)
+	{
+		return STATUS_ERROR;
+	}
+
+	shape_af64[0][0] = p_af64[0];
+	shape_af64[1][1] = p_af64[1];
+	shape_af64[2][2] = p_af64[2];
+	shape_af64[0][1] = shape_af64[1][0] = p_af64[3];
+	shape_af64[0][2] = shape_af64[2][0] = p_af64[4];
+	shape_af64[1][2] = shape_af64[2][1] = p_af64[5];
+
+	/* Centre o = -A^-1 v, by cofactors */
+	inverse_af64[0][0] = (shape_af64[1][1] * shape_af64[2][2]) - (shape_af64[1][2] * shape_af64[2][1]);
+	inverse_af64[0][1] = (shape_af64[0][2] * shape_af64[2][1]) - (shape_af64[0][1] * shape_af64[2][2]);
+	inverse_af64[0][2] = (shape_af64[0][1] * shape_af64[1][2]) - (shape_af64[0][2] * shape_af64[1][1]);
+	inverse_af64[1][1] = (shape_af64[0][0] * shape_af64[2][2]) - (shape_af64[0][2] * shape_af64[2][0]);
+	inverse_af64[1][2] = (shape_af64[0][2] * shape_af64[1][0]) - (shape_af64[0][0] * shape_af64[1][2]);
+	inverse_af64[2][2] = (shape_af64[0][0] * shape_af64[1][1]) - (shape_af64[0][1] * shape_af64[1][0]);
+	inverse_af64[1][0] = inverse_af64[0][1];
+	inverse_af64[2][0] = inverse_af64[0][2];
+	inverse_af64[2][1] = inverse_af64[1][2];
+
+	det_f64 = (shape_af64[0][0] * inverse_af64[0][0]) + (shape_af64[0][1] * inverse_af64[1][0]) +
+			  (shape_af64[0][2] * inverse_af64[2][0]);
+	if(det_f64 <= 0.0)
+	{
+		return STATUS_ERROR;
+	}
+
+	for(i_u32 = 0u; i_u32 < 3u; i_u32++)
+	{
+		centre_af64[i_u32] = -((inverse_af64[i_u32][0] * p_af64[6]) + (inverse_af64[i_u32][1] * p_af64[7]) +
+							   (inverse_af64[i_u32][2] * p_af64[8])) / det_f64;
+	}
+
+	/* Recentred: (m - o)' A (m - o) = 1 + o' A o */
+	k_f64 = 1.0;
+	for(i_u32 = 0u; i_u32 < 3u; i_u32++)
+	{
+		for(j_u32 = 0u; j_u32 < 3u; j_u32++)
+		{
+			k_f64 += centre_af64[i_u32] * shape_af64[i_u32][j_u32] * centre_af64[j_u32];
+		}
+	}
+
+	Lis3mdlCalibEigen3(shape_af64, eigen_af64, vectors_af64);
+
+	for(i_u32 = 0u; i_u32 < 3u; i_u32++)
+	{
+		/* Not an ellipsoid: a hyperboloid or a degenerate fit */
+		if((eigen_af64[i_u32] / k_f64) <= 0.0)
+		{
+			return STATUS_ERROR;
+		}
+		eigen_af64[i_u32] = sqrt(eigen_af64[i_u32] / k_f64);
+	}
+
+	/* Semi-axes are 1 / eigen; keep their geometric mean unless a field is given */
+	radius_f64 = (fieldGauss_f32 > 0.0f) ? (double)fieldGauss_f32
+										 : 1.0 / cbrt(eigen_af64[0] * eigen_af64[1] * eigen_af64[2]);
+
+	/* W = radius * V diag(sqrt(eig / k)) V' */
+	for(i_u32 = 0u; i_u32 < 3u; i_u32++)
+	{
+		calib_pst->offset_af32[i_u32] = (float)centre_af64[i_u32];
+
+		for(j_u32 = 0u; j_u32 < 3u; j_u32++)
+		{
+			double sum_f64 = 0.0;
+
+			for(k_u32 = 0u; k_u32 < 3u; k_u32++)
+			{
+				sum_f64 += vectors_af64[i_u32][k_u32] * eigen_af64[k_u32] * vectors_af64[j_u32][k_u32];
+			}
+			calib_pst->softIron_af32[(3u * i_u32) + j_u32] = (float)(radius_f64 * sum_f64);
+		}
+	}
+
+	return STATUS_OK;
+}
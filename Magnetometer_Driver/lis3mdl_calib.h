@@ -0,0 +1,113 @@
+/**
+ * @file       lis3mdl_calib.h
+ *
+ * @brief      Header file for the LIS3MDL hard-iron/soft-iron calibration engine.
+ *
+ *             Application: every sample of a batch in gauss (as produced by
+ *             Lis3mdlConvertToFloat) is corrected as W * (m - o), with o the hard-iron
+ *             offset and W the 3x3 soft-iron matrix. The kernel is vectorized over the
+ *             batch (SSE2 or NEON, scalar otherwise).
+ *
+ *             Fitting: a fit accumulates the sufficient statistics of a least-squares
+ *             ellipsoid fit one batch at a time, without keeping samples: the sums of the
+ *             34 monomials of degree 1 to 4 in x, y, z, from which D'D and D'1 of the
+ *             9-parameter quadric are assembled when solving. Fits taken over separate parts of a capture can be
+ *             merged. Lis3mdlCalibFitSolve turns the statistics into a calibration on demand.
+ *
+ * @author     Aniket SAHA
+ * @date       Oct 16, 2026
+ */
+
+#ifndef LIS3MDL_CALIB_H_
+#define LIS3MDL_CALIB_H_
+
+/******************************************************************************
+ * Include Header Files
+ ******************************************************************************/
+#include "stdint.h"
+
+/******************************************************************************
+ * Macro Declarations
+ ******************************************************************************/
+#define LIS3MDL_CALIB_PARAMS        9u      /* x^2, y^2, z^2, 2xy, 2xz, 2yz, 2x, 2y, 2z */
+#define LIS3MDL_CALIB_MOMENTS       34u     /* Monomials of degree 1 to 4 in x, y, z */
+#define LIS3MDL_CALIB_MIN_SAMPLES   LIS3MDL_CALIB_PARAMS
+
+/******************************************************************************
+ * Types Declarations
+ ******************************************************************************/
+typedef struct
+{
+    float offset_af32[3];                       /* Hard-iron offset o, gauss */
+    float softIron_af32[9];                     /* Soft-iron matrix W, row-major */
+} Lis3mdlCalib_st;
+
+typedef struct
+{
+    double moment_af64[LIS3MDL_CALIB_MOMENTS];      /* Sums of x^i y^j z^k over the samples */
+    uint64_t count_u64;                             /* Samples accumulated */
+} Lis3mdlCalibFit_st;
+
+/******************************************************************************
+ * Extern Functions Declarations
+ ******************************************************************************/
+/**
+ * @brief Initialise a calibration to the identity (no offset, W = I).
+ *
+ * @param[out] calib_pst Calibration to initialise.
+ */
+extern void Lis3mdlCalibInit(Lis3mdlCalib_st *calib_pst);
+
+/**
+ * @brief Apply a calibration to a batch of samples.
+ *
+ * @param[in]  calib_pst  Calibration.
+ * @param[in]  field_pf32 3 * count_u32 floats, X, Y, Z per sample, in gauss.
+ * @param[out] out_pf32   3 * count_u32 calibrated floats; may be the same buffer as field_pf32.
+ * @param[in]  count_u32  Number of samples.
+ */
+extern void Lis3mdlCalibApply(const Lis3mdlCalib_st *calib_pst, const float *field_pf32, float *out_pf32,
+                              uint32_t count_u32);
+
+/**
+ * @brief Clear the statistics of a fit.
+ *
+ * @param[out] fit_pst Fit to clear.
+ */
+extern void Lis3mdlCalibFitInit(Lis3mdlCalibFit_st *fit_pst);
+
+/**
+ * @brief Add a batch of samples to a fit.
+ *
+ * @param[in,out] fit_pst   Fit.
+ * @param[in]  field_pf32   3 * count_u32 floats, X, Y, Z per sample, in gauss (uncalibrated).
+ * @param[in]  count_u32    Number of samples.
+ */
+extern void Lis3mdlCalibFitAccumulate(Lis3mdlCalibFit_st *fit_pst, const float *field_pf32, uint32_t count_u32);
+
+/**
+ * @brief Add the statistics of one fit to another (e.g. fits of separate capture chunks).
+ *
+ * @param[in,out] fit_pst  Destination fit.
+ * @param[in]  other_pst   Fit to add.
+ */
+extern void Lis3mdlCalibFitMerge(Lis3mdlCalibFit_st *fit_pst, const Lis3mdlCalibFit_st *other_pst);
+
+/**
+ * @brief Solve the ellipsoid fit and derive the calibration.
+ *
+ *        The fitted quadric is recentred on its centre o and W is the symmetric square
+ *        root of its shape matrix, scaled so that calibrated samples lie on a sphere of
+ *        radius fieldGauss_f32 (or, when 0, of the geometric mean of the semi-axes).
+ *
+ * @param[in]  fit_pst         Fit with at least LIS3MDL_CALIB_MIN_SAMPLES samples.
+ * @param[in]  fieldGauss_f32  Local field magnitude in gauss, or 0 to keep the fitted size.
+ * @param[out] calib_pst       Resulting calibration; untouched on failure.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR when the samples do not determine an
+ *         ellipsoid (too few, or too little rotation coverage).
+ */
+extern status_t Lis3mdlCalibFitSolve(const Lis3mdlCalibFit_st *fit_pst, float fieldGauss_f32,
+                                     Lis3mdlCalib_st *calib_pst);
+
+#endif /* LIS3MDL_CALIB_H_ */
@@ -0,0 +1,382 @@
+/**
+ * @file       lis3mdl_convert.c
+ *
+ * @brief      Implementation file for the LIS3MDL batch raw-to-physical conversion kernels.
+ *
+ *             The samples are treated as one flat array of 3 * count int16 values, which all
+ *             share the same scale, so the kernels do not need to deinterleave the axes.
+ *
+ * @author     Aniket SAHA
+ * @date       Oct 16, 2026
+ */
+
+/******************************************************************************
+ * Include Header Files
+ ******************************************************************************/
+#include "i2c.h"
+#include "lis3mdl.h"
+#include "lis3mdl_convert.h"
+#include "stdint.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LIS3MDL_CONVERT_KERNEL		"avx2"
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define LIS3MDL_CONVERT_KERNEL		"sse2"
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define LIS3MDL_CONVERT_KERNEL		"neon"
+#else
+#define LIS3MDL_CONVERT_KERNEL		"scalar"
+#endif
+
+/******************************************************************************
+ * Macro Declarations
+ ******************************************************************************/
+#define LIS3MDL_AXES				3u
+#define LIS3MDL_Q_MULT_MAX			32767u		/* Multiplier must fit an int16 lane */
+
+/******************************************************************************
+ * Types Declarations
+ ******************************************************************************/
+typedef struct
+{
+	int16_t mult_s16;
+	uint8_t shift_u8;
+	int32_t round_s32;
+} Lis3mdlQParams_st;
+
+_Static_assert(sizeof(Lis3mdlSampleXYZ_st) == (LIS3MDL_AXES * sizeof(int16_t)),
+			   "Lis3mdlSampleXYZ_st must be three packed int16");
+
+/******************************************************************************
+ * Static Function Definitions
+ ******************************************************************************/
+static status_t Lis3mdlFloatScale(Lis3mdlScale_t scale_en, Lis3mdlUnit_t unit_en, float *scale_pf32)
+{
+	uint16_t lsbPerGauss_u16;
+
+	if(Lis3mdlGetSensitivity(scale_en, &lsbPerGauss_u16) != STATUS_OK)
+	{
+		return STATUS_ERROR;
+	}
+
+	switch(unit_en)
+	{
+	case LIS3MDL_UNIT_GAUSS:
+		*scale_pf32 = 1.0f / (float)lsbPerGauss_u16;
+		break;
+
+	case LIS3MDL_UNIT_MICROTESLA:
+		*scale_pf32 = 100.0f / (float)lsbPerGauss_u16;
+		break;
+
+	default:
+		return STATUS_ERROR;
+	}
+
+	return STATUS_OK;
+}
+
+
+/* Largest shift whose multiplier still fits LIS3MDL_Q_MULT_MAX, for the best precision. */
+static status_t Lis3mdlQScale(Lis3mdlScale_t scale_en, uint8_t fracBits_u8, Lis3mdlQParams_st *params_pst)
+{
+	uint16_t lsbPerGauss_u16;
+	uint64_t mult_u64 = 0u;
+	uint8_t shift_u8;
+
+	if((fracBits_u8 > LIS3MDL_CONVERT_Q_MAX_FRAC_BITS) ||
+	   (Lis3mdlGetSensitivity(scale_en, &lsbPerGauss_u16) != STATUS_OK))
+	{
+		return STATUS_ERROR;
+	}
+
+	for(shift_u8 = 1u; shift_u8 < 31u; shift_u8++)
+	{
+		uint64_t next_u64 = (((uint64_t)1u << (fracBits_u8 + shift_u8)) + (lsbPerGauss_u16 / 2u)) / lsbPerGauss_u16;
+
+		if(next_u64 > LIS3MDL_Q_MULT_MAX)
+		{
+			break;
+		}
+		mult_u64 = next_u64;
+	}
+
+	params_pst->mult_s16 = (int16_t)mult_u64;
+	params_pst->shift_u8 = (uint8_t)(shift_u8 - 1u);
+	params_pst->round_s32 = (int32_t)1 << (params_pst->shift_u8 - 1u);
+
+	return STATUS_OK;
+}
+
+
+static void Lis3mdlFloatKernelScalar(const int16_t *raw_ps16, uint32_t count_u32, float scale_f32, float *out_pf32)
+{
+	uint32_t index_u32;
+
+	for(index_u32 = 0u; index_u32 < count_u32; index_u32++)
+	{
+		out_pf32[index_u32] = (float)raw_ps16[index_u32] * scale_f32;
+	}
+}
+
+
+static void Lis3mdlQKernelScalar(const int16_t *raw_ps16, uint32_t count_u32, const Lis3mdlQParams_st *params_pst,
+								 int32_t *out_ps32)
+{
+	uint32_t index_u32;
+
+	for(index_u32 = 0u; index_u32 < count_u32; index_u32++)
+	{
+		/* |raw * mult| < 2^30, so the product and rounding term fit an int32 */
+		out_ps32[index_u32] = ((int32_t)raw_ps16[index_u32] * params_pst->mult_s16 + params_pst->round_s32)
+							  >> params_pst->shift_u8;
+	}
+}
+
+
+#if defined(__AVX2__)
+
+static uint32_t Lis3mdlFloatKernel(const int16_t *raw_ps16, uint32_t count_u32, float scale_f32, float *out_pf32)
+{
+	const __m256 scale_v = _mm256_set1_ps(scale_f32);
+	uint32_t index_u32;
+
+	for(index_u32 = 0u; (index_u32 + 16u) <= count_u32; index_u32 += 16u)
+	{
+		__m256i raw_v = _mm256_loadu_si256((const __m256i *)&raw_ps16[index_u32]);
+		__m256i lo_v = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(raw_v));
+		__m256i hi_v = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(raw_v, 1));
+
+		_mm256_storeu_ps(&out_pf32[index_u32], _mm256_mul_ps(_mm256_cvtepi32_ps(lo_v), scale_v));
+		_mm256_storeu_ps(&out_pf32[index_u32 + 8u], _mm256_mul_ps(_mm256_cvtepi32_ps(hi_v), scale_v));
+	}
+
+	return index_u32;
+}
+
+
+static uint32_t Lis3mdlQKernel(const int16_t *raw_ps16, uint32_t count_u32, const Lis3mdlQParams_st *params_pst,
+							   int32_t *out_ps32)
+{
+	const __m256i mult_v = _mm256_set1_epi32(params_pst->mult_s16);
+	const __m256i round_v = _mm256_set1_epi32(params_pst->round_s32);
+	const __m128i shift_v = _mm_cvtsi32_si128(params_pst->shift_u8);
+	uint32_t index_u32;
+
+	for(index_u32 = 0u; (index_u32 + 16u) <= count_u32; index_u32 += 16u)
+	{
+		__m256i raw_v = _mm256_loadu_si256((const __m256i *)&raw_ps16[index_u32]);
+		__m256i lo_v = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(raw_v));
+		__m256i hi_v = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(raw_v, 1));
+
+		lo_v = _mm256_sra_epi32(_mm256_add_epi32(_mm256_mullo_epi32(lo_v, mult_v), round_v), shift_v);
+		hi_v = _mm256_sra_epi32(_mm256_add_epi32(_mm256_mullo_epi32(hi_v, mult_v), round_v), shift_v);
+
+		_mm256_storeu_si256((__m256i *)&out_ps32[index_u32], lo_v);
+		_mm256_storeu_si256((__m256i *)&out_ps32[index_u32 + 8u], hi_v);
+	}
+
+	return index_u32;
+}
+
+#elif defined(__SSE2__)
+
+static uint32_t Lis3mdlFloatKernel(const int16_t *raw_ps16, uint32_t count_u32, float scale_f32, float *out_pf32)
+{
+	const __m128 scale_v = _mm_set1_ps(scale_f32);
+	uint32_t index_u32;
+
+	for(index_u32 = 0u; (index_u32 + 8u) <= count_u32; index_u32 += 8u)
+	{
+		__m128i raw_v = _mm_loadu_si128((const __m128i *)&raw_ps16[index_u32]);
+		/* Sign-extend: put each int16 in the top half of a lane, then shift it down */
+		__m128i lo_v = _mm_srai_epi32(_mm_unpacklo_epi16(raw_v, raw_v), 16);
+		__m128i hi_v = _mm_srai_epi32(_mm_unpackhi_epi16(raw_v, raw_v), 16);
+
+		_mm_storeu_ps(&out_pf32[index_u32], _mm_mul_ps(_mm_cvtepi32_ps(lo_v), scale_v));
+		_mm_storeu_ps(&out_pf32[index_u32 + 4u], _mm_mul_ps(_mm_cvtepi32_ps(hi_v), scale_v));
+	}
+
+	return index_u32;
+}
+
+
+static uint32_t Lis3mdlQKernel(const int16_t *raw_ps16, uint32_t count_u32, const Lis3mdlQParams_st *params_pst,
+							   int32_t *out_ps32)
+{
+	const __m128i mult_v = _mm_set1_epi16(params_pst->mult_s16);
+	const __m128i round_v = _mm_set1_epi32(params_pst->round_s32);
+	const __m128i shift_v = _mm_cvtsi32_si128(params_pst->shift_u8);
+	uint32_t index_u32;
+
+	for(index_u32 = 0u; (index_u32 + 8u) <= count_u32; index_u32 += 8u)
+	{
+		__m128i raw_v = _mm_loadu_si128((const __m128i *)&raw_ps16[index_u32]);
+		/* 16x16 -> 32-bit products from their low and high halves */
+		__m128i prodLo_v = _mm_mullo_epi16(raw_v, mult_v);
+		__m128i prodHi_v = _mm_mulhi_epi16(raw_v, mult_v);
+		__m128i lo_v = _mm_unpacklo_epi16(prodLo_v, prodHi_v);
+		__m128i hi_v = _mm_unpackhi_epi16(prodLo_v, prodHi_v);
+
+		_mm_storeu_si128((__m128i *)&out_ps32[index_u32], _mm_sra_epi32(_mm_add_epi32(lo_v, round_v), shift_v));
+		_mm_storeu_si128((__m128i *)&out_ps32[index_u32 + 4u], _mm_sra_epi32(_mm_add_epi32(hi_v, round_v), shift_v));
+	}
+
+	return index_u32;
+}
+
+#elif defined(__ARM_NEON)
+
+static uint32_t Lis3mdlFloatKernel(const int16_t *raw_ps16, uint32_t count_u32, float scale_f32, float *out_pf32)
+{
+	uint32_t index_u32;
+
+	for(index_u32 = 0u; (index_u32 + 8u) <= count_u32; index_u32 += 8u)
+	{
+		int16x8_t raw_v = vld1q_s16(&raw_ps16[index_u32]);
+		float32x4_t lo_v = vcvtq_f32_s32(vmovl_s16(vget_low_s16(raw_v)));
+		float32x4_t hi_v = vcvtq_f32_s32(vmovl_s16(vget_high_s16(raw_v)));
+
+		vst1q_f32(&out_pf32[index_u32], vmulq_n_f32(lo_v, scale_f32));
+		vst1q_f32(&out_pf32[index_u32 + 4u], vmulq_n_f32(hi_v, scale_f32));
+	}
+
+	return index_u32;
+}
+
+
+static uint32_t Lis3mdlQKernel(const int16_t *raw_ps16, uint32_t count_u32, const Lis3mdlQParams_st *params_pst,
+							   int32_t *out_ps32)
+{
+	const int16x4_t mult_v = vdup_n_s16(params_pst->mult_s16);
+	const int32x4_t round_v = vdupq_n_s32(params_pst->round_s32);
+	/* A negative left shift is an arithmetic right shift */
+	const int32x4_t shift_v = vdupq_n_s32(-(int32_t)params_pst->shift_u8);
+	uint32_t index_u32;
+
+	for(index_u32 = 0u; (index_u32 + 8u) <= count_u32; index_u32 += 8u)
+	{
+		int16x8_t raw_v = vld1q_s16(&raw_ps16[index_u32]);
+		int32x4_t lo_v = vmlal_s16(round_v, vget_low_s16(raw_v), mult_v);
+		int32x4_t hi_v = vmlal_s16(round_v, vget_high_s16(raw_v), mult_v);
+
+		vst1q_s32(&out_ps32[index_u32], vshlq_s32(lo_v, shift_v));
+		vst1q_s32(&out_ps32[index_u32 + 4u], vshlq_s32(hi_v, shift_v));
+	}
+
+	return index_u32;
+}
+
+#else
+
+static uint32_t Lis3mdlFloatKernel(const int16_t *raw_ps16, uint32_t count_u32, float scale_f32, float *out_pf32)
+{
+	(void)raw_ps16;
+	(void)count_u32;
+	(void)scale_f32;
+	(void)out_pf32;
+
+	return 0u;
+}
+
+
+static uint32_t Lis3mdlQKernel(const int16_t *raw_ps16, uint32_t count_u32, const Lis3mdlQParams_st *params_pst,
+							   int32_t *out_ps32)
+{
+	(void)raw_ps16;
+	(void)count_u32;
+	(void)params_pst;
+	(void)out_ps32;
+
+	return 0u;
+}
+
+#endif
+
+/******************************************************************************
+ * Extern Function Definitions
+ ******************************************************************************/
+extern status_t Lis3mdlConvertToFloat(Lis3mdlScale_t scale_en, Lis3mdlUnit_t unit_en,
+									  const Lis3mdlSampleXYZ_st * samples_pst, uint32_t count_u32,
+									  float * field_pf32)
+{
+	const int16_t *raw_ps16 = (const int16_t *)samples_pst;
+	uint32_t values_u32 = count_u32 * LIS3MDL_AXES;
+	uint32_t done_u32;
+	float scale_f32;
+
+	if(Lis3mdlFloatScale(scale_en, unit_en, &scale_f32) != STATUS_OK)
+	{
+		return STATUS_ERROR;
+	}
+
+	/* Vector body, then the scalar loop for the tail */
+	done_u32 = Lis3mdlFloatKernel(raw_ps16, values_u32, scale_f32, field_pf32);
+	Lis3mdlFloatKernelScalar(&raw_ps16[done_u32], values_u32 - done_u32, scale_f32, &field_pf32[done_u32]);
+
+	return STATUS_OK;
+}
+
+
+extern status_t Lis3mdlConvertToFloatScalar(Lis3mdlScale_t scale_en, Lis3mdlUnit_t unit_en,
+											const Lis3mdlSampleXYZ_st * samples_pst, uint32_t count_u32,
+											float * field_pf32)
+{
+	float scale_f32;
+
+	if(Lis3mdlFloatScale(scale_en, unit_en, &scale_f32) != STATUS_OK)
+	{
+		return STATUS_ERROR;
+	}
+
+	Lis3mdlFloatKernelScalar((const int16_t *)samples_pst, count_u32 * LIS3MDL_AXES, scale_f32, field_pf32);
+
+	return STATUS_OK;
+}
+
+
+extern status_t Lis3mdlConvertToQ(Lis3mdlScale_t scale_en, uint8_t fracBits_u8,
+								  const Lis3mdlSampleXYZ_st * samples_pst, uint32_t count_u32,
+								  int32_t * field_ps32)
+{
+	const int16_t *raw_ps16 = (const int16_t *)samples_pst;
+	uint32_t values_u32 = count_u32 * LIS3MDL_AXES;
+	Lis3mdlQParams_st params_st;
+	uint32_t done_u32;
+
+	if(Lis3mdlQScale(scale_en, fracBits_u8, &params_st) != STATUS_OK)
+	{
+		return STATUS_ERROR;
+	}
+
+	done_u32 = Lis3mdlQKernel(raw_ps16, values_u32, &params_st, field_ps32);
+	Lis3mdlQKernelScalar(&raw_ps16[done_u32], values_u32 - done_u32, &params_st, &field_ps32[done_u32]);
+
+	return STATUS_OK;
+}
+
+
+extern status_t Lis3mdlConvertToQScalar(Lis3mdlScale_t scale_en, uint8_t fracBits_u8,
+										const Lis3mdlSampleXYZ_st * samples_pst, uint32_t count_u32,
+										int32_t * field_ps32)
+{
+	Lis3mdlQParams_st params_st;
+
+	if(Lis3mdlQScale(scale_en, fracBits_u8, &params_st) != STATUS_OK)
+	{
+		return STATUS_ERROR;
+	}
+
+	Lis3mdlQKernelScalar((const int16_t *)samples_pst, count_u32 * LIS3MDL_AXES, &params_st, field_ps32);
+
+	return STATUS_OK;
+}
+
+
+extern const char * Lis3mdlConvertKernelName(void)
+{
+	return LIS3MDL_CONVERT_KERNEL;
+}
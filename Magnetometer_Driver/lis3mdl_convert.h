@@ -0,0 +1,101 @@
+/**
+ * @file       lis3mdl_convert.h
+ *
+ * @brief      Header file for the LIS3MDL batch raw-to-physical conversion kernels.
+ *
+ *             Converts arrays of raw XYZ samples to gauss or microtesla (float) or to
+ *             signed Q-format gauss (int32) using the full-scale sensitivity. The kernel
+ *             is picked at compile time: AVX2, SSE2 or NEON when the target has it, a
+ *             scalar loop otherwise. Every kernel performs the same arithmetic as the
+ *             scalar reference (one exact int-to-float conversion and one multiply, or
+ *             the same integer multiply/round/shift), so results are bit-identical.
+ *
+ * @author     Aniket SAHA
+ * @date       Oct 16, 2026
+ */
+
+#ifndef LIS3MDL_CONVERT_H_
+#define LIS3MDL_CONVERT_H_
+
+/******************************************************************************
+ * Include Header Files
+ ******************************************************************************/
+#include "stdint.h"
+
+/******************************************************************************
+ * Macro Declarations
+ ******************************************************************************/
+#define LIS3MDL_CONVERT_Q_MAX_FRAC_BITS     16u     /* Q16.16 gauss at most */
+
+/******************************************************************************
+ * Types Declarations
+ ******************************************************************************/
+typedef enum
+{
+    LIS3MDL_UNIT_GAUSS,        /* Gauss */
+    LIS3MDL_UNIT_MICROTESLA    /* Microtesla, 100 uT per gauss */
+} Lis3mdlUnit_t;
+
+/******************************************************************************
+ * Extern Functions Declarations
+ ******************************************************************************/
+/**
+ * @brief Convert raw samples to gauss or microtesla.
+ *
+ * @param[in]  scale_en     Full-scale setting the samples were taken with.
+ * @param[in]  unit_en      Output unit.
+ * @param[in]  samples_pst  Raw samples.
+ * @param[in]  count_u32    Number of samples.
+ * @param[out] field_pf32   3 * count_u32 floats, X, Y, Z per sample (Lis3mdlFieldGauss_st layout).
+ *
+ * @return STATUS_OK on success, STATUS_ERROR for an unknown scale or unit.
+ */
+extern status_t Lis3mdlConvertToFloat(Lis3mdlScale_t scale_en, Lis3mdlUnit_t unit_en,
+                                      const Lis3mdlSampleXYZ_st *samples_pst, uint32_t count_u32,
+                                      float *field_pf32);
+
+/**
+ * @brief Scalar reference of Lis3mdlConvertToFloat.
+ */
+extern status_t Lis3mdlConvertToFloatScalar(Lis3mdlScale_t scale_en, Lis3mdlUnit_t unit_en,
+                                            const Lis3mdlSampleXYZ_st *samples_pst, uint32_t count_u32,
+                                            float *field_pf32);
+
+/**
+ * @brief Convert raw samples to Q-format gauss.
+ *
+ *        Each output is round(raw * multiplier / 2^shift), where multiplier is the
+ *        largest 15-bit approximation of 2^(fracBits + shift) / sensitivity. Against the
+ *        exact value, the error is at most half an output LSB, 2^-(fracBits + 1) gauss,
+ *        for the final rounding. On top of that comes at most one raw LSB,
+ *        1/sensitivity gauss, for the multiplier over the whole int16 input range.
+ *        Which term dominates depends on fracBits. Below about 13 fractional bits,
+ *        the output grid is coarser than a raw LSB and the rounding dominates. From
+ *        13 fractional bits up, the measured error stays below one raw LSB at every
+ *        full scale.
+ *
+ * @param[in]  scale_en     Full-scale setting the samples were taken with.
+ * @param[in]  fracBits_u8  Fractional bits of the output, up to LIS3MDL_CONVERT_Q_MAX_FRAC_BITS.
+ * @param[in]  samples_pst  Raw samples.
+ * @param[in]  count_u32    Number of samples.
+ * @param[out] field_ps32   3 * count_u32 values, X, Y, Z per sample.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR for an unknown scale or too many fractional bits.
+ */
+extern status_t Lis3mdlConvertToQ(Lis3mdlScale_t scale_en, uint8_t fracBits_u8,
+                                  const Lis3mdlSampleXYZ_st *samples_pst, uint32_t count_u32,
+                                  int32_t *field_ps32);
+
+/**
+ * @brief Scalar reference of Lis3mdlConvertToQ.
+ */
+extern status_t Lis3mdlConvertToQScalar(Lis3mdlScale_t scale_en, uint8_t fracBits_u8,
+                                        const Lis3mdlSampleXYZ_st *samples_pst, uint32_t count_u32,
+                                        int32_t *field_ps32);
+
+/**
+ * @brief Name of the kernel selected at compile time ("avx2", "sse2", "neon" or "scalar").
+ */
+extern const char * Lis3mdlConvertKernelName(void);
+
+#endif /* LIS3MDL_CONVERT_H_ */
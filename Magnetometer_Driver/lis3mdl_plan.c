@@ -0,0 +1,260 @@
+/**
+ * @file       lis3mdl_plan.c
+ *
+ * @brief      Implementation file for the LIS3MDL energy and bus budget planner.
+ *
+ * @author     Aniket SAHA
+ * @date       Oct 16, 2026
+ */
+
+/******************************************************************************
+ * Include Header Files
+ ******************************************************************************/
+#include "i2c.h"
+#include "lis3mdl.h"
+#include "lis3mdl_plan.h"
+#include "stdint.h"
+#include <math.h>
+
+/******************************************************************************
+ * Macro Declarations
+ ******************************************************************************/
+#define LIS3MDL_PLAN_ARRAY_LEN(a)		(sizeof(a) / sizeof((a)[0]))
+#define LIS3MDL_PLAN_MODES				4u
+#define LIS3MDL_PLAN_IDLE_MICROAMP		1.0f		/* Power-down and between conversions, typical */
+#define LIS3MDL_PLAN_READ_LEN_FAST		3u			/* OUT_X_H, OUT_Y_H, OUT_Z_H */
+#define LIS3MDL_PLAN_TRIGGER_LEN		1u			/* CTRL_REG3 */
+#define LIS3MDL_PLAN_EPSILON			1e-6f
+
+/******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+/*
+ * Typical figures per operating mode (LP, MP, HP, UHP), to be checked against the
+ * datasheet revision and board characterisation in use. The charge of one conversion
+ * is the typical supply current at 80 Hz divided by 80 (40, 80, 150 and 270 uA); the
+ * RMS noise is that at +/-4 gauss and is used for every full scale.
+ */
+static const float Lis3mdlPlanChargeMicroCoulomb_af32[LIS3MDL_PLAN_MODES] = { 0.5f, 1.0f, 1.875f, 3.375f };
+static const float Lis3mdlPlanNoiseXyMilliGauss_af32[LIS3MDL_PLAN_MODES] = { 5.0f, 4.1f, 3.5f, 3.2f };
+static const float Lis3mdlPlanNoiseZMilliGauss_af32[LIS3MDL_PLAN_MODES] = { 6.5f, 5.0f, 4.1f, 3.5f };
+
+/******************************************************************************
+ * Static Function Definitions
+ ******************************************************************************/
+/* Bus time of one register access, counted as i2c_sim_transfer_ns does. */
+static float Lis3mdlPlanTransferSeconds(uint32_t busHz_u32, uint8_t isRead_u8, uint32_t length_u32)
+{
+	uint32_t bits_u32 = (1u + isRead_u8) + 1u + ((2u + isRead_u8 + length_u32) * 9u);
+
+	return (float)bits_u32 / (float)busHz_u32;
+}
+
+
+static status_t Lis3mdlPlanCheckRequest(const Lis3mdlPlanRequest_st *request_pst)
+{
+	uint16_t lsbPerGauss_u16;
+
+	if((request_pst == (Lis3mdlPlanRequest_st *)0) || (request_pst->rateMilliHz_u32 == 0u) ||
+	   (request_pst->busHz_u32 == 0u) || (request_pst->deviceCount_u8 == 0u) ||
+	   (request_pst->deviceCount_u8 > LIS3MDL_PLAN_MAX_DEVICES) ||
+	   (request_pst->noiseMilliGauss_f32 < 0.0f) || (request_pst->maxBusUtilization_f32 < 0.0f) ||
+	   (Lis3mdlGetSensitivity(request_pst->scale_en, &lsbPerGauss_u16) != STATUS_OK))
+	{
+		return STATUS_ERROR;
+	}
+
+	return STATUS_OK;
+}
+
+
+/* Largest number of sensors sharing one bus. */
+static uint32_t Lis3mdlPlanBusiestBus(const Lis3mdlPlanRequest_st *request_pst)
+{
+	uint32_t busiest_u32 = 0u;
+	uint32_t count_u32;
+	uint8_t index_u8;
+	uint8_t other_u8;
+
+	for(index_u8 = 0u; index_u8 < request_pst->deviceCount_u8; index_u8++)
+	{
+		count_u32 = 0u;
+		for(other_u8 = 0u; other_u8 < request_pst->deviceCount_u8; other_u8++)
+		{
+			count_u32 += (request_pst->bus_au8[other_u8] == request_pst->bus_au8[index_u8]);
+		}
+		busiest_u32 = (count_u32 > busiest_u32) ? count_u32 : busiest_u32;
+	}
+
+	return busiest_u32;
+}
+
+
+/* Order of preference: less current, then less bus time, then less latency. */
+static uint8_t Lis3mdlPlanIsBetter(const Lis3mdlPlan_st *plan_pst, const Lis3mdlPlan_st *best_pst)
+{
+	if(fabsf(plan_pst->currentMicroAmp_f32 - best_pst->currentMicroAmp_f32) > LIS3MDL_PLAN_EPSILON)
+	{
+		return (plan_pst->currentMicroAmp_f32 < best_pst->currentMicroAmp_f32);
+	}
+
+	if(fabsf(plan_pst->busUtilization_f32 - best_pst->busUtilization_f32) > LIS3MDL_PLAN_EPSILON)
+	{
+		return (plan_pst->busUtilization_f32 < best_pst->busUtilization_f32);
+	}
+
+	return (plan_pst->latencyUs_u32 < best_pst->latencyUs_u32);
+}
+
+/******************************************************************************
+ * Extern Function Definitions
+ ******************************************************************************/
+extern status_t Lis3mdlPlanEvaluate(const Lis3mdlPlanRequest_st *request_pst, Lis3mdlOperatingMode_t mode_en,
+									Lis3mdlPlanSampling_t sampling_en, Lis3mdlPlanRead_t read_en,
+									Lis3mdlPlan_st *plan_pst)
+{
+	Lis3mdlSpeedConfig_st speed_st;
+	uint32_t conversionMilliHz_u32;
+	uint32_t modeMilliHz_u32;
+	uint32_t busDevices_u32;
+	uint16_t lsbPerGauss_u16;
+	float transfer_f32;
+	float convertSeconds_f32;
+	float quantMilliGauss_f32;
+	float noise_f32;
+	float limit_f32;
+	float latency_f32;
+
+	if((Lis3mdlPlanCheckRequest(request_pst) != STATUS_OK) || (plan_pst == (Lis3mdlPlan_st *)0) ||
+	   ((uint32_t)mode_en >= LIS3MDL_PLAN_MODES) ||
+	   ((sampling_en != LIS3MDL_PLAN_CONTINUOUS) && (sampling_en != LIS3MDL_PLAN_SINGLE)) ||
+	   ((read_en != LIS3MDL_PLAN_READ_FULL) && (read_en != LIS3MDL_PLAN_READ_FAST)))
+	{
+		return STATUS_ERROR;
+	}
+
+	/* The single-conversion scheduler reads full samples only */
+	if((sampling_en == LIS3MDL_PLAN_SINGLE) && (read_en == LIS3MDL_PLAN_READ_FAST))
+	{
+		return STATUS_ERROR;
+	}
+
+	if(sampling_en == LIS3MDL_PLAN_CONTINUOUS)
+	{
+		/* Slowest ODR at or above the rate; every conversion is read */
+		if(Lis3mdlFindSpeedConfig(request_pst->rateMilliHz_u32, mode_en, &speed_st) != STATUS_OK)
+		{
+			return STATUS_ERROR;
+		}
+		(void)Lis3mdlGetOutputDataRateMilliHz(&speed_st, &conversionMilliHz_u32);
+		convertSeconds_f32 = 1000.0f / (float)conversionMilliHz_u32;
+		transfer_f32 = Lis3mdlPlanTransferSeconds(request_pst->busHz_u32, 1u,
+												  (read_en == LIS3MDL_PLAN_READ_FAST) ?
+												  LIS3MDL_PLAN_READ_LEN_FAST : LIS3MDL_STATUS_BURST_LEN);
+	}
+	else
+	{
+		/*
+		 * One conversion per sample, timed from the DO rate as lis3mdl_sched does.
+		 * Single-conversion mode is only specified at DO 0.625 to 80 Hz without
+		 * FAST_ODR, so the fastest DO bounds both the rate and the conversion time.
+		 */
+		speed_st.dataRate_en = LIS3MDL_ODR_80_HZ;
+		speed_st.operatingMode_en = mode_en;
+		speed_st.fastOdr_u8 = 0u;
+		(void)Lis3mdlGetOutputDataRateMilliHz(&speed_st, &modeMilliHz_u32);
+		if(modeMilliHz_u32 < request_pst->rateMilliHz_u32)
+		{
+			return STATUS_ERROR;
+		}
+		conversionMilliHz_u32 = request_pst->rateMilliHz_u32;
+		convertSeconds_f32 = 1000.0f / (float)modeMilliHz_u32;
+		transfer_f32 = Lis3mdlPlanTransferSeconds(request_pst->busHz_u32, 0u, LIS3MDL_PLAN_TRIGGER_LEN) +
+					   Lis3mdlPlanTransferSeconds(request_pst->busHz_u32, 1u, LIS3MDL_STATUS_BURST_LEN);
+	}
+
+	/* Sensor noise and the rounding of the read width, added in quadrature */
+	(void)Lis3mdlGetSensitivity(request_pst->scale_en, &lsbPerGauss_u16);
+	quantMilliGauss_f32 = (((read_en == LIS3MDL_PLAN_READ_FAST) ? 256000.0f : 1000.0f) / (float)lsbPerGauss_u16) /
+						  sqrtf(12.0f);
+	noise_f32 = Lis3mdlPlanNoiseXyMilliGauss_af32[mode_en];
+	noise_f32 = (Lis3mdlPlanNoiseZMilliGauss_af32[mode_en] > noise_f32) ?
+				Lis3mdlPlanNoiseZMilliGauss_af32[mode_en] : noise_f32;
+
+	/*
+	 * The worst-case sample waits for its own conversion and for every other sensor on
+	 * its bus to be served first.
+	 */
+	busDevices_u32 = Lis3mdlPlanBusiestBus(request_pst);
+	latency_f32 = convertSeconds_f32 + ((float)busDevices_u32 * transfer_f32);
+
+	plan_pst->speed_st = speed_st;
+	plan_pst->sampling_en = sampling_en;
+	plan_pst->read_en = read_en;
+	plan_pst->conversionMilliHz_u32 = conversionMilliHz_u32;
+	plan_pst->currentMicroAmp_f32 = LIS3MDL_PLAN_IDLE_MICROAMP +
+									((Lis3mdlPlanChargeMicroCoulomb_af32[mode_en] * (float)conversionMilliHz_u32) /
+									 1000.0f);
+	plan_pst->totalCurrentMicroAmp_f32 = plan_pst->currentMicroAmp_f32 * (float)request_pst->deviceCount_u8;
+	plan_pst->noiseMilliGauss_f32 = sqrtf((noise_f32 * noise_f32) + (quantMilliGauss_f32 * quantMilliGauss_f32));
+	plan_pst->busUtilization_f32 = ((float)busDevices_u32 * (float)conversionMilliHz_u32 * transfer_f32) / 1000.0f;
+	plan_pst->latencyUs_u32 = (uint32_t)ceilf(latency_f32 * 1e6f);
+
+	limit_f32 = (request_pst->maxBusUtilization_f32 > 0.0f) ? request_pst->maxBusUtilization_f32 : 1.0f;
+	plan_pst->feasible_u8 = (plan_pst->busUtilization_f32 <= limit_f32) &&
+							((request_pst->noiseMilliGauss_f32 == 0.0f) ||
+							 (plan_pst->noiseMilliGauss_f32 <= request_pst->noiseMilliGauss_f32)) &&
+							((sampling_en == LIS3MDL_PLAN_CONTINUOUS) ||
+							 ((latency_f32 * (float)request_pst->rateMilliHz_u32) <= 1000.0f));
+
+	return STATUS_OK;
+}
+
+
+extern status_t Lis3mdlPlanChoose(const Lis3mdlPlanRequest_st *request_pst, Lis3mdlPlan_st *plan_pst)
+{
+	static const Lis3mdlPlanSampling_t sampling_aen[] = { LIS3MDL_PLAN_CONTINUOUS, LIS3MDL_PLAN_SINGLE };
+	static const Lis3mdlPlanRead_t read_aen[] = { LIS3MDL_PLAN_READ_FULL, LIS3MDL_PLAN_READ_FAST };
+	Lis3mdlPlan_st candidate_st;
+	Lis3mdlPlan_st best_st;
+	uint32_t mode_u32;
+	uint32_t sampling_u32;
+	uint32_t read_u32;
+	uint8_t found_u8 = 0u;
+
+	if((Lis3mdlPlanCheckRequest(request_pst) != STATUS_OK) || (plan_pst == (Lis3mdlPlan_st *)0))
+	{
+		return STATUS_ERROR;
+	}
+
+	for(mode_u32 = 0u; mode_u32 < LIS3MDL_PLAN_MODES; mode_u32++)
+	{
+		for(sampling_u32 = 0u; sampling_u32 < LIS3MDL_PLAN_ARRAY_LEN(sampling_aen); sampling_u32++)
+		{
+			for(read_u32 = 0u; read_u32 < LIS3MDL_PLAN_ARRAY_LEN(read_aen); read_u32++)
+			{
+				if((Lis3mdlPlanEvaluate(request_pst, (Lis3mdlOperatingMode_t)mode_u32, sampling_aen[sampling_u32],
+										read_aen[read_u32], &candidate_st) != STATUS_OK) ||
+				   (candidate_st.feasible_u8 == 0u))
+				{
+					continue;
+				}
+
+				if((found_u8 == 0u) || Lis3mdlPlanIsBetter(&candidate_st, &best_st))
+				{
+					best_st = candidate_st;
+					found_u8 = 1u;
+				}
+			}
+		}
+	}
+
+	if(found_u8 == 0u)
+	{
+		return STATUS_ERROR;
+	}
+
+	*plan_pst = best_st;
+
+	return STATUS_OK;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file       lis3mdl_plan.h
+ *
+ * @brief      Header file for the LIS3MDL energy and bus budget planner.
+ *
+ *             Given the sample rate every sensor must deliver, a noise target and the bus
+ *             each sensor sits on, the planner evaluates every operating mode, continuous
+ *             versus single-conversion sampling and full versus FAST_READ reads against
+ *             typical datasheet figures held in constant tables. It reports the supply
+ *             current, the utilisation of the busiest bus and the worst-case latency of
+ *             each, and picks the feasible configuration drawing the least current.
+ *
+ *             Continuous sampling assumes DRDY-driven reads of every conversion
+ *             (lis3mdl_acq.h: status burst, or the 3-byte high-byte burst with FAST_READ);
+ *             single conversions assume the scheduler of lis3mdl_sched.h (one CTRL_REG3
+ *             write and one status burst per sample), which has no FAST_READ path and is
+ *             limited to DO 80 Hz without FAST_ODR, one 12.5 ms conversion per sample.
+ *
+ * @author     Aniket SAHA
+ * @date       Oct 16, 2026
+ */
+
+#ifndef LIS3MDL_PLAN_H_
+#define LIS3MDL_PLAN_H_
+
+/******************************************************************************
+ * Include Header Files
+ ******************************************************************************/
+#include "stdint.h"
+
+/******************************************************************************
+ * Macro Declarations
+ ******************************************************************************/
+#define LIS3MDL_PLAN_MAX_DEVICES    8u
+
+/******************************************************************************
+ * Types Declarations
+ ******************************************************************************/
+typedef enum
+{
+    LIS3MDL_PLAN_CONTINUOUS,   /* MD = 00 at the slowest sufficient ODR */
+    LIS3MDL_PLAN_SINGLE        /* MD = 01 per sample, power-down in between */
+} Lis3mdlPlanSampling_t;
+
+typedef enum
+{
+    LIS3MDL_PLAN_READ_FULL,    /* 16-bit samples */
+    LIS3MDL_PLAN_READ_FAST     /* FAST_READ, 8-bit high bytes only */
+} Lis3mdlPlanRead_t;
+
+typedef struct
+{
+    uint32_t rateMilliHz_u32;                   /* Samples per second each sensor must deliver, in mHz */
+    float noiseMilliGauss_f32;                  /* Largest acceptable RMS noise per axis, 0 for any */
+    Lis3mdlScale_t scale_en;                    /* Full scale in use */
+    uint32_t busHz_u32;                         /* I2C clock */
+    float maxBusUtilization_f32;                /* Largest acceptable busy fraction of any bus, 0 for 1 */
+    uint8_t deviceCount_u8;                     /* Sensors, 1 .. LIS3MDL_PLAN_MAX_DEVICES */
+    uint8_t bus_au8[LIS3MDL_PLAN_MAX_DEVICES];  /* Bus of each sensor */
+} Lis3mdlPlanRequest_st;
+
+typedef struct
+{
+    Lis3mdlSpeedConfig_st speed_st;             /* For Lis3mdlSetOutputDataRate */
+    Lis3mdlPlanSampling_t sampling_en;          /* Continuous or single conversions */
+    Lis3mdlPlanRead_t read_en;                  /* Full or FAST_READ reads */
+    uint32_t conversionMilliHz_u32;             /* Conversions per second of each sensor, in mHz */
+    float currentMicroAmp_f32;                  /* Supply current of one sensor */
+    float totalCurrentMicroAmp_f32;             /* Supply current of all sensors */
+    float noiseMilliGauss_f32;                  /* Worst-axis RMS noise, quantisation included */
+    float busUtilization_f32;                   /* Busy fraction of the busiest bus */
+    uint32_t latencyUs_u32;                     /* Worst case from conversion start to sample read */
+    uint8_t feasible_u8;                        /* Meets the rate, noise and bus limits */
+} Lis3mdlPlan_st;
+
+/******************************************************************************
+ * Extern Functions Declarations
+ ******************************************************************************/
+/**
+ * @brief Evaluate one candidate configuration.
+ *
+ * @param[in]  request_pst  Requirements and sensor placement.
+ * @param[in]  mode_en      Operating mode.
+ * @param[in]  sampling_en  Continuous or single conversions.
+ * @param[in]  read_en      Full or FAST_READ reads.
+ * @param[out] plan_pst     Figures of the candidate; feasible_u8 tells whether it fits the limits.
+ *
+ * @return STATUS_OK when the candidate can be configured at the requested rate (its
+ *         figures are filled in), STATUS_ERROR for an invalid request or when the mode
+ *         cannot reach the rate, or for single conversions with FAST_READ or above 80 Hz.
+ */
+extern status_t Lis3mdlPlanEvaluate(const Lis3mdlPlanRequest_st *request_pst, Lis3mdlOperatingMode_t mode_en,
+                                    Lis3mdlPlanSampling_t sampling_en, Lis3mdlPlanRead_t read_en,
+                                    Lis3mdlPlan_st *plan_pst);
+
+/**
+ * @brief Pick the feasible configuration drawing the least current.
+ *
+ *        Ties go to the lower bus utilisation, then the lower latency.
+ *
+ * @param[in]  request_pst  Requirements and sensor placement.
+ * @param[out] plan_pst     Chosen configuration; untouched on failure.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR when no configuration meets the request.
+ */
+extern status_t Lis3mdlPlanChoose(const Lis3mdlPlanRequest_st *request_pst, Lis3mdlPlan_st *plan_pst);
+
+#endif /* LIS3MDL_PLAN_H_ */
@@ -20,6 +20,11 @@
 
 #define LIS3MDL_CTRL_REG1   0x20
 #define LIS3MDL_CTRL_REG2   0x21
+#define LIS3MDL_CTRL_REG3   0x22
+#define LIS3MDL_CTRL_REG4   0x23
+#define LIS3MDL_CTRL_REG5   0x24
+
+#define LIS3MDL_STATUS_REG  0x27
 
 #define LIS3MDL_OUT_X_L     0x28
 #define LIS3MDL_OUT_X_H     0x29
@@ -27,8 +32,77 @@
 #define LIS3MDL_OUT_Y_H     0x2B
 #define LIS3MDL_OUT_Z_L     0x2C
 #define LIS3MDL_OUT_Z_H     0x2D
+#define LIS3MDL_TEMP_OUT_L  0x2E
+#define LIS3MDL_TEMP_OUT_H  0x2F
 
 #define LIS3MDL_INT_CFG     0x30
+#define LIS3MDL_INT_SRC     0x31
+#define LIS3MDL_INT_THS_L   0x32
+#define LIS3MDL_INT_THS_H   0x33
+
+#define LIS3MDL_WHO_AM_I_VALUE  0x3D
+
+/* CTRL_REG1 bits. */
+#define LIS3MDL_CTRL1_TEMP_EN   0x80    /* Temperature sensor enable */
+#define LIS3MDL_CTRL1_OM_MASK   0x60    /* X and Y axes operating mode */
+#define LIS3MDL_CTRL1_OM_SHIFT  5u
+#define LIS3MDL_CTRL1_DO_MASK   0x1C    /* Output data rate */
+#define LIS3MDL_CTRL1_DO_SHIFT  2u
+#define LIS3MDL_CTRL1_FAST_ODR  0x02    /* Data rates above 80 Hz */
+#define LIS3MDL_CTRL1_ST        0x01    /* Self-test enable */
+
+/* CTRL_REG2 bits. */
+#define LIS3MDL_CTRL2_FS_MASK   0x60    /* Full-scale configuration */
+#define LIS3MDL_CTRL2_FS_SHIFT  5u
+#define LIS3MDL_CTRL2_REBOOT    0x08    /* Reboot memory content */
+#define LIS3MDL_CTRL2_SOFT_RST  0x04    /* Reset configuration and user registers */
+
+/* CTRL_REG3 bits. */
+#define LIS3MDL_CTRL3_LP        0x20    /* Low-power mode */
+#define LIS3MDL_CTRL3_MD_MASK   0x03    /* Operating mode selection */
+#define LIS3MDL_CTRL3_MD_CONTINUOUS 0x00
+#define LIS3MDL_CTRL3_MD_SINGLE     0x01
+#define LIS3MDL_CTRL3_MD_POWER_DOWN 0x03
+
+/* CTRL_REG4 bits. */
+#define LIS3MDL_CTRL4_OMZ_MASK  0x0C    /* Z axis operating mode */
+#define LIS3MDL_CTRL4_OMZ_SHIFT 2u
+#define LIS3MDL_CTRL4_BLE       0x02    /* Big/little endian data selection */
+
+/* CTRL_REG5 bits. */
+#define LIS3MDL_CTRL5_FAST_READ 0x80    /* Auto-increment over the high output bytes only */
+#define LIS3MDL_CTRL5_BDU       0x40    /* Block data update */
+
+/* INT_CFG bits. */
+#define LIS3MDL_INT_CFG_XIEN    0x80    /* Interrupt on X axis */
+#define LIS3MDL_INT_CFG_YIEN    0x40    /* Interrupt on Y axis */
+#define LIS3MDL_INT_CFG_ZIEN    0x20    /* Interrupt on Z axis */
+#define LIS3MDL_INT_CFG_IEA     0x04    /* INT pin active high */
+#define LIS3MDL_INT_CFG_LIR     0x02    /* Latch interrupt request */
+#define LIS3MDL_INT_CFG_IEN     0x01    /* Interrupt enable on INT pin */
+
+/* INT_SRC bits. */
+#define LIS3MDL_INT_SRC_PTH_X   0x80    /* X above positive threshold */
+#define LIS3MDL_INT_SRC_PTH_Y   0x40
+#define LIS3MDL_INT_SRC_PTH_Z   0x20
+#define LIS3MDL_INT_SRC_NTH_X   0x10    /* X below negative threshold */
+#define LIS3MDL_INT_SRC_NTH_Y   0x08
+#define LIS3MDL_INT_SRC_NTH_Z   0x04
+#define LIS3MDL_INT_SRC_MROI    0x02    /* Internal measurement range overflow */
+#define LIS3MDL_INT_SRC_INT     0x01    /* Interrupt event occurred */
+
+/* STATUS_REG bits. */
+#define LIS3MDL_STATUS_ZYXOR    0x80    /* X, Y and Z data overrun */
+#define LIS3MDL_STATUS_ZOR      0x40
+#define LIS3MDL_STATUS_YOR      0x20
+#define LIS3MDL_STATUS_XOR      0x10
+#define LIS3MDL_STATUS_ZYXDA    0x08    /* New X, Y and Z data available */
+#define LIS3MDL_STATUS_ZDA      0x04
+#define LIS3MDL_STATUS_YDA      0x02
+#define LIS3MDL_STATUS_XDA      0x01
+
+/* Sub-address MSB: auto-increment the register address on multi-byte transfers. */
+#define LIS3MDL_AUTO_INCREMENT  0x80
 
 
 #endif /* LIS3MDL_REGISTER_H_ */
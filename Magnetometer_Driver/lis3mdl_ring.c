@@ -0,0 +1,113 @@
+/**
+ * @file       lis3mdl_ring.c
+ *
+ * @brief      Implementation file for the LIS3MDL sample ring buffer.
+ *
+ *             Indices are free-running 32-bit counters masked on access, so full and
+ *             empty are distinguished without a spare slot. Each side keeps a cached copy
+ *             of the other side's index and only reloads it when the cached value says
+ *             the ring is full (producer) or empty (consumer).
+ *
+ * @author     Aniket SAHA
+ * @date       Oct 16, 2026
+ */
+
+/******************************************************************************
+ * Include Header Files
+ ******************************************************************************/
+#include "i2c.h"
+#include "lis3mdl.h"
+#include "lis3mdl_ring.h"
+#include "stdint.h"
+
+/******************************************************************************
+ * Extern Function Definitions
+ ******************************************************************************/
+extern status_t Lis3mdlRingInit(Lis3mdlRing_st * ring_pst, Lis3mdlSample_st * storage_pst, uint32_t capacity_u32)
+{
+	if((storage_pst == (Lis3mdlSample_st *)0) || (capacity_u32 == 0u) ||
+	   ((capacity_u32 & (capacity_u32 - 1u)) != 0u))
+	{
+		return STATUS_ERROR;
+	}
+
+	atomic_init(&ring_pst->head_u32, 0u);
+	atomic_init(&ring_pst->tail_u32, 0u);
+	atomic_init(&ring_pst->pushed_u32, 0u);
+	atomic_init(&ring_pst->dropped_u32, 0u);
+	ring_pst->cachedTail_u32 = 0u;
+	ring_pst->cachedHead_u32 = 0u;
+	ring_pst->storage_pst = storage_pst;
+	ring_pst->mask_u32 = capacity_u32 - 1u;
+
+	return STATUS_OK;
+}
+
+
+extern status_t Lis3mdlRingPush(Lis3mdlRing_st * ring_pst, const Lis3mdlSample_st * sample_pst)
+{
+	uint32_t head_u32 = (uint32_t)atomic_load_explicit(&ring_pst->head_u32, memory_order_relaxed);
+
+	if((uint32_t)(head_u32 - ring_pst->cachedTail_u32) > ring_pst->mask_u32)
+	{
+		ring_pst->cachedTail_u32 = (uint32_t)atomic_load_explicit(&ring_pst->tail_u32, memory_order_acquire);
+
+		if((uint32_t)(head_u32 - ring_pst->cachedTail_u32) > ring_pst->mask_u32)
+		{
+			atomic_fetch_add_explicit(&ring_pst->dropped_u32, 1u, memory_order_relaxed);
+			return STATUS_ERROR;
+		}
+	}
+
+	ring_pst->storage_pst[head_u32 & ring_pst->mask_u32] = *sample_pst;
+	atomic_store_explicit(&ring_pst->head_u32, (uint32_t)(head_u32 + 1u), memory_order_release);
+	atomic_fetch_add_explicit(&ring_pst->pushed_u32, 1u, memory_order_relaxed);
+
+	return STATUS_OK;
+}
+
+
+extern uint32_t Lis3mdlRingPopBatch(Lis3mdlRing_st * ring_pst, Lis3mdlSample_st * samples_pst, uint32_t max_u32)
+{
+	uint32_t tail_u32 = (uint32_t)atomic_load_explicit(&ring_pst->tail_u32, memory_order_relaxed);
+	uint32_t available_u32 = (uint32_t)(ring_pst->cachedHead_u32 - tail_u32);
+	uint32_t count_u32;
+
+	if(available_u32 < max_u32)
+	{
+		ring_pst->cachedHead_u32 = (uint32_t)atomic_load_explicit(&ring_pst->head_u32, memory_order_acquire);
+		available_u32 = (uint32_t)(ring_pst->cachedHead_u32 - tail_u32);
+	}
+
+	count_u32 = (available_u32 < max_u32) ? available_u32 : max_u32;
+
+	for(uint32_t i = 0u; i < count_u32; i++)
+	{
+		samples_pst[i] = ring_pst->storage_pst[(tail_u32 + i) & ring_pst->mask_u32];
+	}
+
+	if(count_u32 != 0u)
+	{
+		atomic_store_explicit(&ring_pst->tail_u32, (uint32_t)(tail_u32 + count_u32), memory_order_release);
+	}
+
+	return count_u32;
+}
+
+
+extern uint32_t Lis3mdlRingCount(Lis3mdlRing_st * ring_pst)
+{
+	uint32_t tail_u32 = (uint32_t)atomic_load_explicit(&ring_pst->tail_u32, memory_order_acquire);
+	uint32_t head_u32 = (uint32_t)atomic_load_explicit(&ring_pst->head_u32, memory_order_acquire);
+
+	return (uint32_t)(head_u32 - tail_u32);
+}
+
+
+extern status_t Lis3mdlRingGetStats(Lis3mdlRing_st * ring_pst, Lis3mdlRingStats_st * stats_pst)
+{
+	stats_pst->pushed_u32 = (uint32_t)atomic_load_explicit(&ring_pst->pushed_u32, memory_order_relaxed);
+	stats_pst->dropped_u32 = (uint32_t)atomic_load_explicit(&ring_pst->dropped_u32, memory_order_relaxed);
+
+	return STATUS_OK;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file       lis3mdl_ring.h
+ *
+ * @brief      Header file for the LIS3MDL sample ring buffer.
+ *
+ *             Lock-free single-producer/single-consumer ring of timestamped XYZ samples.
+ *             It decouples the acquisition side (ISR or acquisition thread, the single
+ *             producer) from processing (the single consumer, which drains in batches).
+ *             Storage is supplied by the caller, so nothing is allocated after init.
+ *
+ * @note       Exactly one producer and one consumer context may use a ring at a time.
+ *
+ * @author     Aniket SAHA
+ * @date       Oct 16, 2026
+ */
+
+#ifndef LIS3MDL_RING_H_
+#define LIS3MDL_RING_H_
+
+/******************************************************************************
+ * Include Header Files
+ ******************************************************************************/
+#include <stdatomic.h>
+#include "stdint.h"
+
+/******************************************************************************
+ * Macro Declarations
+ ******************************************************************************/
+#define LIS3MDL_CACHE_LINE_SIZE     64u     /* Producer and consumer indices live on separate lines */
+
+/******************************************************************************
+ * Types Declarations
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t pushed_u32;                        /* Samples accepted by the ring */
+    uint32_t dropped_u32;                       /* Samples rejected because the ring was full */
+} Lis3mdlRingStats_st;
+
+typedef struct
+{
+    /* Producer side */
+    _Alignas(LIS3MDL_CACHE_LINE_SIZE) atomic_uint_fast32_t head_u32;    /* Next slot to write */
+    uint32_t cachedTail_u32;                    /* Producer's last view of tail_u32 */
+    atomic_uint_fast32_t pushed_u32;            /* Samples accepted */
+    atomic_uint_fast32_t dropped_u32;           /* Samples rejected on overflow */
+
+    /* Consumer side */
+    _Alignas(LIS3MDL_CACHE_LINE_SIZE) atomic_uint_fast32_t tail_u32;    /* Next slot to read */
+    uint32_t cachedHead_u32;                    /* Consumer's last view of head_u32 */
+
+    /* Read-only after init */
+    _Alignas(LIS3MDL_CACHE_LINE_SIZE) Lis3mdlSample_st *storage_pst;    /* Caller-owned slots */
+    uint32_t mask_u32;                          /* Capacity - 1 */
+} Lis3mdlRing_st;
+
+/******************************************************************************
+ * Extern Functions Declarations
+ ******************************************************************************/
+/**
+ * @brief Initialise a sample ring on caller-provided storage.
+ *
+ * @param[out] ring_pst     Ring to initialise.
+ * @param[in]  storage_pst  Array of capacity_u32 samples, owned by the caller for the ring's lifetime.
+ * @param[in]  capacity_u32 Number of slots; must be a non-zero power of two.
+ *
+ * @return Status of the operation. Returns STATUS_OK on success, STATUS_ERROR on a bad capacity.
+ */
+extern status_t Lis3mdlRingInit(Lis3mdlRing_st *ring_pst, Lis3mdlSample_st *storage_pst, uint32_t capacity_u32);
+
+/**
+ * @brief Push one sample (producer side). Safe to call from an ISR.
+ *
+ *        When the ring is full the new sample is dropped and counted; samples already
+ *        queued are never overwritten while the consumer may be reading them.
+ *
+ * @param[in,out] ring_pst Ring instance.
+ * @param[in]  sample_pst  Sample to copy into the ring.
+ *
+ * @return STATUS_OK if the sample was queued, STATUS_ERROR if the ring was full.
+ */
+extern status_t Lis3mdlRingPush(Lis3mdlRing_st *ring_pst, const Lis3mdlSample_st *sample_pst);
+
+/**
+ * @brief Drain up to max_u32 samples in FIFO order (consumer side).
+ *
+ * @param[in,out] ring_pst  Ring instance.
+ * @param[out] samples_pst  Destination array of at least max_u32 samples.
+ * @param[in]  max_u32      Maximum number of samples to copy out.
+ *
+ * @return Number of samples copied out, 0 when the ring is empty.
+ */
+extern uint32_t Lis3mdlRingPopBatch(Lis3mdlRing_st *ring_pst, Lis3mdlSample_st *samples_pst, uint32_t max_u32);
+
+/**
+ * @brief Number of samples currently queued. Exact from either side, approximate elsewhere.
+ *
+ * @param[in] ring_pst Ring instance.
+ *
+ * @return Number of queued samples.
+ */
+extern uint32_t Lis3mdlRingCount(Lis3mdlRing_st *ring_pst);
+
+/**
+ * @brief Get a snapshot of the ring's counters.
+ *
+ * @param[in]  ring_pst  Ring instance.
+ * @param[out] stats_pst Pointer to a structure to store the counters.
+ *
+ * @return Status of the operation. Returns STATUS_OK on success, otherwise an error code.
+ */
+extern status_t Lis3mdlRingGetStats(Lis3mdlRing_st *ring_pst, Lis3mdlRingStats_st *stats_pst);
+
+#endif /* LIS3MDL_RING_H_ */
@@ -0,0 +1,303 @@
+/**
+ * @file       lis3mdl_sched.c
+ *
+ * @brief      Implementation file for the LIS3MDL single-conversion sampling scheduler.
+ *
+ * @author     Aniket SAHA
+ * @date       Oct 16, 2026
+ */
+
+/******************************************************************************
+ * Include Header Files
+ ******************************************************************************/
+#include "i2c.h"
+#include "lis3mdl.h"
+#include "lis3mdl_register.h"
+#include "lis3mdl_sched.h"
+#include "stdint.h"
+
+/******************************************************************************
+ * Macro Declarations
+ ******************************************************************************/
+#define LIS3MDL_SCHED_MILLIHZ_NS		1000000000000ull	/* Period in ns times the rate in mHz */
+#define LIS3MDL_SCHED_RETRY_DIV			8u		/* Re-read a late conversion every 1/8 period */
+#define LIS3MDL_SCHED_TIMEOUT_PERIODS	4u		/* Give up on a conversion after 4 periods */
+
+/******************************************************************************
+ * Static Function Definitions
+ ******************************************************************************/
+/* Complete every request attached to a device's conversion and free their slots. */
+static void Lis3mdlSchedComplete(Lis3mdlSched_st *sched_pst, uint8_t device_u8, status_t status,
+								 const Lis3mdlSample_st *sample_pst)
+{
+	uint32_t index_u32;
+
+	sched_pst->device_ast[device_u8].converting_u8 = 0u;
+
+	for(index_u32 = 0u; index_u32 < LIS3MDL_SCHED_MAX_REQUESTS; index_u32++)
+	{
+		Lis3mdlSchedRequest_st *request_pst = &sched_pst->request_ast[index_u32];
+		Lis3mdlSchedCallback_t callback_pfn = request_pst->callback_pfn;
+
+		if((callback_pfn != (Lis3mdlSchedCallback_t)0) && (request_pst->device_u8 == device_u8) &&
+		   (request_pst->converting_u8 != 0u))
+		{
+			/* Freed first so the callback may reuse the slot */
+			request_pst->callback_pfn = (Lis3mdlSchedCallback_t)0;
+			callback_pfn(status, (status == STATUS_OK) ? sample_pst : (const Lis3mdlSample_st *)0,
+						 request_pst->context_pv);
+		}
+	}
+}
+
+
+/* Read a conversion whose time is up; retry later when ZYXDA is not set yet. */
+static status_t Lis3mdlSchedRead(Lis3mdlSched_st *sched_pst, uint8_t device_u8, uint64_t nowNs_u64)
+{
+	Lis3mdlSchedDevice_st *device_pst = &sched_pst->device_ast[device_u8];
+	Lis3mdlSample_st sample_st = { 0 };
+	uint32_t overruns_u32 = device_pst->dev_pst->stats_st.overruns_u32;
+	uint8_t newData_u8 = 0u;
+	status_t status = STATUS_DEFAULT;
+
+	status = Lis3mdlReadXYZIfReady(device_pst->dev_pst, &sample_st.xyz_st, &newData_u8);
+
+	if(status != STATUS_OK)
+	{
+		sched_pst->stats_st.errors_u32++;
+		Lis3mdlSchedComplete(sched_pst, device_u8, STATUS_ERROR, (const Lis3mdlSample_st *)0);
+	}
+	else if(newData_u8 != 0u)
+	{
+		sample_st.timestamp_u64 = device_pst->triggerNs_u64;
+		sample_st.temperature_s16 = device_pst->dev_pst->temperature_st.raw_s16;
+		sample_st.status_u8 = LIS3MDL_STATUS_ZYXDA;
+
+		if(device_pst->dev_pst->stats_st.overruns_u32 != overruns_u32)
+		{
+			sample_st.status_u8 |= LIS3MDL_STATUS_ZYXOR;
+		}
+
+		sched_pst->stats_st.samples_u32++;
+		Lis3mdlSchedComplete(sched_pst, device_u8, STATUS_OK, &sample_st);
+	}
+	else if((nowNs_u64 - device_pst->triggerNs_u64) >=
+			(LIS3MDL_SCHED_TIMEOUT_PERIODS * device_pst->conversionNs_u64))
+	{
+		sched_pst->stats_st.errors_u32++;
+		Lis3mdlSchedComplete(sched_pst, device_u8, STATUS_ERROR, (const Lis3mdlSample_st *)0);
+		status = STATUS_ERROR;
+	}
+	else
+	{
+		sched_pst->stats_st.notReady_u32++;
+		device_pst->readNs_u64 = nowNs_u64 + (device_pst->conversionNs_u64 / LIS3MDL_SCHED_RETRY_DIV) + 1u;
+	}
+
+	return status;
+}
+
+
+/*
+ * Trigger one conversion for every request of the device due by horizonNs_u64.
+ * Returns 0 when nothing was due.
+ */
+static uint8_t Lis3mdlSchedTrigger(Lis3mdlSched_st *sched_pst, uint8_t device_u8, uint64_t nowNs_u64,
+								   uint64_t horizonNs_u64, status_t *status_pen)
+{
+	Lis3mdlSchedDevice_st *device_pst = &sched_pst->device_ast[device_u8];
+	uint32_t attached_u32 = 0u;
+	uint32_t index_u32;
+
+	for(index_u32 = 0u; index_u32 < LIS3MDL_SCHED_MAX_REQUESTS; index_u32++)
+	{
+		Lis3mdlSchedRequest_st *request_pst = &sched_pst->request_ast[index_u32];
+
+		if((request_pst->callback_pfn != (Lis3mdlSchedCallback_t)0) && (request_pst->device_u8 == device_u8) &&
+		   (request_pst->dueNs_u64 <= horizonNs_u64))
+		{
+			if((nowNs_u64 > request_pst->dueNs_u64) &&
+			   ((nowNs_u64 - request_pst->dueNs_u64) > sched_pst->stats_st.maxLateNs_u64))
+			{
+				sched_pst->stats_st.maxLateNs_u64 = nowNs_u64 - request_pst->dueNs_u64;
+			}
+			request_pst->converting_u8 = 1u;
+			attached_u32++;
+		}
+	}
+
+	if(attached_u32 == 0u)
+	{
+		return 0u;
+	}
+
+	device_pst->converting_u8 = 1u;
+
+	if(Lis3mdlSetSystemMode(device_pst->dev_pst, LIS3MDL_SYSTEM_SINGLE) == STATUS_OK)
+	{
+		/* The conversion starts once the write is done, not when the poll began */
+		device_pst->triggerNs_u64 = (sched_pst->clock_pfn != (Lis3mdlSchedClock_t)0) ? sched_pst->clock_pfn() :
+									nowNs_u64;
+		device_pst->readNs_u64 = device_pst->triggerNs_u64 + device_pst->conversionNs_u64;
+		sched_pst->stats_st.triggers_u32++;
+		sched_pst->stats_st.coalesced_u32 += attached_u32 - 1u;
+	}
+	else
+	{
+		sched_pst->stats_st.errors_u32++;
+		Lis3mdlSchedComplete(sched_pst, device_u8, STATUS_ERROR, (const Lis3mdlSample_st *)0);
+		*status_pen = STATUS_ERROR;
+	}
+
+	return 1u;
+}
+
+/******************************************************************************
+ * Extern Function Definitions
+ ******************************************************************************/
+extern void Lis3mdlSchedInit(Lis3mdlSched_st * sched_pst, uint64_t batchWindowNs_u64, Lis3mdlSchedClock_t clock_pfn)
+{
+	Lis3mdlSched_st sched_st = { 0 };
+
+	sched_st.batchWindowNs_u64 = batchWindowNs_u64;
+	sched_st.clock_pfn = clock_pfn;
+	*sched_pst = sched_st;
+}
+
+
+extern status_t Lis3mdlSchedAddDevice(Lis3mdlSched_st * sched_pst, Lis3mdlDevice_st * dev_pst, uint8_t * device_pu8)
+{
+	Lis3mdlSchedDevice_st device_st = { 0 };
+	Lis3mdlSpeedConfig_st speed_st;
+	uint32_t rateMilliHz_u32;
+	uint8_t device_u8 = sched_pst->deviceCount_u8;
+	uint8_t slot_u8;
+
+	/* Single-conversion mode is specified for the DO rates only (0.625 to 80 Hz), not FAST_ODR */
+	if((device_u8 >= LIS3MDL_SCHED_MAX_DEVICES) ||
+	   (Lis3mdlGetOutputDataRate(dev_pst, &speed_st) != STATUS_OK) ||
+	   (speed_st.fastOdr_u8 != 0u) ||
+	   (Lis3mdlGetOutputDataRateMilliHz(&speed_st, &rateMilliHz_u32) != STATUS_OK) ||
+	   (Lis3mdlSetSystemMode(dev_pst, LIS3MDL_SYSTEM_POWER_DOWN) != STATUS_OK))
+	{
+		return STATUS_ERROR;
+	}
+
+	device_st.dev_pst = dev_pst;
+	device_st.conversionNs_u64 = (LIS3MDL_SCHED_MILLIHZ_NS + rateMilliHz_u32 - 1u) / rateMilliHz_u32;
+	sched_pst->device_ast[device_u8] = device_st;
+
+	/* Keep the trigger order grouped by bus: insert after the last device of the same or a lower bus */
+	for(slot_u8 = device_u8; slot_u8 > 0u; slot_u8--)
+	{
+		if(sched_pst->device_ast[sched_pst->order_au8[slot_u8 - 1u]].dev_pst->bus_u8 <= dev_pst->bus_u8)
+		{
+			break;
+		}
+		sched_pst->order_au8[slot_u8] = sched_pst->order_au8[slot_u8 - 1u];
+	}
+	sched_pst->order_au8[slot_u8] = device_u8;
+
+	sched_pst->deviceCount_u8++;
+	*device_pu8 = device_u8;
+
+	return STATUS_OK;
+}
+
+
+extern status_t Lis3mdlSchedRequest(Lis3mdlSched_st * sched_pst, uint8_t device_u8, uint64_t dueNs_u64,
+									Lis3mdlSchedCallback_t callback_pfn, void * context_pv)
+{
+	uint32_t index_u32;
+
+	if((device_u8 >= sched_pst->deviceCount_u8) || (callback_pfn == (Lis3mdlSchedCallback_t)0))
+	{
+		return STATUS_ERROR;
+	}
+
+	for(index_u32 = 0u; index_u32 < LIS3MDL_SCHED_MAX_REQUESTS; index_u32++)
+	{
+		Lis3mdlSchedRequest_st *request_pst = &sched_pst->request_ast[index_u32];
+
+		if(request_pst->callback_pfn == (Lis3mdlSchedCallback_t)0)
+		{
+			request_pst->dueNs_u64 = dueNs_u64;
+			request_pst->context_pv = context_pv;
+			request_pst->device_u8 = device_u8;
+			request_pst->converting_u8 = 0u;
+			request_pst->callback_pfn = callback_pfn;
+			return STATUS_OK;
+		}
+	}
+
+	return STATUS_ERROR;
+}
+
+
+extern status_t Lis3mdlSchedPoll(Lis3mdlSched_st * sched_pst, uint64_t nowNs_u64, uint64_t * nextNs_pu64)
+{
+	uint64_t horizonNs_u64 = nowNs_u64 + sched_pst->batchWindowNs_u64;
+	uint64_t nextNs_u64 = LIS3MDL_SCHED_NEVER;
+	uint32_t index_u32;
+	uint8_t slot_u8;
+	status_t status = STATUS_OK;
+
+	/* Reads first, so a device freed here can take its next trigger in the same pass */
+	for(slot_u8 = 0u; slot_u8 < sched_pst->deviceCount_u8; slot_u8++)
+	{
+		uint8_t device_u8 = sched_pst->order_au8[slot_u8];
+		Lis3mdlSchedDevice_st *device_pst = &sched_pst->device_ast[device_u8];
+
+		if((device_pst->converting_u8 != 0u) && (device_pst->readNs_u64 <= nowNs_u64) &&
+		   (Lis3mdlSchedRead(sched_pst, device_u8, nowNs_u64) != STATUS_OK))
+		{
+			status = STATUS_ERROR;
+		}
+	}
+
+	/* Every trigger due within the window, back to back and grouped by bus */
+	for(slot_u8 = 0u; slot_u8 < sched_pst->deviceCount_u8; slot_u8++)
+	{
+		uint8_t device_u8 = sched_pst->order_au8[slot_u8];
+
+		if(sched_pst->device_ast[device_u8].converting_u8 == 0u)
+		{
+			(void)Lis3mdlSchedTrigger(sched_pst, device_u8, nowNs_u64, horizonNs_u64, &status);
+		}
+	}
+
+	/* Next read of a conversion in flight, or next trigger of an idle device */
+	for(slot_u8 = 0u; slot_u8 < sched_pst->deviceCount_u8; slot_u8++)
+	{
+		const Lis3mdlSchedDevice_st *device_pst = &sched_pst->device_ast[sched_pst->order_au8[slot_u8]];
+
+		if((device_pst->converting_u8 != 0u) && (device_pst->readNs_u64 < nextNs_u64))
+		{
+			nextNs_u64 = device_pst->readNs_u64;
+		}
+	}
+
+	for(index_u32 = 0u; index_u32 < LIS3MDL_SCHED_MAX_REQUESTS; index_u32++)
+	{
+		const Lis3mdlSchedRequest_st *request_pst = &sched_pst->request_ast[index_u32];
+		uint64_t dueNs_u64 = request_pst->dueNs_u64;
+
+		if((request_pst->callback_pfn == (Lis3mdlSchedCallback_t)0) || (request_pst->converting_u8 != 0u))
+		{
+			continue;
+		}
+
+		/* Waiting behind a conversion in flight: served once it has been read */
+		if(sched_pst->device_ast[request_pst->device_u8].converting_u8 != 0u)
+		{
+			continue;
+		}
+
+		dueNs_u64 = (dueNs_u64 > nowNs_u64) ? dueNs_u64 : nowNs_u64;
+		nextNs_u64 = (dueNs_u64 < nextNs_u64) ? dueNs_u64 : nextNs_u64;
+	}
+
+	*nextNs_pu64 = nextNs_u64;
+
+	return status;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file       lis3mdl_sched.h
+ *
+ * @brief      Header file for the LIS3MDL single-conversion sampling scheduler.
+ *
+ *             The sensors rest in power-down. The application asks for samples at given
+ *             instants; when one is due the scheduler writes MD = 01 (one conversion),
+ *             reads the fused STATUS_REG..OUT_Z_H burst once the conversion time has
+ *             elapsed and ZYXDA is set, and hands the sample to the request's callback.
+ *             The device falls back to power-down by itself.
+ *
+ *             Lis3mdlSchedPoll is the whole engine: it is called from a timer or the
+ *             control loop with the current time and returns when it next needs to run.
+ *             All triggers due within the batch window are issued back to back, grouped
+ *             by bus, and requests for one device inside the window share a conversion, so
+ *             the buses see short bursts of traffic and stay idle in between. It is not
+ *             thread-safe: requests and polls must come from the same context.
+ *
+ * @author     Aniket SAHA
+ * @date       Oct 16, 2026
+ */
+
+#ifndef LIS3MDL_SCHED_H_
+#define LIS3MDL_SCHED_H_
+
+/******************************************************************************
+ * Include Header Files
+ ******************************************************************************/
+#include "stdint.h"
+
+/******************************************************************************
+ * Macro Declarations
+ ******************************************************************************/
+#define LIS3MDL_SCHED_MAX_DEVICES       8u
+#define LIS3MDL_SCHED_MAX_REQUESTS      32u
+#define LIS3MDL_SCHED_NEVER             UINT64_MAX      /* Nothing left to do */
+
+/******************************************************************************
+ * Types Declarations
+ ******************************************************************************/
+/*
+ * Completion callback of a request, invoked from Lis3mdlSchedPoll. On STATUS_OK the
+ * sample's timestamp is the time its conversion started; on STATUS_ERROR (bus error
+ * or no data within the timeout) sample_pst is null.
+ */
+typedef void (*Lis3mdlSchedCallback_t)(status_t status, const Lis3mdlSample_st *sample_pst, void *context_pv);
+
+/* Current time in nanoseconds, on the clock given to Lis3mdlSchedPoll. */
+typedef uint64_t (*Lis3mdlSchedClock_t)(void);
+
+typedef struct
+{
+    uint64_t dueNs_u64;                         /* Requested sampling instant */
+    Lis3mdlSchedCallback_t callback_pfn;        /* Completion callback, null when the slot is free */
+    void *context_pv;                           /* Caller's callback context */
+    uint8_t device_u8;                          /* Index returned by Lis3mdlSchedAddDevice */
+    uint8_t converting_u8;                      /* Attached to the device's conversion in flight */
+} Lis3mdlSchedRequest_st;
+
+typedef struct
+{
+    Lis3mdlDevice_st *dev_pst;                  /* Sensor instance */
+    uint64_t conversionNs_u64;                  /* Time from trigger to ZYXDA, from the ODR setting */
+    uint64_t triggerNs_u64;                     /* When the conversion in flight started */
+    uint64_t readNs_u64;                        /* When to read it next */
+    uint8_t converting_u8;                      /* A conversion is in flight */
+} Lis3mdlSchedDevice_st;
+
+typedef struct
+{
+    uint32_t triggers_u32;                      /* Conversions started */
+    uint32_t coalesced_u32;                     /* Requests served by another request's conversion */
+    uint32_t samples_u32;                       /* Conversions read back */
+    uint32_t notReady_u32;                      /* Reads that found no ZYXDA yet */
+    uint32_t errors_u32;                        /* Failed triggers or reads, and timeouts */
+    uint64_t maxLateNs_u64;                     /* Largest delay from due instant to trigger */
+} Lis3mdlSchedStats_st;
+
+typedef struct
+{
+    Lis3mdlSchedDevice_st device_ast[LIS3MDL_SCHED_MAX_DEVICES];     /* Devices, in order of addition */
+    uint8_t order_au8[LIS3MDL_SCHED_MAX_DEVICES];                   /* Device indices sorted by bus */
+    uint8_t deviceCount_u8;                                         /* Devices added */
+    Lis3mdlSchedRequest_st request_ast[LIS3MDL_SCHED_MAX_REQUESTS]; /* Request slots */
+    uint64_t batchWindowNs_u64;                 /* Triggers due this soon are issued together */
+    Lis3mdlSchedClock_t clock_pfn;              /* Time after each trigger write, or null */
+    Lis3mdlSchedStats_st stats_st;              /* Scheduler statistics */
+} Lis3mdlSched_st;
+
+/******************************************************************************
+ * Extern Functions Declarations
+ ******************************************************************************/
+/**
+ * @brief Initialise a scheduler without devices or requests.
+ *
+ *        A poll runs when the earliest request is due; the others due within the batch
+ *        window are triggered with it, up to the window early. Without a clock, a
+ *        conversion is taken to start at the poll time, which is early by the bus time
+ *        of the triggers issued before it, so its first read may find no data yet.
+ *
+ * @param[out] sched_pst          Scheduler to initialise.
+ * @param[in]  batchWindowNs_u64  Batch window; 0 triggers every request on its own instant.
+ * @param[in]  clock_pfn          Clock read after each trigger write to time the conversion
+ *                                start, or null to use the poll time.
+ */
+extern void Lis3mdlSchedInit(Lis3mdlSched_st *sched_pst, uint64_t batchWindowNs_u64, Lis3mdlSchedClock_t clock_pfn);
+
+/**
+ * @brief Hand a sensor to the scheduler and power it down.
+ *
+ *        The conversion time is taken from the sensor's current speed configuration
+ *        (Lis3mdlSetOutputDataRate): one output data period. Single-conversion mode is
+ *        only specified at the DO rates (0.625 to 80 Hz), so FAST_ODR must be off. Change
+ *        the configuration before adding the device, not after.
+ *
+ * @param[in,out] sched_pst  Scheduler.
+ * @param[in]  dev_pst       Initialised sensor instance, used only by the scheduler from now on.
+ * @param[out] device_pu8    Index to use in Lis3mdlSchedRequest.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR when the scheduler is full, FAST_ODR is set
+ *         or the bus failed.
+ */
+extern status_t Lis3mdlSchedAddDevice(Lis3mdlSched_st *sched_pst, Lis3mdlDevice_st *dev_pst, uint8_t *device_pu8);
+
+/**
+ * @brief Ask for a sample of one sensor at a given instant.
+ *
+ *        A due instant already passed is served by the next poll.
+ *
+ * @param[in,out] sched_pst  Scheduler.
+ * @param[in]  device_u8     Index from Lis3mdlSchedAddDevice.
+ * @param[in]  dueNs_u64     Sampling instant, on the clock given to Lis3mdlSchedPoll.
+ * @param[in]  callback_pfn  Completion callback.
+ * @param[in]  context_pv    Opaque pointer handed back to the callback.
+ *
+ * @return STATUS_OK if queued, STATUS_ERROR for an unknown device, a null callback or
+ *         when all LIS3MDL_SCHED_MAX_REQUESTS slots are taken.
+ */
+extern status_t Lis3mdlSchedRequest(Lis3mdlSched_st *sched_pst, uint8_t device_u8, uint64_t dueNs_u64,
+                                    Lis3mdlSchedCallback_t callback_pfn, void *context_pv);
+
+/**
+ * @brief Read finished conversions, then trigger the ones due.
+ *
+ *        Callbacks run from here and may queue new requests.
+ *
+ * @param[in,out] sched_pst   Scheduler.
+ * @param[in]  nowNs_u64      Current time in nanoseconds.
+ * @param[out] nextNs_pu64    When to poll next, LIS3MDL_SCHED_NEVER when idle.
+ *
+ * @return STATUS_OK when every bus operation succeeded, STATUS_ERROR otherwise (the
+ *         affected requests were completed with STATUS_ERROR).
+ */
+extern status_t Lis3mdlSchedPoll(Lis3mdlSched_st *sched_pst, uint64_t nowNs_u64, uint64_t *nextNs_pu64);
+
+#endif /* LIS3MDL_SCHED_H_ */
@@ -0,0 +1,250 @@
+/**
+ * @file       lis3mdl_tcomp.c
+ *
+ * @brief      Implementation file for the LIS3MDL temperature compensation stage.
+ *
+ * @author     Aniket SAHA
+ * @date       Oct 16, 2026
+ */
+
+/******************************************************************************
+ * Include Header Files
+ ******************************************************************************/
+#include "i2c.h"
+#include "lis3mdl.h"
+#include "lis3mdl_tcomp.h"
+#include "stdint.h"
+
+#if defined(__SSE2__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/******************************************************************************
+ * Macro Declarations
+ ******************************************************************************/
+#define LIS3MDL_TCOMP_AXES		3u
+
+/******************************************************************************
+ * Static Function Definitions
+ ******************************************************************************/
+/* Fold (m - o) * g into m * g + b, the form every kernel evaluates. */
+static void Lis3mdlTcompFold(const Lis3mdlTcompPoint_st *point_pst, float lsbScale_f32, float *gain_pf32,
+							 float *bias_pf32)
+{
+	uint32_t axis_u32;
+
+	for(axis_u32 = 0u; axis_u32 < LIS3MDL_TCOMP_AXES; axis_u32++)
+	{
+		gain_pf32[axis_u32] = point_pst->gain_af32[axis_u32] * lsbScale_f32;
+		bias_pf32[axis_u32] = -(point_pst->offset_af32[axis_u32] * point_pst->gain_af32[axis_u32]);
+	}
+}
+
+
+static void Lis3mdlTcompApplyScalar(const float *gain_pf32, const float *bias_pf32, const float *field_pf32,
+									float *out_pf32, uint32_t count_u32)
+{
+	uint32_t index_u32;
+
+	for(index_u32 = 0u; index_u32 < (LIS3MDL_TCOMP_AXES * count_u32); index_u32 += LIS3MDL_TCOMP_AXES)
+	{
+		out_pf32[index_u32 + 0u] = (field_pf32[index_u32 + 0u] * gain_pf32[0]) + bias_pf32[0];
+		out_pf32[index_u32 + 1u] = (field_pf32[index_u32 + 1u] * gain_pf32[1]) + bias_pf32[1];
+		out_pf32[index_u32 + 2u] = (field_pf32[index_u32 + 2u] * gain_pf32[2]) + bias_pf32[2];
+	}
+}
+
+
+#if defined(__SSE2__) || defined(__ARM_NEON)
+
+/*
+ * Four samples are three vectors whose lanes cycle through the axes as XYZX, YZXY and
+ * ZXYZ, so three rotated copies of the coefficients cover them without any shuffle.
+ */
+static uint32_t Lis3mdlTcompApplyKernel(const float *gain_pf32, const float *bias_pf32, const float *field_pf32,
+										float *out_pf32, uint32_t count_u32)
+{
+	float gain_af32[12];
+	float bias_af32[12];
+	uint32_t index_u32;
+
+	for(index_u32 = 0u; index_u32 < 12u; index_u32++)
+	{
+		gain_af32[index_u32] = gain_pf32[index_u32 % LIS3MDL_TCOMP_AXES];
+		bias_af32[index_u32] = bias_pf32[index_u32 % LIS3MDL_TCOMP_AXES];
+	}
+
+#if defined(__SSE2__)
+	{
+		__m128 g0_v = _mm_loadu_ps(&gain_af32[0]);
+		__m128 g1_v = _mm_loadu_ps(&gain_af32[4]);
+		__m128 g2_v = _mm_loadu_ps(&gain_af32[8]);
+		__m128 b0_v = _mm_loadu_ps(&bias_af32[0]);
+		__m128 b1_v = _mm_loadu_ps(&bias_af32[4]);
+		__m128 b2_v = _mm_loadu_ps(&bias_af32[8]);
+
+		for(index_u32 = 0u; (index_u32 + 4u) <= count_u32; index_u32 += 4u)
+		{
+			const float *in_pf32 = &field_pf32[LIS3MDL_TCOMP_AXES * index_u32];
+			float *dst_pf32 = &out_pf32[LIS3MDL_TCOMP_AXES * index_u32];
+
+			_mm_storeu_ps(&dst_pf32[0], _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&in_pf32[0]), g0_v), b0_v));
+			_mm_storeu_ps(&dst_pf32[4], _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&in_pf32[4]), g1_v), b1_v));
+			_mm_storeu_ps(&dst_pf32[8], _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&in_pf32[8]), g2_v), b2_v));
+		}
+	}
+#else
+	{
+		float32x4_t g0_v = vld1q_f32(&gain_af32[0]);
+		float32x4_t g1_v = vld1q_f32(&gain_af32[4]);
+		float32x4_t g2_v = vld1q_f32(&gain_af32[8]);
+		float32x4_t b0_v = vld1q_f32(&bias_af32[0]);
+		float32x4_t b1_v = vld1q_f32(&bias_af32[4]);
+		float32x4_t b2_v = vld1q_f32(&bias_af32[8]);
+
+		for(index_u32 = 0u; (index_u32 + 4u) <= count_u32; index_u32 += 4u)
+		{
+			const float *in_pf32 = &field_pf32[LIS3MDL_TCOMP_AXES * index_u32];
+			float *dst_pf32 = &out_pf32[LIS3MDL_TCOMP_AXES * index_u32];
+
+			vst1q_f32(&dst_pf32[0], vaddq_f32(vmulq_f32(vld1q_f32(&in_pf32[0]), g0_v), b0_v));
+			vst1q_f32(&dst_pf32[4], vaddq_f32(vmulq_f32(vld1q_f32(&in_pf32[4]), g1_v), b1_v));
+			vst1q_f32(&dst_pf32[8], vaddq_f32(vmulq_f32(vld1q_f32(&in_pf32[8]), g2_v), b2_v));
+		}
+	}
+#endif
+
+	return index_u32;
+}
+
+#else
+
+static uint32_t Lis3mdlTcompApplyKernel(const float *gain_pf32, const float *bias_pf32, const float *field_pf32,
+										float *out_pf32, uint32_t count_u32)
+{
+	(void)gain_pf32;
+	(void)bias_pf32;
+	(void)field_pf32;
+	(void)out_pf32;
+	(void)count_u32;
+
+	return 0u;
+}
+
+#endif
+
+/******************************************************************************
+ * Extern Function Definitions
+ ******************************************************************************/
+extern status_t Lis3mdlTcompLookup(const Lis3mdlTcompTable_st * table_pst, int16_t temperature_s16,
+								   Lis3mdlTcompPoint_st * point_pst)
+{
+	const Lis3mdlTcompPoint_st *low_pst;
+	const Lis3mdlTcompPoint_st *high_pst;
+	int32_t delta_s32;
+	uint32_t index_u32;
+	float frac_f32;
+	uint32_t axis_u32;
+
+	if((table_pst->count_u16 == 0u) || (table_pst->count_u16 > LIS3MDL_TCOMP_MAX_POINTS) ||
+	   (table_pst->tempStep_u16 == 0u) || (temperature_s16 == LIS3MDL_TEMP_INVALID))
+	{
+		return STATUS_ERROR;
+	}
+
+	delta_s32 = (int32_t)temperature_s16 - (int32_t)table_pst->tempFirst_s16;
+
+	/* Clamped to the table ends */
+	if(delta_s32 <= 0)
+	{
+		*point_pst = table_pst->point_ast[0];
+		return STATUS_OK;
+	}
+
+	index_u32 = (uint32_t)delta_s32 / table_pst->tempStep_u16;
+	if(index_u32 >= (uint32_t)(table_pst->count_u16 - 1u))
+	{
+		*point_pst = table_pst->point_ast[table_pst->count_u16 - 1u];
+		return STATUS_OK;
+	}
+
+	low_pst = &table_pst->point_ast[index_u32];
+	high_pst = &table_pst->point_ast[index_u32 + 1u];
+	frac_f32 = (float)((uint32_t)delta_s32 - (index_u32 * table_pst->tempStep_u16)) / (float)table_pst->tempStep_u16;
+
+	for(axis_u32 = 0u; axis_u32 < LIS3MDL_TCOMP_AXES; axis_u32++)
+	{
+		point_pst->offset_af32[axis_u32] = low_pst->offset_af32[axis_u32] +
+										   (frac_f32 * (high_pst->offset_af32[axis_u32] - low_pst->offset_af32[axis_u32]));
+		point_pst->gain_af32[axis_u32] = low_pst->gain_af32[axis_u32] +
+										 (frac_f32 * (high_pst->gain_af32[axis_u32] - low_pst->gain_af32[axis_u32]));
+	}
+
+	return STATUS_OK;
+}
+
+
+extern status_t Lis3mdlTcompApply(const Lis3mdlTcompTable_st * table_pst, int16_t temperature_s16,
+								  const float * field_pf32, float * out_pf32, uint32_t count_u32)
+{
+	Lis3mdlTcompPoint_st point_st;
+	float gain_af32[LIS3MDL_TCOMP_AXES];
+	float bias_af32[LIS3MDL_TCOMP_AXES];
+	uint32_t done_u32;
+
+	if(Lis3mdlTcompLookup(table_pst, temperature_s16, &point_st) != STATUS_OK)
+	{
+		return STATUS_ERROR;
+	}
+
+	Lis3mdlTcompFold(&point_st, 1.0f, gain_af32, bias_af32);
+
+	done_u32 = Lis3mdlTcompApplyKernel(gain_af32, bias_af32, field_pf32, out_pf32, count_u32);
+	Lis3mdlTcompApplyScalar(gain_af32, bias_af32, &field_pf32[LIS3MDL_TCOMP_AXES * done_u32],
+							&out_pf32[LIS3MDL_TCOMP_AXES * done_u32], count_u32 - done_u32);
+
+	return STATUS_OK;
+}
+
+
+extern status_t Lis3mdlTcompApplySamples(const Lis3mdlTcompTable_st * table_pst, Lis3mdlScale_t scale_en,
+										 const Lis3mdlSample_st * samples_pst, uint32_t count_u32,
+										 float * field_pf32)
+{
+	Lis3mdlTcompPoint_st point_st;
+	float gain_af32[LIS3MDL_TCOMP_AXES];
+	float bias_af32[LIS3MDL_TCOMP_AXES];
+	int32_t temperature_s32 = INT32_MIN;	/* No coefficients yet */
+	uint16_t lsbPerGauss_u16;
+	uint32_t index_u32;
+
+	if(Lis3mdlGetSensitivity(scale_en, &lsbPerGauss_u16) != STATUS_OK)
+	{
+		return STATUS_ERROR;
+	}
+
+	for(index_u32 = 0u; index_u32 < count_u32; index_u32++)
+	{
+		const Lis3mdlSample_st *sample_pst = &samples_pst[index_u32];
+		float *out_pf32 = &field_pf32[LIS3MDL_TCOMP_AXES * index_u32];
+
+		/* Temperature moves slowly: runs of equal readings share one lookup */
+		if((int32_t)sample_pst->temperature_s16 != temperature_s32)
+		{
+			if(Lis3mdlTcompLookup(table_pst, sample_pst->temperature_s16, &point_st) != STATUS_OK)
+			{
+				return STATUS_ERROR;
+			}
+			Lis3mdlTcompFold(&point_st, 1.0f / (float)lsbPerGauss_u16, gain_af32, bias_af32);
+			temperature_s32 = sample_pst->temperature_s16;
+		}
+
+		out_pf32[0] = ((float)sample_pst->xyz_st.x_s16 * gain_af32[0]) + bias_af32[0];
+		out_pf32[1] = ((float)sample_pst->xyz_st.y_s16 * gain_af32[1]) + bias_af32[1];
+		out_pf32[2] = ((float)sample_pst->xyz_st.z_s16 * gain_af32[2]) + bias_af32[2];
+	}
+
+	return STATUS_OK;
+}
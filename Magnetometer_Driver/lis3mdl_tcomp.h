@@ -0,0 +1,97 @@
+/**
+ * @file       lis3mdl_tcomp.h
+ *
+ * @brief      Header file for the LIS3MDL temperature compensation stage.
+ *
+ *             Per-axis offset and gain corrections are tabulated at evenly spaced
+ *             TEMP_OUT values (built offline by tools/lis3mdl_tcomp_build from thermal
+ *             chamber captures) and linearly interpolated at the sample temperature.
+ *             A corrected axis is (m - offset(T)) * gain(T). The table lookup only runs
+ *             when the temperature changes; the per-sample work is one multiply-add per
+ *             axis, vectorized over batches (SSE2 or NEON, scalar otherwise).
+ *
+ * @author     Aniket SAHA
+ * @date       Oct 16, 2026
+ */
+
+#ifndef LIS3MDL_TCOMP_H_
+#define LIS3MDL_TCOMP_H_
+
+/******************************************************************************
+ * Include Header Files
+ ******************************************************************************/
+#include "stdint.h"
+
+/******************************************************************************
+ * Macro Declarations
+ ******************************************************************************/
+#define LIS3MDL_TCOMP_MAX_POINTS    32u     /* e.g. -40 to +85 degC in 5 degC steps needs 26 */
+
+/******************************************************************************
+ * Types Declarations
+ ******************************************************************************/
+typedef struct
+{
+    float offset_af32[3];                       /* X, Y, Z offset in gauss, removed first */
+    float gain_af32[3];                         /* X, Y, Z gain applied after the offset */
+} Lis3mdlTcompPoint_st;
+
+typedef struct
+{
+    int16_t tempFirst_s16;                      /* TEMP_OUT of point 0 */
+    uint16_t tempStep_u16;                      /* TEMP_OUT between consecutive points, at least 1 */
+    uint16_t count_u16;                         /* Points in use, 1 .. LIS3MDL_TCOMP_MAX_POINTS */
+    Lis3mdlTcompPoint_st point_ast[LIS3MDL_TCOMP_MAX_POINTS];   /* Corrections by temperature */
+} Lis3mdlTcompTable_st;
+
+/******************************************************************************
+ * Extern Functions Declarations
+ ******************************************************************************/
+/**
+ * @brief Interpolate the correction at a temperature.
+ *
+ *        Temperatures outside the table use the first or last point.
+ *
+ * @param[in]  table_pst        Compensation table.
+ * @param[in]  temperature_s16  TEMP_OUT value (Lis3mdlGetTemperature, Lis3mdlSample_st).
+ * @param[out] point_pst        Interpolated offset and gain.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR for an invalid table or LIS3MDL_TEMP_INVALID.
+ */
+extern status_t Lis3mdlTcompLookup(const Lis3mdlTcompTable_st *table_pst, int16_t temperature_s16,
+                                   Lis3mdlTcompPoint_st *point_pst);
+
+/**
+ * @brief Compensate a batch of samples taken at one temperature.
+ *
+ * @param[in]  table_pst        Compensation table.
+ * @param[in]  temperature_s16  TEMP_OUT value for the whole batch.
+ * @param[in]  field_pf32       3 * count_u32 floats, X, Y, Z per sample, in gauss.
+ * @param[out] out_pf32         3 * count_u32 corrected floats; may be the same buffer as field_pf32.
+ * @param[in]  count_u32        Number of samples.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR as Lis3mdlTcompLookup (out_pf32 untouched).
+ */
+extern status_t Lis3mdlTcompApply(const Lis3mdlTcompTable_st *table_pst, int16_t temperature_s16,
+                                  const float *field_pf32, float *out_pf32, uint32_t count_u32);
+
+/**
+ * @brief Convert and compensate acquisition samples, each at its own temperature.
+ *
+ *        The gauss conversion is folded into the gain, so every axis costs a single
+ *        multiply-add; the table is only consulted when the temperature changes.
+ *
+ * @param[in]  table_pst    Compensation table.
+ * @param[in]  scale_en     Full-scale setting the samples were taken with.
+ * @param[in]  samples_pst  Samples, e.g. from Lis3mdlAcqReadSamples with TEMP_EN set.
+ * @param[in]  count_u32    Number of samples.
+ * @param[out] field_pf32   3 * count_u32 floats, X, Y, Z per sample, in gauss.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR for an invalid table or scale, or at the
+ *         first sample without a temperature (the following outputs are not written).
+ */
+extern status_t Lis3mdlTcompApplySamples(const Lis3mdlTcompTable_st *table_pst, Lis3mdlScale_t scale_en,
+                                         const Lis3mdlSample_st *samples_pst, uint32_t count_u32,
+                                         float *field_pf32);
+
+#endif /* LIS3MDL_TCOMP_H_ */
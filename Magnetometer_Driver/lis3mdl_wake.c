@@ -0,0 +1,200 @@
+/**
+ * @file       lis3mdl_wake.c
+ *
+ * @brief      Implementation file for the LIS3MDL wake-on-field-change event mode.
+ *
+ * @author     Aniket SAHA
+ * @date       Oct 16, 2026
+ */
+
+/******************************************************************************
+ * Include Header Files
+ ******************************************************************************/
+#include "i2c.h"
+#include "lis3mdl.h"
+#include "lis3mdl_register.h"
+#include "lis3mdl_wake.h"
+#include "stdint.h"
+
+/******************************************************************************
+ * Static Function Definitions
+ ******************************************************************************/
+/* Earliest time the deferred read may run. */
+static uint64_t Lis3mdlWakeNext(const Lis3mdlWake_st *wake_pst)
+{
+	if(wake_pst->pendingEdges_u16 == 0u)
+	{
+		return LIS3MDL_WAKE_NEVER;
+	}
+
+	return wake_pst->lastReadNs_u64 + wake_pst->debounceNs_u64;
+}
+
+
+/* One fused burst for the pending edges; queue its event. */
+static status_t Lis3mdlWakeRead(Lis3mdlWake_st *wake_pst, uint64_t nowNs_u64)
+{
+	Lis3mdlWakeEvent_st *event_pst;
+	Lis3mdlSample_st sample_st;
+	uint8_t intSrc_u8;
+	uint16_t edges_u16 = wake_pst->pendingEdges_u16;
+	status_t status = STATUS_DEFAULT;
+
+	wake_pst->pendingEdges_u16 = 0u;
+	wake_pst->lastReadNs_u64 = nowNs_u64;
+	wake_pst->readValid_u8 = 1u;
+	wake_pst->stats_st.reads_u32++;
+
+	status = Lis3mdlReadInterruptSample(wake_pst->dev_pst, &sample_st, &intSrc_u8);
+
+	if(status != STATUS_OK)
+	{
+		wake_pst->stats_st.errors_u32++;
+		return status;
+	}
+
+	/* Without a source the field went back below the threshold before the read */
+	if((intSrc_u8 & LIS3MDL_INT_SRC_INT) == 0u)
+	{
+		wake_pst->stats_st.spurious_u32++;
+		return STATUS_OK;
+	}
+
+	if(wake_pst->count_u8 >= LIS3MDL_WAKE_QUEUE_LEN)
+	{
+		wake_pst->stats_st.dropped_u32++;
+		return STATUS_OK;
+	}
+
+	event_pst = &wake_pst->queue_ast[(wake_pst->head_u8 + wake_pst->count_u8) % LIS3MDL_WAKE_QUEUE_LEN];
+	event_pst->sample_st = sample_st;
+	event_pst->sample_st.timestamp_u64 = wake_pst->edgeNs_u64;
+	event_pst->intSrc_u8 = intSrc_u8;
+	event_pst->edges_u16 = edges_u16;
+	wake_pst->count_u8++;
+	wake_pst->stats_st.events_u32++;
+
+	return STATUS_OK;
+}
+
+/******************************************************************************
+ * Extern Function Definitions
+ ******************************************************************************/
+extern void Lis3mdlWakeInit(Lis3mdlWake_st * wake_pst, Lis3mdlDevice_st * dev_pst, uint64_t debounceNs_u64)
+{
+	Lis3mdlWake_st wakeInit_st = { 0 };
+
+	wakeInit_st.dev_pst = dev_pst;
+	wakeInit_st.debounceNs_u64 = debounceNs_u64;
+	*wake_pst = wakeInit_st;
+}
+
+
+extern status_t Lis3mdlWakeStart(Lis3mdlWake_st * wake_pst, uint8_t axes_u8, uint16_t threshold_u16)
+{
+	Lis3mdlSample_st sample_st;
+	uint8_t intSrc_u8;
+	status_t status = STATUS_DEFAULT;
+
+	if(axes_u8 == 0u)
+	{
+		return STATUS_ERROR;
+	}
+
+	status = Lis3mdlSetInterruptThreshold(wake_pst->dev_pst, threshold_u16);
+
+	if(status == STATUS_OK)
+	{
+		status = Lis3mdlSetInterruptSources(wake_pst->dev_pst, axes_u8, 1u);
+	}
+
+	if(status == STATUS_OK)
+	{
+		status = Lis3mdlToggleInterrupt(wake_pst->dev_pst, LIS3MDL_INTR_EN);
+	}
+
+	if(status == STATUS_OK)
+	{
+		status = Lis3mdlSetSystemMode(wake_pst->dev_pst, LIS3MDL_SYSTEM_CONTINUOUS);
+	}
+
+	if(status == STATUS_OK)
+	{
+		status = Lis3mdlReadInterruptSample(wake_pst->dev_pst, &sample_st, &intSrc_u8);
+	}
+
+	wake_pst->pendingEdges_u16 = 0u;
+	wake_pst->readValid_u8 = 0u;
+
+	return status;
+}
+
+
+extern status_t Lis3mdlWakeStop(Lis3mdlWake_st * wake_pst)
+{
+	wake_pst->pendingEdges_u16 = 0u;
+
+	return Lis3mdlToggleInterrupt(wake_pst->dev_pst, LIS3MDL_INTR_DIS);
+}
+
+
+extern status_t Lis3mdlWakeHandleEdge(Lis3mdlWake_st * wake_pst, uint64_t nowNs_u64, uint64_t * nextNs_pu64)
+{
+	status_t status = STATUS_OK;
+
+	wake_pst->stats_st.edges_u32++;
+
+	if(wake_pst->pendingEdges_u16 == 0u)
+	{
+		wake_pst->edgeNs_u64 = nowNs_u64;
+	}
+
+	if(wake_pst->pendingEdges_u16 < UINT16_MAX)
+	{
+		wake_pst->pendingEdges_u16++;
+	}
+
+	if((wake_pst->readValid_u8 == 0u) ||
+	   ((nowNs_u64 - wake_pst->lastReadNs_u64) >= wake_pst->debounceNs_u64))
+	{
+		status = Lis3mdlWakeRead(wake_pst, nowNs_u64);
+	}
+	else
+	{
+		wake_pst->stats_st.debounced_u32++;
+	}
+
+	*nextNs_pu64 = Lis3mdlWakeNext(wake_pst);
+
+	return status;
+}
+
+
+extern status_t Lis3mdlWakePoll(Lis3mdlWake_st * wake_pst, uint64_t nowNs_u64, uint64_t * nextNs_pu64)
+{
+	status_t status = STATUS_OK;
+
+	if((wake_pst->pendingEdges_u16 != 0u) && (nowNs_u64 >= Lis3mdlWakeNext(wake_pst)))
+	{
+		status = Lis3mdlWakeRead(wake_pst, nowNs_u64);
+	}
+
+	*nextNs_pu64 = Lis3mdlWakeNext(wake_pst);
+
+	return status;
+}
+
+
+extern status_t Lis3mdlWakePop(Lis3mdlWake_st * wake_pst, Lis3mdlWakeEvent_st * event_pst)
+{
+	if(wake_pst->count_u8 == 0u)
+	{
+		return STATUS_ERROR;
+	}
+
+	*event_pst = wake_pst->queue_ast[wake_pst->head_u8];
+	wake_pst->head_u8 = (uint8_t)((wake_pst->head_u8 + 1u) % LIS3MDL_WAKE_QUEUE_LEN);
+	wake_pst->count_u8--;
+
+	return STATUS_OK;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file       lis3mdl_wake.h
+ *
+ * @brief      Header file for the LIS3MDL wake-on-field-change event mode.
+ *
+ *             The sensor converts continuously and compares every conversion against
+ *             INT_THS itself; the host stays off the bus until the INT pin fires. Each
+ *             edge costs one fused STATUS_REG..INT_SRC burst (Lis3mdlReadInterruptSample)
+ *             that both fetches the sample and releases the latched request, and the
+ *             result is queued as an event for the application.
+ *
+ *             Edges are debounced: reads are spaced at least the debounce time apart, and
+ *             an edge arriving sooner is served by a single deferred read at the end of
+ *             the interval. The request is latched (LIR), so INT_SRC still reports every
+ *             source seen in between and a field hovering on the threshold yields one
+ *             event per interval instead of one per conversion.
+ *
+ *             Lis3mdlWakeHandleEdge is called for each INT edge from a context that may
+ *             use the bus (a deferred handler on target), and Lis3mdlWakePoll when
+ *             Lis3mdlWakeHandleEdge or the previous poll asked for it. It is not
+ *             thread-safe: edges, polls and pops must come from the same context.
+ *
+ * @author     Aniket SAHA
+ * @date       Oct 16, 2026
+ */
+
+#ifndef LIS3MDL_WAKE_H_
+#define LIS3MDL_WAKE_H_
+
+/******************************************************************************
+ * Include Header Files
+ ******************************************************************************/
+#include "stdint.h"
+
+/******************************************************************************
+ * Macro Declarations
+ ******************************************************************************/
+#define LIS3MDL_WAKE_QUEUE_LEN      16u
+#define LIS3MDL_WAKE_NEVER          UINT64_MAX      /* No deferred read pending */
+
+/******************************************************************************
+ * Types Declarations
+ ******************************************************************************/
+typedef struct
+{
+    Lis3mdlSample_st sample_st;                 /* Sample read with INT_SRC; timestamp of the first edge */
+    uint8_t intSrc_u8;                          /* INT_SRC: every source latched since the previous read */
+    uint16_t edges_u16;                         /* INT edges served by this read */
+} Lis3mdlWakeEvent_st;
+
+typedef struct
+{
+    uint32_t edges_u32;                         /* INT edges handled */
+    uint32_t debounced_u32;                     /* Edges left to a deferred read */
+    uint32_t reads_u32;                         /* Fused INT_SRC and sample bursts */
+    uint32_t events_u32;                        /* Events queued */
+    uint32_t spurious_u32;                      /* Reads that found no interrupt source */
+    uint32_t dropped_u32;                       /* Events lost to a full queue */
+    uint32_t errors_u32;                        /* Failed reads */
+} Lis3mdlWakeStats_st;
+
+typedef struct
+{
+    Lis3mdlDevice_st *dev_pst;                  /* Sensor watched */
+    uint64_t debounceNs_u64;                    /* Shortest time between two reads */
+    uint64_t lastReadNs_u64;                    /* Time of the latest read */
+    uint64_t edgeNs_u64;                        /* First edge waiting for the deferred read */
+    uint16_t pendingEdges_u16;                  /* Edges waiting for the deferred read, 0 when none */
+    uint8_t readValid_u8;                       /* lastReadNs_u64 holds a read */
+    Lis3mdlWakeEvent_st queue_ast[LIS3MDL_WAKE_QUEUE_LEN];     /* Events not yet popped */
+    uint8_t head_u8;                            /* Oldest queued event */
+    uint8_t count_u8;                           /* Queued events */
+    Lis3mdlWakeStats_st stats_st;               /* Event mode statistics */
+} Lis3mdlWake_st;
+
+/******************************************************************************
+ * Extern Functions Declarations
+ ******************************************************************************/
+/**
+ * @brief Initialise the event mode of one sensor, with nothing queued.
+ *
+ * @param[out] wake_pst        Event mode instance to initialise.
+ * @param[in]  dev_pst         Initialised sensor instance; its INT pin must be routed to Lis3mdlWakeHandleEdge.
+ * @param[in]  debounceNs_u64  Shortest time between two reads; 0 reads on every edge.
+ */
+extern void Lis3mdlWakeInit(Lis3mdlWake_st *wake_pst, Lis3mdlDevice_st *dev_pst, uint64_t debounceNs_u64);
+
+/**
+ * @brief Arm the threshold interrupt and start converting.
+ *
+ *        Sets INT_THS, the watched axes with a latched request, IEN and continuous
+ *        mode at the sensor's current speed configuration, whose ODR bounds how fast a
+ *        change is noticed, then reads INT_SRC once to release a stale request. Choose
+ *        the slowest ODR and lowest-power mode that catch the changes of interest.
+ *
+ * @param[in,out] wake_pst  Event mode instance.
+ * @param[in]  axes_u8      Any non-empty combination of LIS3MDL_INT_CFG_XIEN, _YIEN and _ZIEN.
+ * @param[in]  threshold_u16 Threshold in LSB of the 16-bit output, at most LIS3MDL_INT_THS_MAX.
+ *
+ * @return STATUS_OK on success, STATUS_ERROR for no axes, an out-of-range threshold or a bus error.
+ */
+extern status_t Lis3mdlWakeStart(Lis3mdlWake_st *wake_pst, uint8_t axes_u8, uint16_t threshold_u16);
+
+/**
+ * @brief Disarm the threshold interrupt and forget a pending deferred read.
+ *
+ *        The sensor keeps its system mode; queued events stay available.
+ *
+ * @param[in,out] wake_pst Event mode instance.
+ *
+ * @return Status of the operation. Returns STATUS_OK on success, otherwise an error code.
+ */
+extern status_t Lis3mdlWakeStop(Lis3mdlWake_st *wake_pst);
+
+/**
+ * @brief Service one INT edge.
+ *
+ *        Reads and queues at once when the previous read is at least the debounce time
+ *        old; otherwise the edge waits for the deferred read of Lis3mdlWakePoll.
+ *
+ * @param[in,out] wake_pst  Event mode instance.
+ * @param[in]  nowNs_u64    Time of the edge in nanoseconds.
+ * @param[out] nextNs_pu64  When to call Lis3mdlWakePoll, LIS3MDL_WAKE_NEVER when not needed.
+ *
+ * @return STATUS_OK unless a read failed.
+ */
+extern status_t Lis3mdlWakeHandleEdge(Lis3mdlWake_st *wake_pst, uint64_t nowNs_u64, uint64_t *nextNs_pu64);
+
+/**
+ * @brief Perform the deferred read once the debounce time has passed.
+ *
+ * @param[in,out] wake_pst  Event mode instance.
+ * @param[in]  nowNs_u64    Current time in nanoseconds.
+ * @param[out] nextNs_pu64  When to poll next, LIS3MDL_WAKE_NEVER when nothing is pending.
+ *
+ * @return STATUS_OK unless a read failed.
+ */
+extern status_t Lis3mdlWakePoll(Lis3mdlWake_st *wake_pst, uint64_t nowNs_u64, uint64_t *nextNs_pu64);
+
+/**
+ * @brief Take the oldest queued event.
+ *
+ * @param[in,out] wake_pst  Event mode instance.
+ * @param[out] event_pst    Oldest event.
+ *
+ * @return STATUS_OK when an event was stored, STATUS_ERROR when the queue is empty.
+ */
+extern status_t Lis3mdlWakePop(Lis3mdlWake_st *wake_pst, Lis3mdlWakeEvent_st *event_pst);
+
+#endif /* LIS3MDL_WAKE_H_ */
@@ -0,0 +1,224 @@
+/*
+ * LIS3MDL interrupt-driven acquisition benchmark.
+ *
+ * One simulated sensor converts at 1000 Hz FAST_ODR with every axis stepping by a known
+ * ramp per conversion. Its DRDY pin is wired through lis3mdl_sim_set_drdy_callback to
+ * Lis3mdlAcqRaiseEdge, so the acquisition thread (Lis3mdlAcqStart) services every edge
+ * with one fused burst into the sample ring, while a reader thread drains the ring in
+ * blocks with Lis3mdlAcqReadSamples. The main thread drives the virtual clock one
+ * conversion at a time and waits for each edge to be serviced before the next one.
+ *
+ * Checks that every conversion arrives exactly once and in order (timestamps rising,
+ * X stepping by exactly one ramp, no overrun), that the reader is woken about once per
+ * block rather than once per sample, and reports the edge-to-sample latency in wall
+ * time (thread wakeup plus burst) and in virtual time (the burst on the wire).
+ *
+ * Build from the repository root:
+ *   cc -O2 -std=c11 -pthread -I. -IMagnetometer_Driver bench/lis3mdl_acq_bench.c \
+ *      Magnetometer_Driver/lis3mdl_acq.c Magnetometer_Driver/lis3mdl_ring.c Magnetometer_Driver/lis3mdl.c \
+ *      i2c.c i2c_capture.c i2c_clock.c i2c_stats.c i2c_trace.c lis3mdl_sim.c -o lis3mdl_acq_bench
+ *
+ * Usage: lis3mdl_acq_bench [samples] [block]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "i2c.h"
+#include "i2c_sim.h"
+#include "lis3mdl_sim.h"
+#include "lis3mdl.h"
+#include "lis3mdl_register.h"
+#include "lis3mdl_ring.h"
+#include "lis3mdl_acq.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_BUS             0u
+#define BENCH_DEFAULT_SAMPLES 8000u
+#define BENCH_DEFAULT_BLOCK   64u
+#define BENCH_RING_LEN        256u
+#define BENCH_RAMP_LSB        3
+#define BENCH_READ_TIMEOUT_US 2000000u
+#define BENCH_SERVICE_SPIN_NS 20000000000ull  /* Give up on an edge after 20 s of wall time */
+
+static lis3mdl_sim_t bench_sim;
+static Lis3mdlDevice_st bench_dev;
+static Lis3mdlRing_st bench_ring;
+static Lis3mdlSample_st bench_storage[BENCH_RING_LEN];
+static Lis3mdlAcq_st bench_acq;
+
+static uint32_t bench_samples;
+static uint32_t bench_block;
+static uint64_t bench_edge_wall_ns;
+
+/* Reader results, written by the reader thread and read after it is joined */
+static uint32_t bench_received;
+static uint32_t bench_blocks;
+static uint32_t bench_out_of_order;
+static uint32_t bench_gaps;
+static uint32_t bench_overruns;
+static uint32_t bench_read_errors;
+
+static uint64_t bench_wall_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ull) + (uint64_t)ts.tv_nsec;
+}
+
+/* Pin callback adapter. Runs with the bus simulation locked; Lis3mdlAcqRaiseEdge does no I2C. */
+static void bench_drdy(void *context, uint64_t now_ns)
+{
+    bench_edge_wall_ns = bench_wall_ns();
+    Lis3mdlAcqRaiseEdge((Lis3mdlAcq_st *)context, now_ns);
+}
+
+static void *bench_reader(void *arg)
+{
+    Lis3mdlSample_st *block = malloc(bench_block * sizeof(*block));
+    uint64_t last_ts = 0u;
+    int32_t last_x = 0;
+    int have_last = 0;
+
+    (void)arg;
+    if (block == NULL) {
+        bench_read_errors++;
+        return NULL;
+    }
+
+    while (bench_received < bench_samples) {
+        uint32_t want = bench_samples - bench_received;
+        uint32_t got = 0u;
+
+        want = (want < bench_block) ? want : bench_block;
+        if (Lis3mdlAcqReadSamples(&bench_acq, block, want, BENCH_READ_TIMEOUT_US, &got) != STATUS_OK) {
+            bench_read_errors++;
+        }
+        if (got == 0u) {
+            break;
+        }
+        bench_blocks++;
+
+        for (uint32_t i = 0; i < got; ++i) {
+            const Lis3mdlSample_st *s = &block[i];
+
+            if (have_last) {
+                bench_out_of_order += (s->timestamp_u64 <= last_ts);
+                bench_gaps += ((int32_t)s->xyz_st.x_s16 - last_x) != BENCH_RAMP_LSB;
+            }
+            bench_overruns += (s->status_u8 & LIS3MDL_STATUS_ZYXOR) != 0u;
+            last_ts = s->timestamp_u64;
+            last_x = s->xyz_st.x_s16;
+            have_last = 1;
+        }
+        bench_received += got;
+    }
+
+    free(block);
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    Lis3mdlSpeedConfig_st speed = { LIS3MDL_ODR_80_HZ, LIS3MDL_MODE_LP, 1u };   /* FAST_ODR, 1000 Hz in LP */
+    Lis3mdlAcqStats_st stats;
+    pthread_t reader;
+    uint64_t wall_sum_ns = 0u;
+    uint64_t wall_max_ns = 0u;
+    uint64_t virtual_max_ns = 0u;
+    uint32_t serviced = 0u;
+    uint32_t stalled = 0u;
+
+    bench_samples = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : BENCH_DEFAULT_SAMPLES;
+    bench_block = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : BENCH_DEFAULT_BLOCK;
+    /* The ramp must stay inside the 16-bit output for the whole run */
+    if ((bench_samples == 0u) || (bench_samples > 10000u) || (bench_block == 0u) || (bench_block > BENCH_RING_LEN)) {
+        fprintf(stderr, "usage: %s [samples 1..10000] [block 1..%u]\n", argv[0], BENCH_RING_LEN);
+        return EXIT_FAILURE;
+    }
+
+    i2c_sim_detach_all();
+    if ((lis3mdl_sim_init(&bench_sim, BENCH_BUS, LIS3MDL_I2C_ADDRESS_SA1_LOW) != STATUS_OK) ||
+        (Lis3mdlInit(&bench_dev, BENCH_BUS, LIS3MDL_I2C_ADDRESS_SA1_LOW) != STATUS_OK) ||
+        (Lis3mdlSetOutputDataRate(&bench_dev, speed) != STATUS_OK) ||
+        (Lis3mdlRingInit(&bench_ring, bench_storage, BENCH_RING_LEN) != STATUS_OK) ||
+        (Lis3mdlAcqInit(&bench_acq, &bench_dev, &bench_ring) != STATUS_OK)) {
+        fprintf(stderr, "lis3mdl_acq_bench: failed to bring up the sensor\n");
+        return EXIT_FAILURE;
+    }
+    lis3mdl_sim_set_field(&bench_sim, 0.0, 0.0, 0.0);
+    lis3mdl_sim_set_ramp(&bench_sim, BENCH_RAMP_LSB);
+
+    if ((Lis3mdlAcqStart(&bench_acq) != STATUS_OK) ||
+        (pthread_create(&reader, NULL, bench_reader, NULL) != 0)) {
+        fprintf(stderr, "lis3mdl_acq_bench: failed to start the threads\n");
+        return EXIT_FAILURE;
+    }
+    lis3mdl_sim_set_drdy_callback(&bench_sim, bench_drdy, &bench_acq);
+    if (Lis3mdlSetSystemMode(&bench_dev, LIS3MDL_SYSTEM_CONTINUOUS) != STATUS_OK) {
+        fprintf(stderr, "lis3mdl_acq_bench: failed to start converting\n");
+        return EXIT_FAILURE;
+    }
+
+    /* One conversion per step; the next starts only once the engine has served this edge */
+    while ((serviced < bench_samples) && (stalled == 0u)) {
+        uint64_t edge_virtual_ns;
+        uint64_t start_wall;
+        uint64_t latency;
+
+        /* Step to the next conversion instant; the previous burst already moved the clock past the last one */
+        edge_virtual_ns = bench_sim.next_conversion_ns;
+        i2c_sim_advance(edge_virtual_ns - i2c_sim_now_ns());
+        start_wall = bench_edge_wall_ns;
+
+        for (;;) {
+            Lis3mdlAcqGetStats(&bench_acq, &stats);
+            if ((stats.samples_u32 + stats.spurious_u32 + stats.errors_u32) > serviced) {
+                break;
+            }
+            if ((bench_wall_ns() - start_wall) > BENCH_SERVICE_SPIN_NS) {
+                stalled = 1u;
+                break;
+            }
+        }
+        latency = bench_wall_ns() - start_wall;
+        serviced = stats.samples_u32 + stats.spurious_u32 + stats.errors_u32;
+
+        wall_sum_ns += latency;
+        wall_max_ns = (latency > wall_max_ns) ? latency : wall_max_ns;
+        latency = i2c_sim_now_ns() - edge_virtual_ns;
+        virtual_max_ns = (latency > virtual_max_ns) ? latency : virtual_max_ns;
+    }
+
+    pthread_join(reader, NULL);
+    lis3mdl_sim_set_drdy_callback(&bench_sim, NULL, NULL);
+    if (Lis3mdlAcqStop(&bench_acq) != STATUS_OK) {
+        bench_read_errors++;
+    }
+    Lis3mdlAcqGetStats(&bench_acq, &stats);
+
+    printf("{\n  \"benchmark\": \"lis3mdl_acq\",\n  \"samples\": %u,\n  \"block\": %u,\n",
+           bench_samples, bench_block);
+    printf("  \"edges\": %u,\n  \"coalesced\": %u,\n  \"pushed\": %u,\n  \"spurious\": %u,\n  \"errors\": %u,\n",
+           stats.edges_u32, stats.coalesced_u32, stats.samples_u32, stats.spurious_u32, stats.errors_u32);
+    printf("  \"received\": %u,\n  \"out_of_order\": %u,\n  \"gaps\": %u,\n  \"overruns\": %u,\n",
+           bench_received, bench_out_of_order, bench_gaps, bench_overruns);
+    printf("  \"blocks\": %u,\n  \"reader_wakeups\": %u,\n  \"wakeups_per_block\": %.3f,\n",
+           bench_blocks, stats.readerWakeups_u32,
+           bench_blocks ? (double)stats.readerWakeups_u32 / bench_blocks : 0.0);
+    printf("  \"mean_edge_to_sample_wall_us\": %.1f,\n  \"max_edge_to_sample_wall_us\": %.1f,\n",
+           serviced ? ((double)wall_sum_ns / serviced) / 1000.0 : 0.0, (double)wall_max_ns / 1000.0);
+    printf("  \"max_edge_to_sample_virtual_us\": %.1f,\n  \"burst_us\": %.1f\n}\n",
+           (double)virtual_max_ns / 1000.0,
+           (double)i2c_sim_transfer_ns(I2C_SIM_DEFAULT_BUS_HZ, 1u, LIS3MDL_STATUS_BURST_LEN) / 1000.0);
+
+    return ((stalled == 0u) && (bench_read_errors == 0u) && (bench_received == bench_samples) &&
+            (stats.samples_u32 == bench_samples) && (stats.coalesced_u32 == 0u) &&
+            (bench_out_of_order == 0u) && (bench_gaps == 0u) && (bench_overruns == 0u) &&
+            (stats.readerWakeups_u32 <= (2u * bench_blocks))) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,388 @@
+/*
+ * LIS3MDL driver benchmark with bus-cost accounting.
+ *
+ * Runs every Lis3mdl* API and sample-read path against the simulated sensor and reports,
+ * per call: host CPU time, I2C transactions, bytes on the wire and modelled bus time at
+ * 100 kHz, 400 kHz and 1 MHz. Results are written to stdout as JSON so runs can be
+ * diffed across driver changes. CPU time includes the simulator's own cost; the bus
+ * figures come from the simulator's per-bus accounting and are exact for the model.
+ * Sample-read cases stream at the maximum ODR (1000 Hz FAST_ODR); read_xyz_burst and
+ * read_xyz8_fast_read compare the 16-bit and FAST_READ 8-bit paths. The read_*_temp cases
+ * run with TEMP_EN: fused into the status burst every sample, every 16th sample, or as a
+ * separate TEMP_OUT read after each status burst. The closing "comparisons" section sets
+ * each sample path against the one it replaced, per sample: read_split_bytes_x6 (what
+ * Lis3mdlReadOutputData did before Lis3mdlReadXYZ: one transaction per output byte) and
+ * read_single_axis_x3 (Lis3mdlReadOutputData per axis today) against read_xyz_burst.
+ *
+ * Build from the repository root:
+ *   cc -O2 -std=c11 -pthread -I. -IMagnetometer_Driver bench/lis3mdl_bench.c \
+ *      i2c.c i2c_capture.c i2c_clock.c i2c_stats.c i2c_trace.c lis3mdl_sim.c Magnetometer_Driver/lis3mdl.c -o lis3mdl_bench
+ *
+ * Add -DI2C_STATS_ENABLED to measure the cost of the I2C instrumentation layer.
+ *
+ * Usage: lis3mdl_bench [iterations]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "i2c.h"
+#include "i2c_sim.h"
+#include "lis3mdl_sim.h"
+#include "lis3mdl.h"
+#include "lis3mdl_register.h"
+
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_BUS            0u
+#define BENCH_DEFAULT_ITERS  10000u
+
+typedef struct {
+    const char *name;
+    void (*setup)(void);
+    void (*run)(void);
+} bench_case_t;
+
+/* Two cases producing the same sample: the path being replaced and its replacement. */
+typedef struct {
+    const char *before;
+    const char *after;
+} bench_comparison_t;
+
+static const uint32_t bench_bus_hz[] = { 100000u, 400000u, 1000000u };
+
+#define BENCH_SPEEDS (sizeof(bench_bus_hz) / sizeof(bench_bus_hz[0]))
+
+static lis3mdl_sim_t bench_sim;
+static Lis3mdlDevice_st bench_dev;
+static Lis3mdlSampleXYZ_st bench_sample;
+static Lis3mdlSample8_st bench_sample8;
+static int bench_async_done;            /* Set by the I2C worker; __atomic acquire/release */
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ull) + (uint64_t)ts.tv_nsec;
+}
+
+/* Continuous conversion at 1000 Hz FAST_ODR so every read path sees live data. */
+static void bench_setup_streaming(void)
+{
+    Lis3mdlShadow_st config_st = bench_dev.shadow_st;
+
+    config_st.ctrlReg_au8[0] = LIS3MDL_CTRL1_FAST_ODR;
+    config_st.ctrlReg_au8[2] = LIS3MDL_CTRL3_MD_CONTINUOUS;
+    (void)Lis3mdlWriteConfig(&bench_dev, &config_st);
+}
+
+/* As bench_setup_streaming, with FAST_READ for the 8-bit high-byte path. */
+static void bench_setup_streaming_fast_read(void)
+{
+    bench_setup_streaming();
+    (void)Lis3mdlSetFastRead(&bench_dev, 1u);
+}
+
+/* As bench_setup_streaming, with TEMP_EN and the temperature in every status burst. */
+static void bench_setup_streaming_temperature(void)
+{
+    bench_setup_streaming();
+    (void)Lis3mdlSetTemperatureSensor(&bench_dev, 1u);
+}
+
+/* As bench_setup_streaming_temperature, with the temperature in one burst out of 16. */
+static void bench_setup_streaming_temperature_dec16(void)
+{
+    bench_setup_streaming_temperature();
+    (void)Lis3mdlSetTemperatureDecimation(&bench_dev, 16u);
+}
+
+/* TEMP_EN set behind the driver's back: status bursts stay 7 bytes. */
+static void bench_setup_streaming_temperature_separate(void)
+{
+    uint8_t ctrl1 = LIS3MDL_CTRL1_FAST_ODR | LIS3MDL_CTRL1_TEMP_EN;
+
+    bench_setup_streaming();
+    (void)i2c_bus_write(bench_dev.bus_u8, bench_dev.address_u8, LIS3MDL_CTRL_REG1, 1u, &ctrl1);
+}
+
+static void bench_run_get_full_scale(void)
+{
+    Lis3mdlScale_t scale_en;
+
+    (void)Lis3mdlGetFullScaleConfig(&bench_dev, &scale_en);
+}
+
+/* What Lis3mdlGetFullScaleConfig cost before the register shadow: one CTRL_REG2 read. */
+static void bench_run_get_full_scale_uncached(void)
+{
+    uint8_t ctrl2;
+
+    (void)i2c_bus_read(bench_dev.bus_u8, bench_dev.address_u8, LIS3MDL_CTRL_REG2, 1u, &ctrl2);
+}
+
+static void bench_run_get_output_data_rate(void)
+{
+    Lis3mdlSpeedConfig_st config_st;
+
+    (void)Lis3mdlGetOutputDataRate(&bench_dev, &config_st);
+}
+
+/* Alternates between 1000 Hz LP and 40 Hz UHP so every call changes CTRL_REG1 and CTRL_REG4. */
+static void bench_run_set_output_data_rate(void)
+{
+    static const Lis3mdlSpeedConfig_st configs[2] = {
+        { LIS3MDL_ODR_80_HZ, LIS3MDL_MODE_LP, 1u },
+        { LIS3MDL_ODR_40_HZ, LIS3MDL_MODE_UHP, 0u },
+    };
+    static uint8_t index;
+
+    index ^= 1u;
+    (void)Lis3mdlSetOutputDataRate(&bench_dev, configs[index]);
+}
+
+static void bench_run_toggle_interrupt(void)
+{
+    static uint8_t enable;
+
+    enable ^= 1u;
+    (void)Lis3mdlToggleInterrupt(&bench_dev, enable ? LIS3MDL_INTR_EN : LIS3MDL_INTR_DIS);
+}
+
+static void bench_run_resync(void)
+{
+    (void)Lis3mdlResync(&bench_dev);
+}
+
+static void bench_run_write_config(void)
+{
+    Lis3mdlShadow_st config_st = bench_dev.shadow_st;
+
+    (void)Lis3mdlWriteConfig(&bench_dev, &config_st);
+}
+
+/* What Lis3mdlReadOutputData did before Lis3mdlReadXYZ: every output byte in its own transaction. */
+static void bench_run_read_split_bytes_x6(void)
+{
+    int16_t *axes[3] = { &bench_sample.x_s16, &bench_sample.y_s16, &bench_sample.z_s16 };
+
+    for (uint8_t axis = 0; axis < 3u; ++axis) {
+        uint8_t low = 0u;
+        uint8_t high = 0u;
+
+        (void)i2c_bus_read(bench_dev.bus_u8, bench_dev.address_u8,
+                           (uint8_t)(LIS3MDL_OUT_X_L + (2u * axis)), 1u, &low);
+        (void)i2c_bus_read(bench_dev.bus_u8, bench_dev.address_u8,
+                           (uint8_t)(LIS3MDL_OUT_X_H + (2u * axis)), 1u, &high);
+        *axes[axis] = (int16_t)((high << 8) | low);
+    }
+}
+
+static void bench_run_read_single_axis_x3(void)
+{
+    (void)Lis3mdlReadOutputData(&bench_dev, LIS3MDL_OUT_AXIS_X, &bench_sample.x_s16);
+    (void)Lis3mdlReadOutputData(&bench_dev, LIS3MDL_OUT_AXIS_Y, &bench_sample.y_s16);
+    (void)Lis3mdlReadOutputData(&bench_dev, LIS3MDL_OUT_AXIS_Z, &bench_sample.z_s16);
+}
+
+static void bench_run_read_xyz(void)
+{
+    (void)Lis3mdlReadXYZ(&bench_dev, &bench_sample);
+}
+
+static void bench_run_read_xyz8(void)
+{
+    (void)Lis3mdlReadXYZ8(&bench_dev, &bench_sample8);
+}
+
+static void bench_run_read_xyz_if_ready(void)
+{
+    uint8_t new_data;
+
+    (void)Lis3mdlReadXYZIfReady(&bench_dev, &bench_sample, &new_data);
+}
+
+/* What the temperature cost before it was fused: a second transaction per sample. */
+static void bench_run_read_xyz_if_ready_temp_separate(void)
+{
+    uint8_t new_data;
+    uint8_t temp[2];
+
+    (void)Lis3mdlReadXYZIfReady(&bench_dev, &bench_sample, &new_data);
+    (void)i2c_bus_read(bench_dev.bus_u8, bench_dev.address_u8,
+                       (LIS3MDL_TEMP_OUT_L | LIS3MDL_AUTO_INCREMENT), 2u, temp);
+}
+
+static void bench_async_done_cb(status_t status, uint8_t new_data, void *context)
+{
+    (void)status;
+    (void)new_data;
+    (void)context;
+    __atomic_store_n(&bench_async_done, 1, __ATOMIC_RELEASE);
+}
+
+static void bench_run_read_xyz_if_ready_async(void)
+{
+    __atomic_store_n(&bench_async_done, 0, __ATOMIC_RELAXED);
+    if (Lis3mdlReadXYZIfReadyAsync(&bench_dev, &bench_sample, bench_async_done_cb, NULL) == STATUS_OK) {
+        while (!__atomic_load_n(&bench_async_done, __ATOMIC_ACQUIRE)) {
+            sched_yield();
+        }
+    }
+}
+
+static const bench_case_t bench_cases[] = {
+    { "get_full_scale_cached",     NULL,                  bench_run_get_full_scale },
+    { "get_full_scale_uncached",   NULL,                  bench_run_get_full_scale_uncached },
+    { "get_output_data_rate",      NULL,                  bench_run_get_output_data_rate },
+    { "set_output_data_rate",      NULL,                  bench_run_set_output_data_rate },
+    { "toggle_interrupt",          NULL,                  bench_run_toggle_interrupt },
+    { "resync",                    NULL,                  bench_run_resync },
+    { "write_config",              NULL,                  bench_run_write_config },
+    { "read_split_bytes_x6",       bench_setup_streaming, bench_run_read_split_bytes_x6 },
+    { "read_single_axis_x3",       bench_setup_streaming, bench_run_read_single_axis_x3 },
+    { "read_xyz_burst",            bench_setup_streaming, bench_run_read_xyz },
+    { "read_xyz8_fast_read",       bench_setup_streaming_fast_read, bench_run_read_xyz8 },
+    { "read_xyz_if_ready",         bench_setup_streaming, bench_run_read_xyz_if_ready },
+    { "read_xyz_if_ready_async",   bench_setup_streaming, bench_run_read_xyz_if_ready_async },
+    { "read_xyz_if_ready_temp",    bench_setup_streaming_temperature, bench_run_read_xyz_if_ready },
+    { "read_xyz_if_ready_temp_dec16", bench_setup_streaming_temperature_dec16, bench_run_read_xyz_if_ready },
+    { "read_xyz_if_ready_temp_separate", bench_setup_streaming_temperature_separate,
+      bench_run_read_xyz_if_ready_temp_separate },
+};
+
+#define BENCH_CASES (sizeof(bench_cases) / sizeof(bench_cases[0]))
+
+static const bench_comparison_t bench_comparisons[] = {
+    { "read_split_bytes_x6",             "read_xyz_burst" },
+    { "read_single_axis_x3",             "read_xyz_burst" },
+    { "read_xyz_if_ready_temp_separate", "read_xyz_if_ready_temp" },
+};
+
+/* Per-speed bus figures of every case, kept for the comparisons */
+static i2c_sim_bus_stats_t bench_results[BENCH_CASES][BENCH_SPEEDS];
+
+static void bench_reset_device(void)
+{
+    i2c_sim_detach_all();
+    if ((lis3mdl_sim_init(&bench_sim, BENCH_BUS, LIS3MDL_I2C_ADDRESS_SA1_LOW) != STATUS_OK) ||
+        (Lis3mdlInit(&bench_dev, BENCH_BUS, LIS3MDL_I2C_ADDRESS_SA1_LOW) != STATUS_OK)) {
+        fprintf(stderr, "lis3mdl_bench: failed to bring up the simulated sensor\n");
+        exit(EXIT_FAILURE);
+    }
+    lis3mdl_sim_set_field(&bench_sim, 0.25, -0.5, 0.4);
+}
+
+static void bench_run_case(const bench_case_t *bench, i2c_sim_bus_stats_t *stats, uint32_t iterations, int last)
+{
+    uint64_t cpu_ns[BENCH_SPEEDS];
+
+    for (size_t s = 0; s < BENCH_SPEEDS; ++s) {
+        uint64_t start_ns;
+
+        bench_reset_device();
+        i2c_sim_set_bus_speed(BENCH_BUS, bench_bus_hz[s]);
+        if (bench->setup != NULL) {
+            bench->setup();
+        }
+        i2c_sim_reset_bus_stats();
+
+        start_ns = bench_now_ns();
+        for (uint32_t i = 0; i < iterations; ++i) {
+            bench->run();
+        }
+        cpu_ns[s] = bench_now_ns() - start_ns;
+        i2c_sim_get_bus_stats(BENCH_BUS, &stats[s]);
+    }
+
+    /* Transactions and bytes do not depend on the bus clock; report the 400 kHz run */
+    printf("    {\"name\": \"%s\", \"transactions_per_call\": %.3f, \"bytes_per_call\": %.3f, "
+           "\"data_bytes_per_call\": %.3f,\n",
+           bench->name,
+           (double)stats[1].transactions / iterations,
+           (double)stats[1].bytes / iterations,
+           (double)stats[1].data_bytes / iterations);
+
+    printf("     \"cpu_ns_per_call\": {");
+    for (size_t s = 0; s < BENCH_SPEEDS; ++s) {
+        printf("%s\"%u\": %.1f", (s == 0u) ? "" : ", ", bench_bus_hz[s],
+               (double)cpu_ns[s] / iterations);
+    }
+
+    printf("},\n     \"bus_us_per_call\": {");
+    for (size_t s = 0; s < BENCH_SPEEDS; ++s) {
+        printf("%s\"%u\": %.3f", (s == 0u) ? "" : ", ", bench_bus_hz[s],
+               ((double)stats[s].bus_ns / 1000.0) / iterations);
+    }
+
+    /* Calls per second the bus alone could sustain; compare against the 1000 Hz max ODR */
+    printf("},\n     \"bus_limited_calls_per_s\": {");
+    for (size_t s = 0; s < BENCH_SPEEDS; ++s) {
+        printf("%s\"%u\": %.0f", (s == 0u) ? "" : ", ", bench_bus_hz[s],
+               (stats[s].bus_ns != 0u) ? ((1e9 * iterations) / (double)stats[s].bus_ns) : 0.0);
+    }
+    printf("}}%s\n", last ? "" : ",");
+}
+
+static size_t bench_find_case(const char *name)
+{
+    size_t i = 0;
+
+    while ((i < BENCH_CASES) && (strcmp(bench_cases[i].name, name) != 0)) {
+        ++i;
+    }
+
+    return i;
+}
+
+/* One case per sample, so per call is per sample; transactions and bytes from the 400 kHz run. */
+static void bench_print_comparison(const bench_comparison_t *comparison, uint32_t iterations, int last)
+{
+    const i2c_sim_bus_stats_t *before = bench_results[bench_find_case(comparison->before)];
+    const i2c_sim_bus_stats_t *after = bench_results[bench_find_case(comparison->after)];
+
+    printf("    {\"before\": \"%s\", \"after\": \"%s\",\n", comparison->before, comparison->after);
+    printf("     \"transactions_per_sample\": {\"before\": %.3f, \"after\": %.3f}, "
+           "\"bytes_per_sample\": {\"before\": %.3f, \"after\": %.3f},\n",
+           (double)before[1].transactions / iterations, (double)after[1].transactions / iterations,
+           (double)before[1].bytes / iterations, (double)after[1].bytes / iterations);
+
+    printf("     \"bus_us_per_sample\": {");
+    for (size_t s = 0; s < BENCH_SPEEDS; ++s) {
+        printf("%s\"%u\": {\"before\": %.3f, \"after\": %.3f}", (s == 0u) ? "" : ", ", bench_bus_hz[s],
+               ((double)before[s].bus_ns / 1000.0) / iterations,
+               ((double)after[s].bus_ns / 1000.0) / iterations);
+    }
+    printf("}}%s\n", last ? "" : ",");
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iterations = BENCH_DEFAULT_ITERS;
+    size_t comparisons = sizeof(bench_comparisons) / sizeof(bench_comparisons[0]);
+
+    if (argc > 1) {
+        iterations = (uint32_t)strtoul(argv[1], NULL, 0);
+        if (iterations == 0u) {
+            fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("{\n  \"benchmark\": \"lis3mdl_driver\",\n  \"iterations\": %u,\n  \"cases\": [\n", iterations);
+    for (size_t i = 0; i < BENCH_CASES; ++i) {
+        bench_run_case(&bench_cases[i], bench_results[i], iterations, i == (BENCH_CASES - 1u));
+    }
+    printf("  ],\n  \"comparisons\": [\n");
+    for (size_t i = 0; i < comparisons; ++i) {
+        bench_print_comparison(&bench_comparisons[i], iterations, i == (comparisons - 1u));
+    }
+    printf("  ]\n}\n");
+
+    return (i2c_async_shutdown() == STATUS_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
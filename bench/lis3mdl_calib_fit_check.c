@@ -0,0 +1,152 @@
+/*
+ * Regression check of tools/lis3mdl_calib_fit across thread counts.
+ *
+ * Records an I2C capture of a simulated sensor switched to +/-16 gauss before its first
+ * sample, sweeping a sphere of 0.5 gauss around a known hard-iron offset (kept small next to
+ * the radius, which the single-precision moments of the fit need), then runs the
+ * tool on it with 1, 2, 3, 4 and 7 threads. Every run must find the offset, and all runs
+ * must agree with the single-threaded one: chunks after the first start from the full
+ * scale noted while splitting, so a setup write missed there shows up as a wrong offset
+ * on the multi-threaded runs only.
+ *
+ * Build from the repository root:
+ *   cc -O2 -std=c11 -pthread -I. -IMagnetometer_Driver bench/lis3mdl_calib_fit_check.c \
+ *      Magnetometer_Driver/lis3mdl.c i2c.c i2c_capture.c i2c_clock.c i2c_stats.c i2c_trace.c \
+ *      lis3mdl_sim.c -lm -o lis3mdl_calib_fit_check
+ *
+ * Usage: lis3mdl_calib_fit_check <lis3mdl_calib_fit> [capture]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "i2c.h"
+#include "i2c_capture.h"
+#include "i2c_sim.h"
+#include "lis3mdl_sim.h"
+#include "lis3mdl.h"
+#include "lis3mdl_register.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHECK_BUS            0u
+#define CHECK_SAMPLES        20000u
+#define CHECK_RADIUS_GAUSS   0.5
+#define CHECK_TOLERANCE      0.01      /* gauss */
+#define CHECK_DEFAULT_PATH   "/tmp/lis3mdl_calib_fit_check.cap"
+
+static const double check_offset[3] = { 0.3, -0.2, 0.25 };
+static const unsigned check_threads[] = { 1u, 2u, 3u, 4u, 7u };
+
+static uint32_t check_rng = 0x2545f491u;
+
+static double check_uniform(void)
+{
+    check_rng = (check_rng * 1664525u) + 1013904223u;
+    return ((double)(check_rng >> 8) + 0.5) / 16777216.0;
+}
+
+static int check_record(const char *path)
+{
+    static lis3mdl_sim_t sim;
+    Lis3mdlSpeedConfig_st speed = { LIS3MDL_ODR_80_HZ, LIS3MDL_MODE_LP, 1u };
+    Lis3mdlDevice_st dev;
+    Lis3mdlSampleXYZ_st sample;
+    uint8_t ctrl2 = (uint8_t)(LIS3MDL_SCALE_16G << LIS3MDL_CTRL2_FS_SHIFT);
+
+    i2c_sim_detach_all();
+    if ((lis3mdl_sim_init(&sim, CHECK_BUS, LIS3MDL_I2C_ADDRESS_SA1_LOW) != STATUS_OK) ||
+        (i2c_capture_start(path) != STATUS_OK)) {
+        return 0;
+    }
+
+    /* Full scale set before any sample, as a bring-up sequence does */
+    if ((Lis3mdlInit(&dev, CHECK_BUS, LIS3MDL_I2C_ADDRESS_SA1_LOW) != STATUS_OK) ||
+        (i2c_bus_write(CHECK_BUS, LIS3MDL_I2C_ADDRESS_SA1_LOW, LIS3MDL_CTRL_REG2, 1u, &ctrl2) != STATUS_OK) ||
+        (Lis3mdlSetOutputDataRate(&dev, speed) != STATUS_OK) ||
+        (Lis3mdlSetSystemMode(&dev, LIS3MDL_SYSTEM_CONTINUOUS) != STATUS_OK)) {
+        (void)i2c_capture_stop();
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < CHECK_SAMPLES; ++i) {
+        double z = (2.0 * check_uniform()) - 1.0;
+        double phi = 2.0 * 3.14159265358979 * check_uniform();
+        double r = sqrt(1.0 - (z * z));
+
+        lis3mdl_sim_set_field(&sim, check_offset[0] + (CHECK_RADIUS_GAUSS * r * cos(phi)),
+                              check_offset[1] + (CHECK_RADIUS_GAUSS * r * sin(phi)),
+                              check_offset[2] + (CHECK_RADIUS_GAUSS * z));
+        i2c_sim_advance(1000000u);
+        if (Lis3mdlReadXYZ(&dev, &sample) != STATUS_OK) {
+            (void)i2c_capture_stop();
+            return 0;
+        }
+    }
+
+    return (i2c_capture_stop() == STATUS_OK);
+}
+
+/* Run the tool and parse the offset line of its initializer. */
+static int check_run(const char *tool, const char *path, unsigned threads, double offset[3])
+{
+    char command[4096];
+    char line[256];
+    int found = 0;
+    FILE *pipe;
+
+    snprintf(command, sizeof(command), "'%s' -t %u '%s' 2>/dev/null", tool, threads, path);
+    pipe = popen(command, "r");
+    if (pipe == NULL) {
+        return 0;
+    }
+    while (fgets(line, sizeof(line), pipe) != NULL) {
+        if (!found && (sscanf(line, " { %lff, %lff, %lff },", &offset[0], &offset[1], &offset[2]) == 3)) {
+            found = 1;
+        }
+    }
+    return (pclose(pipe) == 0) && found;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = (argc > 2) ? argv[2] : CHECK_DEFAULT_PATH;
+    double reference[3] = { 0.0, 0.0, 0.0 };
+    int ok = 1;
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <lis3mdl_calib_fit> [capture]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (!check_record(path)) {
+        fprintf(stderr, "%s: cannot record %s\n", argv[0], path);
+        return EXIT_FAILURE;
+    }
+
+    printf("{\n  \"check\": \"lis3mdl_calib_fit\",\n  \"samples\": %u,\n  \"runs\": [\n", CHECK_SAMPLES);
+    for (size_t i = 0; i < (sizeof(check_threads) / sizeof(check_threads[0])); ++i) {
+        double offset[3] = { NAN, NAN, NAN };
+        int run_ok = check_run(argv[1], path, check_threads[i], offset);
+
+        if (run_ok && (i == 0u)) {
+            reference[0] = offset[0];
+            reference[1] = offset[1];
+            reference[2] = offset[2];
+        }
+        for (uint32_t axis = 0; run_ok && (axis < 3u); ++axis) {
+            run_ok = (fabs(offset[axis] - check_offset[axis]) < CHECK_TOLERANCE) &&
+                     (fabs(offset[axis] - reference[axis]) < 1e-4);
+        }
+        ok = ok && run_ok;
+
+        printf("    { \"threads\": %u, \"offset\": [%.4f, %.4f, %.4f], \"ok\": %s }%s\n", check_threads[i],
+               offset[0], offset[1], offset[2],
+               run_ok ? "true" : "false",
+               ((i + 1u) < (sizeof(check_threads) / sizeof(check_threads[0]))) ? "," : "");
+    }
+    printf("  ],\n  \"expected_offset\": [%.4f, %.4f, %.4f]\n}\n", check_offset[0], check_offset[1], check_offset[2]);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
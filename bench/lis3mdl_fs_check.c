@@ -0,0 +1,82 @@
+/*
+ * Regression check of the full-scale decode in Lis3mdlGetFullScaleConfig.
+ *
+ * FS occupies CTRL_REG2 bits 6:5. For every scale the check writes the raw FS bits to
+ * the simulated sensor behind the driver's back, resyncs the register shadow and expects
+ * Lis3mdlGetFullScaleConfig to report that scale. It then reads one sample of a 1 gauss
+ * field and converts it with the reported scale, which must give 1 gauss back: a decode
+ * from the wrong bits (as bits 7:6 did) reports 4 G for 8 G and 12 G for 16 G and fails
+ * both checks.
+ *
+ * Build from the repository root:
+ *   cc -O2 -std=c11 -pthread -I. -IMagnetometer_Driver bench/lis3mdl_fs_check.c \
+ *      Magnetometer_Driver/lis3mdl.c i2c.c i2c_capture.c i2c_clock.c i2c_stats.c i2c_trace.c \
+ *      lis3mdl_sim.c -o lis3mdl_fs_check
+ *
+ * Usage: lis3mdl_fs_check
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "i2c.h"
+#include "i2c_sim.h"
+#include "lis3mdl_sim.h"
+#include "lis3mdl.h"
+#include "lis3mdl_register.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHECK_BUS            0u
+#define CHECK_FIELD_GAUSS    1.0
+#define CHECK_TOLERANCE      0.001     /* gauss, well under one LSB at 4 G */
+
+static const char *const check_names[] = { "4G", "8G", "12G", "16G" };
+
+int main(void)
+{
+    static lis3mdl_sim_t sim;
+    Lis3mdlSpeedConfig_st speed = { LIS3MDL_ODR_80_HZ, LIS3MDL_MODE_LP, 1u };   /* FAST_ODR, 1000 Hz in LP */
+    Lis3mdlDevice_st dev;
+    uint32_t failures = 0u;
+
+    i2c_sim_detach_all();
+    if ((lis3mdl_sim_init(&sim, CHECK_BUS, LIS3MDL_I2C_ADDRESS_SA1_LOW) != STATUS_OK) ||
+        (Lis3mdlInit(&dev, CHECK_BUS, LIS3MDL_I2C_ADDRESS_SA1_LOW) != STATUS_OK) ||
+        (Lis3mdlSetOutputDataRate(&dev, speed) != STATUS_OK) ||
+        (Lis3mdlSetSystemMode(&dev, LIS3MDL_SYSTEM_CONTINUOUS) != STATUS_OK)) {
+        fprintf(stderr, "lis3mdl_fs_check: failed to bring up the sensor\n");
+        return EXIT_FAILURE;
+    }
+    lis3mdl_sim_set_field(&sim, CHECK_FIELD_GAUSS, 0.0, 0.0);
+
+    printf("{\n  \"check\": \"lis3mdl_fs_decode\",\n  \"scales\": [\n");
+    for (uint32_t fs = 0u; fs < 4u; ++fs) {
+        uint8_t ctrl2 = (uint8_t)(fs << LIS3MDL_CTRL2_FS_SHIFT);
+        Lis3mdlScale_t decoded = LIS3MDL_SCALE_UNKNOWN;
+        Lis3mdlSampleXYZ_st sample = { 0 };
+        Lis3mdlFieldGauss_st gauss = { 0.0f, 0.0f, 0.0f };
+        uint8_t new_data = 0u;
+        int ok;
+
+        ok = (i2c_bus_write(CHECK_BUS, LIS3MDL_I2C_ADDRESS_SA1_LOW, LIS3MDL_CTRL_REG2, 1u, &ctrl2) == STATUS_OK) &&
+             (Lis3mdlResync(&dev) == STATUS_OK) &&
+             (Lis3mdlGetFullScaleConfig(&dev, &decoded) == STATUS_OK);
+
+        /* A conversion taken entirely at the new scale */
+        i2c_sim_advance(2000000u);
+        ok = ok && (Lis3mdlReadXYZIfReady(&dev, &sample, &new_data) == STATUS_OK) && (new_data != 0u) &&
+             (decoded == (Lis3mdlScale_t)fs) &&
+             (Lis3mdlConvertToGauss(decoded, &sample, &gauss) == STATUS_OK) &&
+             (gauss.x_f32 > (CHECK_FIELD_GAUSS - CHECK_TOLERANCE)) && (gauss.x_f32 < (CHECK_FIELD_GAUSS + CHECK_TOLERANCE));
+
+        failures += !ok;
+        printf("    { \"written\": \"%s\", \"decoded\": \"%s\", \"raw_x\": %d, \"gauss_x\": %.4f, \"ok\": %s }%s\n",
+               check_names[fs], ((uint32_t)decoded < 4u) ? check_names[decoded] : "unknown",
+               sample.x_s16, (double)gauss.x_f32, ok ? "true" : "false", (fs == 3u) ? "" : ",");
+    }
+    printf("  ],\n  \"failures\": %u\n}\n", failures);
+
+    return (failures == 0u) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,181 @@
+/*
+ * Record and replay a LIS3MDL acquisition run through the I2C capture backend.
+ *
+ * "record" streams samples from the simulated sensor (or, on target, the real bus) and
+ * captures every transaction. "replay" runs the same driver pipeline against the mapped
+ * capture with no bus and no device, as fast as the host allows, and prints the replay
+ * rate, the captured duration and a checksum of every sample the pipeline saw. Two
+ * replays of one capture print the same checksum.
+ *
+ * Build from the repository root:
+ *   cc -O2 -std=c11 -pthread -I. -IMagnetometer_Driver bench/lis3mdl_replay.c \
+ *      i2c.c i2c_capture.c i2c_clock.c i2c_stats.c i2c_trace.c lis3mdl_sim.c \
+ *      Magnetometer_Driver/lis3mdl.c -o lis3mdl_replay
+ *
+ * Usage: lis3mdl_replay record <capture> [samples]
+ *        lis3mdl_replay replay <capture>
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "i2c.h"
+#include "i2c_capture.h"
+#include "i2c_clock.h"
+#include "i2c_sim.h"
+#include "lis3mdl_sim.h"
+#include "lis3mdl.h"
+#include "lis3mdl_register.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REPLAY_BUS              0u
+#define REPLAY_DEFAULT_SAMPLES  100000u
+#define REPLAY_POLL_NS          250000u   /* Poll period while recording */
+
+typedef struct {
+    uint64_t polls;
+    uint64_t samples;
+    uint64_t checksum;
+} replay_pipeline_t;
+
+/* FNV-1a over the raw sample words, in arrival order. */
+static void replay_pipeline_consume(replay_pipeline_t *pipeline, const Lis3mdlSampleXYZ_st *sample)
+{
+    const int16_t axes[3] = { sample->x_s16, sample->y_s16, sample->z_s16 };
+
+    for (uint32_t i = 0; i < 3u; ++i) {
+        pipeline->checksum ^= (uint16_t)axes[i];
+        pipeline->checksum *= 0x100000001b3ull;
+    }
+    pipeline->samples++;
+}
+
+/* One poll of the pipeline under test. Identical in both modes. */
+static status_t replay_pipeline_poll(replay_pipeline_t *pipeline, Lis3mdlDevice_st *dev)
+{
+    Lis3mdlSampleXYZ_st sample;
+    uint8_t newData_u8;
+    status_t status;
+
+    status = Lis3mdlReadXYZIfReady(dev, &sample, &newData_u8);
+    pipeline->polls++;
+    if ((status == STATUS_OK) && newData_u8) {
+        replay_pipeline_consume(pipeline, &sample);
+    }
+
+    return status;
+}
+
+static status_t replay_pipeline_open(Lis3mdlDevice_st *dev)
+{
+    Lis3mdlShadow_st config_st;
+
+    if (Lis3mdlInit(dev, REPLAY_BUS, LIS3MDL_I2C_ADDRESS_SA1_LOW) != STATUS_OK) {
+        return STATUS_ERROR;
+    }
+
+    config_st = dev->shadow_st;
+    config_st.ctrlReg_au8[0] = LIS3MDL_CTRL1_FAST_ODR;
+    config_st.ctrlReg_au8[2] = LIS3MDL_CTRL3_MD_CONTINUOUS;
+    return Lis3mdlWriteConfig(dev, &config_st);
+}
+
+static int replay_record(const char *path, uint64_t samples)
+{
+    static lis3mdl_sim_t sim;
+    replay_pipeline_t pipeline = { .checksum = 0xcbf29ce484222325ull };
+    Lis3mdlDevice_st dev;
+
+    if ((lis3mdl_sim_init(&sim, REPLAY_BUS, LIS3MDL_I2C_ADDRESS_SA1_LOW) != STATUS_OK) ||
+        (i2c_capture_start(path) != STATUS_OK)) {
+        fprintf(stderr, "cannot start capture to %s\n", path);
+        return EXIT_FAILURE;
+    }
+    lis3mdl_sim_set_field(&sim, 0.21, -0.05, 0.43);
+    lis3mdl_sim_set_ramp(&sim, 3);
+
+    if (replay_pipeline_open(&dev) != STATUS_OK) {
+        fprintf(stderr, "driver init failed\n");
+        return EXIT_FAILURE;
+    }
+
+    while (pipeline.samples < samples) {
+        i2c_sim_advance(REPLAY_POLL_NS);
+        (void)replay_pipeline_poll(&pipeline, &dev);
+    }
+
+    if (i2c_capture_stop() != STATUS_OK) {
+        fprintf(stderr, "cannot finish capture %s\n", path);
+        return EXIT_FAILURE;
+    }
+
+    printf("recorded %llu polls, %llu samples, checksum %016llx\n",
+           (unsigned long long)pipeline.polls,
+           (unsigned long long)pipeline.samples,
+           (unsigned long long)pipeline.checksum);
+    return EXIT_SUCCESS;
+}
+
+static int replay_replay(const char *path)
+{
+    replay_pipeline_t pipeline = { .checksum = 0xcbf29ce484222325ull };
+    i2c_replay_stats_t stats;
+    Lis3mdlDevice_st dev;
+    uint64_t start_ns;
+    uint64_t elapsed_ns;
+
+    if (i2c_replay_open(path) != STATUS_OK) {
+        fprintf(stderr, "%s: not a readable capture\n", path);
+        return EXIT_FAILURE;
+    }
+
+    start_ns = i2c_clock_now_ns();
+
+    if (replay_pipeline_open(&dev) != STATUS_OK) {
+        fprintf(stderr, "driver init diverged from the capture\n");
+        return EXIT_FAILURE;
+    }
+
+    do {
+        if (replay_pipeline_poll(&pipeline, &dev) != STATUS_OK) {
+            break;
+        }
+        i2c_replay_get_stats(&stats);
+    } while (stats.bytes_left != 0u);
+
+    elapsed_ns = i2c_clock_now_ns() - start_ns;
+    i2c_replay_get_stats(&stats);
+    i2c_replay_close();
+
+    printf("replayed %llu transactions, %llu samples in %.3f ms (%.0f samples/s), "
+           "captured span %.3f ms, divergences %llu, checksum %016llx\n",
+           (unsigned long long)stats.transactions,
+           (unsigned long long)pipeline.samples,
+           (double)elapsed_ns / 1e6,
+           ((double)pipeline.samples * 1e9) / (double)(elapsed_ns ? elapsed_ns : 1u),
+           (double)stats.capture_us / 1e3,
+           (unsigned long long)stats.divergences,
+           (unsigned long long)pipeline.checksum);
+
+    return (stats.divergences == 0u) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char **argv)
+{
+    if ((argc >= 3) && (strcmp(argv[1], "record") == 0)) {
+        uint64_t samples = (argc > 3) ? strtoull(argv[3], NULL, 0) : REPLAY_DEFAULT_SAMPLES;
+
+        return replay_record(argv[2], samples);
+    }
+
+    if ((argc == 3) && (strcmp(argv[1], "replay") == 0)) {
+        return replay_replay(argv[2]);
+    }
+
+    fprintf(stderr, "usage: %s record <capture> [samples]\n"
+                    "       %s replay <capture>\n", argv[0], argv[0]);
+    return EXIT_FAILURE;
+}
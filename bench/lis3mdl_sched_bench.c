@@ -0,0 +1,167 @@
+/*
+ * LIS3MDL single-conversion scheduler benchmark.
+ *
+ * Four simulated sensors, two per bus, sampled by a control loop through Lis3mdlSched*
+ * on the simulator's virtual clock: every tick asks each sensor for one sample at the
+ * tick instant, and sensors 1 and 3 for a second one a quarter of the window later,
+ * which the batch window folds into the same conversion. Reports how late the
+ * conversions started against the requested instants, the delivery latency, the bus
+ * traffic per sample and the fraction of time the sensors spent converting (powered)
+ * instead of in power-down, next to what continuous mode at the same ODR would cost on
+ * the bus.
+ *
+ * Build from the repository root:
+ *   cc -O2 -std=c11 -pthread -I. -IMagnetometer_Driver bench/lis3mdl_sched_bench.c \
+ *      Magnetometer_Driver/lis3mdl_sched.c Magnetometer_Driver/lis3mdl.c \
+ *      i2c.c i2c_capture.c i2c_clock.c i2c_stats.c i2c_trace.c lis3mdl_sim.c -o lis3mdl_sched_bench
+ *
+ * Usage: lis3mdl_sched_bench [loop_hz] [window_us]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "i2c.h"
+#include "i2c_sim.h"
+#include "lis3mdl_sim.h"
+#include "lis3mdl.h"
+#include "lis3mdl_register.h"
+#include "lis3mdl_sched.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_SENSORS         4u
+#define BENCH_BUSES           2u
+#define BENCH_DURATION_NS     2000000000ull    /* Two seconds of virtual time */
+#define BENCH_DEFAULT_HZ      50u
+#define BENCH_DEFAULT_WINDOW  200u             /* us */
+#define BENCH_ODR_HZ          80.0             /* Continuous-mode rate of the speed setting below */
+
+static lis3mdl_sim_t bench_sim[BENCH_SENSORS];
+static Lis3mdlDevice_st bench_dev[BENCH_SENSORS];
+static uint64_t bench_latency_sum_ns;
+static uint64_t bench_latency_max_ns;
+static uint32_t bench_delivered;
+static uint32_t bench_failed;
+
+static void bench_done(status_t status, const Lis3mdlSample_st *sample, void *context)
+{
+    uint64_t due = (uint64_t)(uintptr_t)context;
+    uint64_t latency = i2c_sim_now_ns() - due;
+
+    (void)sample;
+    if (status != STATUS_OK) {
+        bench_failed++;
+        return;
+    }
+    bench_delivered++;
+    bench_latency_sum_ns += latency;
+    bench_latency_max_ns = (latency > bench_latency_max_ns) ? latency : bench_latency_max_ns;
+}
+
+int main(int argc, char **argv)
+{
+    static const uint8_t address[2] = { LIS3MDL_I2C_ADDRESS_SA1_LOW, LIS3MDL_I2C_ADDRESS_SA1_HIGH };
+    uint32_t loop_hz = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : BENCH_DEFAULT_HZ;
+    uint64_t window_ns = ((argc > 2) ? strtoull(argv[2], NULL, 0) : BENCH_DEFAULT_WINDOW) * 1000ull;
+    Lis3mdlSched_st sched;
+    Lis3mdlSpeedConfig_st speed = { LIS3MDL_ODR_80_HZ, LIS3MDL_MODE_LP, 0u };   /* 80 Hz, 12.5 ms conversion */
+    uint8_t device[BENCH_SENSORS];
+    uint64_t period_ns;
+    uint64_t tick_ns;
+    uint64_t start_ns;
+    uint64_t next_ns;
+    uint64_t bus_ns = 0u;
+    uint32_t transactions = 0u;
+    uint32_t requests = 0u;
+    i2c_sim_bus_stats_t stats;
+
+    if ((loop_hz == 0u) || (loop_hz > (uint32_t)BENCH_ODR_HZ)) {
+        fprintf(stderr, "usage: %s [loop_hz 1..%u] [window_us]\n", argv[0], (unsigned)BENCH_ODR_HZ);
+        return EXIT_FAILURE;
+    }
+    period_ns = 1000000000ull / loop_hz;
+
+    i2c_sim_detach_all();
+    Lis3mdlSchedInit(&sched, window_ns, i2c_sim_now_ns);
+    for (uint32_t i = 0; i < BENCH_SENSORS; ++i) {
+        uint8_t bus = (uint8_t)(i / 2u);
+
+        if ((lis3mdl_sim_init(&bench_sim[i], bus, address[i % 2u]) != STATUS_OK) ||
+            (Lis3mdlInit(&bench_dev[i], bus, address[i % 2u]) != STATUS_OK) ||
+            (Lis3mdlSetOutputDataRate(&bench_dev[i], speed) != STATUS_OK) ||
+            (Lis3mdlSchedAddDevice(&sched, &bench_dev[i], &device[i]) != STATUS_OK)) {
+            fprintf(stderr, "lis3mdl_sched_bench: failed to bring up sensor %u\n", i);
+            return EXIT_FAILURE;
+        }
+        lis3mdl_sim_set_field(&bench_sim[i], 0.25, -0.5, 0.4);
+    }
+    i2c_sim_reset_bus_stats();
+
+    start_ns = i2c_sim_now_ns() + period_ns;
+    tick_ns = start_ns;
+    next_ns = tick_ns;
+
+    while (tick_ns < (start_ns + BENCH_DURATION_NS)) {
+        uint64_t now = i2c_sim_now_ns();
+
+        if (now < next_ns) {
+            i2c_sim_advance(next_ns - now);
+            now = next_ns;
+        }
+
+        /* The control loop queues the next tick's samples one tick ahead */
+        if (now >= (tick_ns - period_ns)) {
+            for (uint32_t i = 0; i < BENCH_SENSORS; ++i) {
+                requests += (Lis3mdlSchedRequest(&sched, device[i], tick_ns, bench_done,
+                                                 (void *)(uintptr_t)tick_ns) == STATUS_OK);
+                if (i & 1u) {
+                    uint64_t due = tick_ns + (window_ns / 4u);
+
+                    requests += (Lis3mdlSchedRequest(&sched, device[i], due, bench_done,
+                                                     (void *)(uintptr_t)due) == STATUS_OK);
+                }
+            }
+            tick_ns += period_ns;
+        }
+
+        (void)Lis3mdlSchedPoll(&sched, i2c_sim_now_ns(), &next_ns);
+        next_ns = (next_ns < (tick_ns - period_ns)) ? next_ns : (tick_ns - period_ns);
+    }
+
+    /* Drain the conversions still in flight */
+    while ((Lis3mdlSchedPoll(&sched, i2c_sim_now_ns(), &next_ns) == STATUS_OK) && (next_ns != LIS3MDL_SCHED_NEVER)) {
+        uint64_t now = i2c_sim_now_ns();
+
+        i2c_sim_advance((next_ns > now) ? (next_ns - now) : 1u);
+    }
+
+    for (uint8_t bus = 0u; bus < BENCH_BUSES; ++bus) {
+        i2c_sim_get_bus_stats(bus, &stats);
+        bus_ns += stats.bus_ns;
+        transactions += stats.transactions;
+    }
+
+    printf("{\n  \"benchmark\": \"lis3mdl_sched\",\n  \"sensors\": %u,\n  \"loop_hz\": %u,\n  \"window_us\": %llu,\n",
+           BENCH_SENSORS, loop_hz, (unsigned long long)(window_ns / 1000u));
+    printf("  \"requests\": %u,\n  \"delivered\": %u,\n  \"failed\": %u,\n", requests, bench_delivered, bench_failed);
+    printf("  \"conversions\": %u,\n  \"coalesced\": %u,\n  \"not_ready_reads\": %u,\n",
+           sched.stats_st.triggers_u32, sched.stats_st.coalesced_u32, sched.stats_st.notReady_u32);
+    printf("  \"max_trigger_late_ns\": %llu,\n", (unsigned long long)sched.stats_st.maxLateNs_u64);
+    printf("  \"mean_latency_us\": %.1f,\n  \"max_latency_us\": %.1f,\n",
+           bench_delivered ? ((double)bench_latency_sum_ns / bench_delivered) / 1000.0 : 0.0,
+           (double)bench_latency_max_ns / 1000.0);
+    printf("  \"transactions_per_conversion\": %.2f,\n  \"bus_us_per_conversion\": %.1f,\n",
+           (double)transactions / sched.stats_st.triggers_u32,
+           ((double)bus_ns / sched.stats_st.triggers_u32) / 1000.0);
+    printf("  \"converting_duty\": %.4f,\n",
+           ((double)sched.stats_st.triggers_u32 * sched.device_ast[0].conversionNs_u64) /
+           ((double)BENCH_DURATION_NS * BENCH_SENSORS));
+    printf("  \"continuous_bus_us_per_s_per_sensor\": %.1f,\n",
+           (BENCH_ODR_HZ * (double)i2c_sim_transfer_ns(I2C_SIM_DEFAULT_BUS_HZ, 1u, LIS3MDL_STATUS_BURST_LEN)) / 1000.0);
+    printf("  \"sched_bus_us_per_s_per_sensor\": %.1f\n}\n",
+           ((double)bus_ns / 1000.0) / (((double)BENCH_DURATION_NS / 1e9) * BENCH_SENSORS));
+
+    return ((bench_failed == 0u) && (bench_delivered == requests)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,157 @@
+/*
+ * LIS3MDL temperature compensation benchmark.
+ *
+ * Builds a table from a known linear offset and gain drift, then times the batch kernel
+ * (Lis3mdlTcompApply, one temperature per batch) and the per-sample path
+ * (Lis3mdlTcompApplySamples, conversion folded in, temperature stepping every few
+ * samples as a decimated TEMP_OUT would) against a plain loop that looks the correction
+ * up for every sample, checking that all agree.
+ *
+ * Build from the repository root:
+ *   cc -O2 -std=c11 -I. -IMagnetometer_Driver bench/lis3mdl_tcomp_bench.c \
+ *      Magnetometer_Driver/lis3mdl_tcomp.c Magnetometer_Driver/lis3mdl.c \
+ *      i2c.c i2c_capture.c i2c_clock.c i2c_stats.c i2c_trace.c -pthread -lm -o lis3mdl_tcomp_bench
+ *
+ * Usage: lis3mdl_tcomp_bench [samples]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "i2c.h"
+#include "lis3mdl.h"
+#include "lis3mdl_tcomp.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_DEFAULT_SAMPLES  (1024u * 1024u)
+#define BENCH_BATCH            256u
+#define BENCH_REPEATS          5u
+#define BENCH_TEMP_RUN         16u       /* Samples sharing one TEMP_OUT reading */
+#define BENCH_LSB_PER_GAUSS    6842.0f   /* 4 gauss full scale */
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ull) + (uint64_t)ts.tv_nsec;
+}
+
+/* -40 to +85 degC in 5 degC steps, offsets and gains drifting linearly per axis */
+static void bench_build_table(Lis3mdlTcompTable_st *table)
+{
+    table->tempFirst_s16 = -520;
+    table->tempStep_u16 = 40u;
+    table->count_u16 = 26u;
+    for (uint32_t i = 0; i < table->count_u16; ++i) {
+        double degc = -40.0 + (5.0 * i) - 25.0;
+
+        for (uint32_t axis = 0; axis < 3u; ++axis) {
+            table->point_ast[i].offset_af32[axis] = (float)(0.002 * (axis + 1u) * degc);
+            table->point_ast[i].gain_af32[axis] = (float)(1.0 - (0.0004 * (axis + 1u) * degc));
+        }
+    }
+}
+
+static double bench_max_diff(const float *a, const float *b, size_t count)
+{
+    double max = 0.0;
+
+    for (size_t i = 0; i < count; ++i) {
+        double diff = fabs((double)a[i] - b[i]);
+
+        max = (diff > max) ? diff : max;
+    }
+    return max;
+}
+
+int main(int argc, char **argv)
+{
+    static Lis3mdlTcompTable_st table;
+    uint32_t count = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : BENCH_DEFAULT_SAMPLES;
+    size_t floats = 3u * (size_t)count;
+    Lis3mdlSample_st *samples = malloc(sizeof(*samples) * count);
+    float *field = malloc(sizeof(float) * floats);
+    float *out = malloc(sizeof(float) * floats);
+    float *out_samples = malloc(sizeof(float) * floats);
+    float *out_ref = malloc(sizeof(float) * floats);
+    uint64_t apply_ns = UINT64_MAX;
+    uint64_t samples_ns = UINT64_MAX;
+    uint64_t ref_ns;
+    uint64_t start;
+    double batch_diff;
+    double samples_diff;
+    int status_ok = 1;
+
+    if ((count < BENCH_BATCH) || !samples || !field || !out || !out_samples || !out_ref) {
+        fprintf(stderr, "usage: %s [samples >= %u]\n", argv[0], BENCH_BATCH);
+        return EXIT_FAILURE;
+    }
+
+    bench_build_table(&table);
+
+    /* Temperature sweeping the table range, one reading per BENCH_TEMP_RUN samples */
+    for (uint32_t i = 0; i < count; ++i) {
+        samples[i].xyz_st.x_s16 = (int16_t)((int32_t)(i * 37u % 20000u) - 10000);
+        samples[i].xyz_st.y_s16 = (int16_t)((int32_t)(i * 53u % 20000u) - 10000);
+        samples[i].xyz_st.z_s16 = (int16_t)((int32_t)(i * 71u % 20000u) - 10000);
+        samples[i].temperature_s16 = (int16_t)((int32_t)((i / BENCH_TEMP_RUN) % 1000u) - 520);
+        field[3u * i + 0u] = samples[i].xyz_st.x_s16 / BENCH_LSB_PER_GAUSS;
+        field[3u * i + 1u] = samples[i].xyz_st.y_s16 / BENCH_LSB_PER_GAUSS;
+        field[3u * i + 2u] = samples[i].xyz_st.z_s16 / BENCH_LSB_PER_GAUSS;
+    }
+
+    /* Reference: lookup and (m - o) * g for every sample */
+    start = bench_now_ns();
+    for (uint32_t i = 0; i < count; ++i) {
+        Lis3mdlTcompPoint_st point;
+
+        status_ok &= (Lis3mdlTcompLookup(&table, samples[i].temperature_s16, &point) == STATUS_OK);
+        for (uint32_t axis = 0; axis < 3u; ++axis) {
+            out_ref[3u * i + axis] = (field[3u * i + axis] - point.offset_af32[axis]) * point.gain_af32[axis];
+        }
+    }
+    ref_ns = bench_now_ns() - start;
+
+    for (uint32_t r = 0; r < BENCH_REPEATS; ++r) {
+        uint64_t elapsed;
+
+        start = bench_now_ns();
+        for (uint32_t i = 0; i < count; i += BENCH_TEMP_RUN) {
+            uint32_t batch = ((count - i) < BENCH_TEMP_RUN) ? (count - i) : BENCH_TEMP_RUN;
+
+            status_ok &= (Lis3mdlTcompApply(&table, samples[i].temperature_s16, &field[3u * i], &out[3u * i],
+                                            batch) == STATUS_OK);
+        }
+        elapsed = bench_now_ns() - start;
+        apply_ns = (elapsed < apply_ns) ? elapsed : apply_ns;
+
+        start = bench_now_ns();
+        status_ok &= (Lis3mdlTcompApplySamples(&table, LIS3MDL_SCALE_4G, samples, count, out_samples) == STATUS_OK);
+        elapsed = bench_now_ns() - start;
+        samples_ns = (elapsed < samples_ns) ? elapsed : samples_ns;
+    }
+
+    batch_diff = bench_max_diff(out, out_ref, floats);
+    samples_diff = bench_max_diff(out_samples, out_ref, floats);
+
+    printf("{\n  \"benchmark\": \"lis3mdl_tcomp\",\n  \"samples\": %u,\n  \"temperature_run\": %u,\n",
+           count, BENCH_TEMP_RUN);
+    printf("  \"lookup_per_sample_ns_per_sample\": %.3f,\n", (double)ref_ns / count);
+    printf("  \"apply_ns_per_sample\": %.3f,\n", (double)apply_ns / count);
+    printf("  \"apply_samples_ns_per_sample\": %.3f,\n", (double)samples_ns / count);
+    printf("  \"apply_max_diff_vs_reference\": %.3g,\n", batch_diff);
+    printf("  \"apply_samples_max_diff_vs_reference\": %.3g\n}\n", samples_diff);
+
+    free(samples);
+    free(field);
+    free(out);
+    free(out_samples);
+    free(out_ref);
+
+    return (status_ok && (batch_diff < 1e-5) && (samples_diff < 1e-5)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
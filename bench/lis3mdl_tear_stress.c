@@ -0,0 +1,242 @@
+/*
+ * Torn-sample stress run of the LIS3MDL read paths on the simulator.
+ *
+ * The simulated sensor converts at 1000 Hz FAST_ODR with every axis starting at the same
+ * value and stepping by 257 LSB per conversion, so both output bytes change on every
+ * conversion. Reads are issued at pseudo-random phases so conversions keep landing in
+ * the middle of transfers. An axis is torn when it is not base + k * 257 (low and high
+ * byte from different conversions: the large downstream spikes); a sample is also torn
+ * across axes when its axes disagree on k. Each read path is run with BDU off and on,
+ * at 100 kHz and 400 kHz; results are printed as JSON. The driver's burst reads are
+ * coherent with BDU on: the run fails if either of them returns a torn sample then.
+ *
+ * Build from the repository root:
+ *   cc -O2 -std=c11 -pthread -I. -IMagnetometer_Driver bench/lis3mdl_tear_stress.c \
+ *      i2c.c i2c_capture.c i2c_clock.c i2c_stats.c i2c_trace.c lis3mdl_sim.c \
+ *      Magnetometer_Driver/lis3mdl.c -o lis3mdl_tear_stress
+ *
+ * Usage: lis3mdl_tear_stress [samples per run]
+ */
+
+#include "i2c.h"
+#include "i2c_sim.h"
+#include "lis3mdl_sim.h"
+#include "lis3mdl.h"
+#include "lis3mdl_register.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define STRESS_BUS              0u
+#define STRESS_DEFAULT_SAMPLES  100000u
+#define STRESS_FIELD_GAUSS      (-4.0)
+#define STRESS_BASE_LSB         (-27368)     /* -4 gauss at 6842 LSB/gauss */
+#define STRESS_RAMP_LSB         257
+/*
+ * Conversions before the ramp saturates at INT16_MAX, less the few a read with BDU retries
+ * can span; the sensor is reset after that.
+ */
+#define STRESS_EPOCH_CONVERSIONS (((INT16_MAX - STRESS_BASE_LSB) / STRESS_RAMP_LSB) - 8)
+#define STRESS_MAX_GAP_NS       1200000u
+
+typedef status_t (*stress_read_fn)(Lis3mdlDevice_st *dev, Lis3mdlSampleXYZ_st *sample);
+
+typedef struct {
+    const char *name;
+    stress_read_fn read;
+    int coherent;              /* Must never return a torn sample with BDU on */
+} stress_path_t;
+
+typedef struct {
+    uint64_t samples;
+    uint64_t torn;             /* Samples torn in any way */
+    uint64_t torn_axis;        /* Samples with at least one torn axis */
+    uint64_t errors;           /* Reads refused, e.g. every BDU attempt split by a conversion */
+    uint64_t bus_ns;
+} stress_result_t;
+
+static lis3mdl_sim_t stress_sim;
+static Lis3mdlDevice_st stress_dev;
+static uint32_t stress_rng = 0x2545f491u;
+
+/* What Lis3mdlReadOutputData used to do: every byte in its own transaction. */
+static status_t stress_read_split_bytes(Lis3mdlDevice_st *dev, Lis3mdlSampleXYZ_st *sample)
+{
+    int16_t *axes[3] = { &sample->x_s16, &sample->y_s16, &sample->z_s16 };
+    status_t status = STATUS_OK;
+
+    for (uint8_t axis = 0; (axis < 3u) && (status == STATUS_OK); ++axis) {
+        uint8_t low;
+        uint8_t high;
+
+        status = i2c_bus_read(dev->bus_u8, dev->address_u8, (uint8_t)(LIS3MDL_OUT_X_L + (2u * axis)), 1u, &low);
+        if (status == STATUS_OK) {
+            status = i2c_bus_read(dev->bus_u8, dev->address_u8, (uint8_t)(LIS3MDL_OUT_X_H + (2u * axis)), 1u, &high);
+        }
+        *axes[axis] = (int16_t)((high << 8) | low);
+    }
+
+    return status;
+}
+
+static status_t stress_read_per_axis(Lis3mdlDevice_st *dev, Lis3mdlSampleXYZ_st *sample)
+{
+    status_t status = Lis3mdlReadOutputData(dev, LIS3MDL_OUT_AXIS_X, &sample->x_s16);
+
+    if (status == STATUS_OK) {
+        status = Lis3mdlReadOutputData(dev, LIS3MDL_OUT_AXIS_Y, &sample->y_s16);
+    }
+    if (status == STATUS_OK) {
+        status = Lis3mdlReadOutputData(dev, LIS3MDL_OUT_AXIS_Z, &sample->z_s16);
+    }
+
+    return status;
+}
+
+/* Status-gated burst; STATUS_DEFAULT when there is no new sample, which is not counted. */
+static status_t stress_read_status_burst(Lis3mdlDevice_st *dev, Lis3mdlSampleXYZ_st *sample)
+{
+    uint8_t new_data = 0u;
+    status_t status = Lis3mdlReadXYZIfReady(dev, sample, &new_data);
+
+    return ((status == STATUS_OK) && (new_data == 0u)) ? STATUS_DEFAULT : status;
+}
+
+static const stress_path_t stress_paths[] = {
+    { "split_bytes",    stress_read_split_bytes,  0 },
+    { "per_axis_burst", stress_read_per_axis,     0 },
+    { "xyz_burst",      Lis3mdlReadXYZ,           1 },
+    { "status_burst",   stress_read_status_burst, 1 },
+};
+
+static uint32_t stress_random(void)
+{
+    stress_rng ^= stress_rng << 13;
+    stress_rng ^= stress_rng >> 17;
+    stress_rng ^= stress_rng << 5;
+    return stress_rng;
+}
+
+static void stress_reset_sensor(uint8_t bdu)
+{
+    Lis3mdlShadow_st config_st;
+
+    i2c_sim_detach_all();
+    if ((lis3mdl_sim_init(&stress_sim, STRESS_BUS, LIS3MDL_I2C_ADDRESS_SA1_LOW) != STATUS_OK) ||
+        (Lis3mdlInit(&stress_dev, STRESS_BUS, LIS3MDL_I2C_ADDRESS_SA1_LOW) != STATUS_OK)) {
+        fprintf(stderr, "lis3mdl_tear_stress: failed to bring up the simulated sensor\n");
+        exit(EXIT_FAILURE);
+    }
+    lis3mdl_sim_set_field(&stress_sim, STRESS_FIELD_GAUSS, STRESS_FIELD_GAUSS, STRESS_FIELD_GAUSS);
+    lis3mdl_sim_set_ramp(&stress_sim, STRESS_RAMP_LSB);
+
+    config_st = stress_dev.shadow_st;
+    config_st.ctrlReg_au8[0] = LIS3MDL_CTRL1_FAST_ODR;
+    config_st.ctrlReg_au8[2] = LIS3MDL_CTRL3_MD_CONTINUOUS;
+    (void)Lis3mdlWriteConfig(&stress_dev, &config_st);
+    (void)Lis3mdlSetBlockDataUpdate(&stress_dev, bdu);
+}
+
+/* Returns 0 for a coherent sample, 1 when torn across axes only, 2 when an axis is torn. */
+static int stress_classify(const Lis3mdlSampleXYZ_st *sample)
+{
+    int32_t steps[3] = {
+        (int32_t)sample->x_s16 - STRESS_BASE_LSB,
+        (int32_t)sample->y_s16 - STRESS_BASE_LSB,
+        (int32_t)sample->z_s16 - STRESS_BASE_LSB,
+    };
+
+    for (uint32_t axis = 0; axis < 3u; ++axis) {
+        if ((steps[axis] < 0) || ((steps[axis] % STRESS_RAMP_LSB) != 0)) {
+            return 2;
+        }
+    }
+
+    return (steps[0] != steps[1]) || (steps[1] != steps[2]);
+}
+
+static stress_result_t stress_run(const stress_path_t *path, uint8_t bdu, uint32_t bus_hz, uint64_t samples)
+{
+    stress_result_t result = { 0 };
+
+    while (result.samples < samples) {
+        i2c_sim_bus_stats_t stats;
+
+        stress_reset_sensor(bdu);
+        i2c_sim_set_bus_speed(STRESS_BUS, bus_hz);
+        i2c_sim_reset_bus_stats();
+
+        /* Let the first conversion land before reading */
+        i2c_sim_advance(STRESS_MAX_GAP_NS);
+
+        while ((stress_sim.conversions < STRESS_EPOCH_CONVERSIONS) && (result.samples < samples)) {
+            Lis3mdlSampleXYZ_st sample;
+            status_t status = path->read(&stress_dev, &sample);
+
+            if (status == STATUS_OK) {
+                int torn = stress_classify(&sample);
+
+                result.samples++;
+                result.torn += (uint64_t)(torn != 0);
+                result.torn_axis += (uint64_t)(torn == 2);
+            } else if (status == STATUS_ERROR) {
+                result.errors++;
+            }
+            i2c_sim_advance(stress_random() % STRESS_MAX_GAP_NS);
+        }
+
+        i2c_sim_get_bus_stats(STRESS_BUS, &stats);
+        result.bus_ns += stats.bus_ns;
+    }
+
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    static const uint32_t bus_hz[] = { 100000u, 400000u };
+    size_t path_count = sizeof(stress_paths) / sizeof(stress_paths[0]);
+    uint64_t samples = STRESS_DEFAULT_SAMPLES;
+    uint32_t failures = 0u;
+    int first = 1;
+
+    if (argc > 1) {
+        samples = strtoull(argv[1], NULL, 0);
+        if (samples == 0u) {
+            fprintf(stderr, "usage: %s [samples per run]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("{\n  \"benchmark\": \"lis3mdl_tear_stress\",\n  \"samples_per_run\": %llu,\n  \"runs\": [\n",
+           (unsigned long long)samples);
+
+    for (size_t p = 0; p < path_count; ++p) {
+        for (uint8_t bdu = 0; bdu < 2u; ++bdu) {
+            for (size_t s = 0; s < (sizeof(bus_hz) / sizeof(bus_hz[0])); ++s) {
+                stress_result_t result = stress_run(&stress_paths[p], bdu, bus_hz[s], samples);
+                int must_be_coherent = stress_paths[p].coherent && (bdu != 0u);
+                int ok = !must_be_coherent || (result.torn == 0u);
+
+                failures += !ok;
+                printf("%s    {\"path\": \"%s\", \"bdu\": %u, \"bus_hz\": %u, \"samples\": %llu, "
+                       "\"torn\": %llu, \"torn_axis\": %llu, \"torn_ppm\": %.1f, \"errors\": %llu, "
+                       "\"bus_us_per_sample\": %.3f, \"must_be_coherent\": %s, \"ok\": %s}",
+                       first ? "" : ",\n",
+                       stress_paths[p].name, bdu, bus_hz[s],
+                       (unsigned long long)result.samples,
+                       (unsigned long long)result.torn,
+                       (unsigned long long)result.torn_axis,
+                       (1e6 * (double)result.torn) / (double)result.samples,
+                       (unsigned long long)result.errors,
+                       ((double)result.bus_ns / 1000.0) / (double)result.samples,
+                       must_be_coherent ? "true" : "false", ok ? "true" : "false");
+                first = 0;
+            }
+        }
+    }
+    printf("\n  ],\n  \"failures\": %u\n}\n", failures);
+
+    return (failures == 0u) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
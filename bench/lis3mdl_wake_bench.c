@@ -0,0 +1,163 @@
+/*
+ * LIS3MDL wake-on-field-change benchmark.
+ *
+ * One simulated sensor converts at 80 Hz and watches X and Z against a 0.5 gauss
+ * threshold (Lis3mdlWake*) for ten seconds of virtual time. The field is quiet except for
+ * two disturbances: X held at 0.8 gauss for 300 ms, then Z flickering across -0.5 gauss at
+ * every conversion for 200 ms. INT edges are taken from the simulator's pin callback and
+ * serviced from the main loop. Reports the edges, reads and events per disturbance, the
+ * edge-to-read latency and the bus time spent, next to what polling the status burst at
+ * every conversion would cost.
+ *
+ * Build from the repository root:
+ *   cc -O2 -std=c11 -pthread -I. -IMagnetometer_Driver bench/lis3mdl_wake_bench.c \
+ *      Magnetometer_Driver/lis3mdl_wake.c Magnetometer_Driver/lis3mdl.c \
+ *      i2c.c i2c_capture.c i2c_clock.c i2c_stats.c i2c_trace.c lis3mdl_sim.c -o lis3mdl_wake_bench
+ *
+ * Usage: lis3mdl_wake_bench [debounce_ms]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "i2c.h"
+#include "i2c_sim.h"
+#include "lis3mdl_sim.h"
+#include "lis3mdl.h"
+#include "lis3mdl_register.h"
+#include "lis3mdl_wake.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_BUS             0u
+#define BENCH_DURATION_NS     10000000000ull   /* Ten seconds of virtual time */
+#define BENCH_STEP_NS         1000000ull       /* Main loop tick when nothing is pending */
+#define BENCH_DEFAULT_DEBOUNCE 100u            /* ms */
+#define BENCH_ODR_HZ          80.0
+#define BENCH_THRESHOLD_GAUSS 0.5
+#define BENCH_X_START_NS      2000000000ull
+#define BENCH_X_END_NS        2300000000ull
+#define BENCH_Z_START_NS      5000000000ull
+#define BENCH_Z_END_NS        5200000000ull
+
+static lis3mdl_sim_t bench_sim;
+static uint64_t bench_edge_ns;
+static uint32_t bench_edge_pending;
+
+/* Runs with the bus simulation locked: only note the edge */
+static void bench_int(void *context, uint64_t now_ns)
+{
+    (void)context;
+    if (bench_edge_pending == 0u) {
+        bench_edge_ns = now_ns;
+    }
+    bench_edge_pending++;
+}
+
+static void bench_field(uint64_t t_ns, uint32_t conversion)
+{
+    double x = 0.1;
+    double z = 0.3;
+
+    if ((t_ns >= BENCH_X_START_NS) && (t_ns < BENCH_X_END_NS)) {
+        x = 0.8;
+    }
+    if ((t_ns >= BENCH_Z_START_NS) && (t_ns < BENCH_Z_END_NS)) {
+        z = (conversion & 1u) ? -0.55 : -0.45;
+    }
+    lis3mdl_sim_set_field(&bench_sim, x, -0.2, z);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t debounce_ns = ((argc > 1) ? strtoull(argv[1], NULL, 0) : BENCH_DEFAULT_DEBOUNCE) * 1000000ull;
+    Lis3mdlSpeedConfig_st speed = { LIS3MDL_ODR_80_HZ, LIS3MDL_MODE_LP, 0u };
+    Lis3mdlDevice_st dev;
+    Lis3mdlWake_st wake;
+    Lis3mdlWakeEvent_st event;
+    i2c_sim_bus_stats_t stats;
+    uint64_t start_ns;
+    uint64_t next_ns = LIS3MDL_WAKE_NEVER;
+    uint64_t latency_max_ns = 0u;
+    uint32_t events_x = 0u;
+    uint32_t events_z = 0u;
+    uint32_t events_quiet = 0u;
+    uint32_t failed = 0u;
+    uint16_t lsb_per_gauss;
+
+    i2c_sim_detach_all();
+    if ((lis3mdl_sim_init(&bench_sim, BENCH_BUS, LIS3MDL_I2C_ADDRESS_SA1_LOW) != STATUS_OK) ||
+        (Lis3mdlInit(&dev, BENCH_BUS, LIS3MDL_I2C_ADDRESS_SA1_LOW) != STATUS_OK) ||
+        (Lis3mdlSetOutputDataRate(&dev, speed) != STATUS_OK) ||
+        (Lis3mdlGetSensitivity(LIS3MDL_SCALE_4G, &lsb_per_gauss) != STATUS_OK)) {
+        fprintf(stderr, "lis3mdl_wake_bench: failed to bring up the sensor\n");
+        return EXIT_FAILURE;
+    }
+    lis3mdl_sim_set_int_callback(&bench_sim, bench_int, NULL);
+    bench_field(0u, 0u);
+
+    Lis3mdlWakeInit(&wake, &dev, debounce_ns);
+    if (Lis3mdlWakeStart(&wake, LIS3MDL_INT_CFG_XIEN | LIS3MDL_INT_CFG_ZIEN,
+                         (uint16_t)(BENCH_THRESHOLD_GAUSS * lsb_per_gauss)) != STATUS_OK) {
+        fprintf(stderr, "lis3mdl_wake_bench: failed to arm the threshold interrupt\n");
+        return EXIT_FAILURE;
+    }
+    bench_edge_pending = 0u;
+    i2c_sim_reset_bus_stats();
+    start_ns = i2c_sim_now_ns();
+
+    while ((i2c_sim_now_ns() - start_ns) < BENCH_DURATION_NS) {
+        uint64_t now = i2c_sim_now_ns();
+        uint64_t step = BENCH_STEP_NS;
+
+        if ((next_ns != LIS3MDL_WAKE_NEVER) && (next_ns > now) && ((next_ns - now) < step)) {
+            step = next_ns - now;
+        }
+        i2c_sim_advance(step);
+        bench_field(i2c_sim_now_ns() - start_ns, bench_sim.conversions);
+
+        if (bench_edge_pending != 0u) {
+            uint64_t edge_ns = bench_edge_ns;
+
+            bench_edge_pending = 0u;
+            failed += (Lis3mdlWakeHandleEdge(&wake, edge_ns, &next_ns) != STATUS_OK);
+        }
+        if (next_ns != LIS3MDL_WAKE_NEVER) {
+            failed += (Lis3mdlWakePoll(&wake, i2c_sim_now_ns(), &next_ns) != STATUS_OK);
+        }
+
+        while (Lis3mdlWakePop(&wake, &event) == STATUS_OK) {
+            uint64_t t = event.sample_st.timestamp_u64 - start_ns;
+            uint64_t latency = i2c_sim_now_ns() - event.sample_st.timestamp_u64;
+
+            latency_max_ns = (latency > latency_max_ns) ? latency : latency_max_ns;
+            if ((t >= BENCH_X_START_NS) && (t < (BENCH_X_END_NS + debounce_ns)) &&
+                (event.intSrc_u8 & LIS3MDL_INT_SRC_PTH_X)) {
+                events_x++;
+            } else if ((t >= BENCH_Z_START_NS) && (t < (BENCH_Z_END_NS + debounce_ns)) &&
+                       (event.intSrc_u8 & LIS3MDL_INT_SRC_NTH_Z)) {
+                events_z++;
+            } else {
+                events_quiet++;
+            }
+        }
+    }
+
+    i2c_sim_get_bus_stats(BENCH_BUS, &stats);
+
+    printf("{\n  \"benchmark\": \"lis3mdl_wake\",\n  \"odr_hz\": %.0f,\n  \"debounce_ms\": %llu,\n",
+           BENCH_ODR_HZ, (unsigned long long)(debounce_ns / 1000000u));
+    printf("  \"edges\": %u,\n  \"debounced\": %u,\n  \"reads\": %u,\n  \"spurious\": %u,\n  \"dropped\": %u,\n",
+           wake.stats_st.edges_u32, wake.stats_st.debounced_u32, wake.stats_st.reads_u32,
+           wake.stats_st.spurious_u32, wake.stats_st.dropped_u32);
+    printf("  \"events_x\": %u,\n  \"events_z\": %u,\n  \"events_quiet\": %u,\n", events_x, events_z, events_quiet);
+    printf("  \"max_edge_to_event_us\": %.1f,\n", (double)latency_max_ns / 1000.0);
+    printf("  \"transactions\": %u,\n  \"wake_bus_us_per_s\": %.2f,\n", stats.transactions,
+           ((double)stats.bus_ns / 1000.0) / ((double)BENCH_DURATION_NS / 1e9));
+    printf("  \"polling_bus_us_per_s\": %.1f\n}\n",
+           (BENCH_ODR_HZ * (double)i2c_sim_transfer_ns(I2C_SIM_DEFAULT_BUS_HZ, 1u, LIS3MDL_STATUS_BURST_LEN)) / 1000.0);
+
+    return ((failed == 0u) && (events_x != 0u) && (events_z != 0u) && (events_quiet == 0u)) ?
+           EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,7 +1,70 @@
 #include "i2c.h"
+#include "i2c_capture.h"
+#include "i2c_clock.h"
+#include "i2c_sim.h"
+#include "i2c_stats.h"
+#include "i2c_trace.h"
 
+#include <pthread.h>
 #include <stdint.h>
-#include <stdio.h>
+#include <stddef.h>
+
+/* Depth of the host async request queue. */
+#define I2C_ASYNC_QUEUE_LEN 16u
+
+typedef struct {
+    uint8_t is_write;
+    uint8_t bus_id;
+    uint8_t bus_address;
+    uint8_t register_address;
+    uint16_t length;
+    uint8_t *buffer;
+    i2c_callback_t callback;
+    void *context;
+} i2c_async_request_t;
+
+/* Host stub accounting of i2c_transfer usage; __atomic relaxed. */
+static uint32_t i2c_transfers;
+static uint32_t i2c_segments;
+
+typedef struct {
+    uint8_t bus_id;
+    uint8_t bus_address;
+    const i2c_sim_device_ops_t *ops;
+    void *device;
+} i2c_sim_slot_t;
+
+/*
+ * Host simulation: attached device models, virtual clock and per-bus cost model. The lock
+ * covers everything but the device lookup: device_count is published with release after
+ * the slot is filled, so i2c_run can find a device (or learn there is none) without it.
+ * Devices are attached and detached while no transfer is running.
+ */
+static struct {
+    pthread_mutex_t lock;
+    uint64_t now_ns;
+    uint32_t bus_hz[I2C_SIM_MAX_BUSES];
+    i2c_sim_bus_stats_t stats[I2C_SIM_MAX_BUSES];
+    uint32_t device_count;
+    i2c_sim_slot_t devices[I2C_SIM_MAX_DEVICES];
+} i2c_sim = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+/* Host async backend: a ring of pending requests drained by one worker thread. */
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_t worker;
+    int started;
+    int stopping;              /* i2c_async_shutdown is draining the queue */
+    uint32_t head;
+    uint32_t tail;
+    i2c_async_request_t queue[I2C_ASYNC_QUEUE_LEN];
+} i2c_async = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .not_empty = PTHREAD_COND_INITIALIZER,
+};
 
 status_t i2c_read(
     uint8_t bus_address,
@@ -9,35 +72,483 @@ status_t i2c_read(
     uint16_t length,
     uint8_t *buffer)
 {
-    printf(
-        "read [%d] bytes from bus [%d] for register [%d]\n",
+    return i2c_bus_read(
+        I2C_DEFAULT_BUS,
+        bus_address,
+        register_address,
         length,
+        buffer);
+}
+
+status_t i2c_write(
+    uint8_t bus_address,
+    uint8_t register_address,
+    uint16_t length,
+    uint8_t *buffer)
+{
+    return i2c_bus_write(
+        I2C_DEFAULT_BUS,
         bus_address,
-        register_address);
+        register_address,
+        length,
+        buffer);
+}
+
+/* Bits on the wire for one byte plus its ACK. */
+#define I2C_SIM_BITS_PER_BYTE 9u
+
+static uint64_t i2c_sim_bits_ns(uint32_t bus_hz, uint32_t bits)
+{
+    return ((uint64_t)bits * 1000000000ull) / bus_hz;
+}
 
-    /* Setting the output to some arbitrary value */
-    for (size_t i = 0; i < length; ++i) {
-        buffer[i] = 0xff;
+static uint32_t i2c_sim_bus_hz(uint8_t bus_id)
+{
+    uint32_t bus_hz = i2c_sim.bus_hz[bus_id];
+
+    return (bus_hz != 0u) ? bus_hz : I2C_SIM_DEFAULT_BUS_HZ;
+}
+
+static i2c_sim_slot_t *i2c_sim_find(uint8_t bus_id, uint8_t bus_address)
+{
+    uint32_t device_count = __atomic_load_n(&i2c_sim.device_count, __ATOMIC_ACQUIRE);
+
+    for (uint32_t i = 0; i < device_count; ++i) {
+        if ((i2c_sim.devices[i].bus_id == bus_id) &&
+            (i2c_sim.devices[i].bus_address == bus_address)) {
+            return &i2c_sim.devices[i];
+        }
     }
 
-    return STATUS_OK;
+    return NULL;
 }
 
-status_t i2c_write(
+/* Caller holds i2c_sim.lock. */
+static void i2c_sim_advance_locked(uint64_t delta_ns)
+{
+    i2c_sim.now_ns += delta_ns;
+
+    for (uint32_t i = 0; i < i2c_sim.device_count; ++i) {
+        if (i2c_sim.devices[i].ops->tick != NULL) {
+            i2c_sim.devices[i].ops->tick(i2c_sim.devices[i].device, i2c_sim.now_ns);
+        }
+    }
+}
+
+/*
+ * Play one register-addressed segment against a device model: START (a repeated-START
+ * after the first segment), header and data, without the STOP. The clock moves with
+ * the address phase and then with every data byte, so conversions can land mid-burst.
+ * Caller holds i2c_sim.lock.
+ */
+static void i2c_sim_segment(
+    i2c_sim_slot_t *slot,
+    uint8_t is_read,
+    uint8_t register_address,
+    uint16_t length,
+    uint8_t *buffer)
+{
+    uint32_t bus_hz = i2c_sim_bus_hz(slot->bus_id);
+    i2c_sim_bus_stats_t *stats = &i2c_sim.stats[slot->bus_id];
+    uint32_t header_bytes = 2u + is_read;   /* address+W, sub-address, [address+R] */
+
+    /* START or repeated-START (and repeated-START for reads) plus the header bytes */
+    i2c_sim_advance_locked(i2c_sim_bits_ns(
+        bus_hz, (1u + is_read) + (header_bytes * I2C_SIM_BITS_PER_BYTE)));
+    slot->ops->select(slot->device, register_address);
+
+    for (uint16_t i = 0; i < length; ++i) {
+        i2c_sim_advance_locked(i2c_sim_bits_ns(bus_hz, I2C_SIM_BITS_PER_BYTE));
+
+        if (is_read) {
+            buffer[i] = slot->ops->read_byte(slot->device);
+        } else {
+            slot->ops->write_byte(slot->device, buffer[i]);
+        }
+    }
+
+    stats->bytes += header_bytes + length;
+    stats->data_bytes += length;
+}
+
+/* STOP ending a transaction begun at start_ns. Caller holds i2c_sim.lock. */
+static void i2c_sim_stop(
+    i2c_sim_slot_t *slot,
+    uint64_t start_ns)
+{
+    i2c_sim_bus_stats_t *stats = &i2c_sim.stats[slot->bus_id];
+
+    i2c_sim_advance_locked(i2c_sim_bits_ns(i2c_sim_bus_hz(slot->bus_id), 1u));
+    if (slot->ops->stop != NULL) {
+        slot->ops->stop(slot->device);
+    }
+
+    stats->transactions++;
+    stats->bus_ns += i2c_sim.now_ns - start_ns;
+}
+
+status_t i2c_sim_attach(
+    uint8_t bus_id,
+    uint8_t bus_address,
+    const i2c_sim_device_ops_t *ops,
+    void *device)
+{
+    status_t status = STATUS_ERROR;
+
+    pthread_mutex_lock(&i2c_sim.lock);
+
+    if ((bus_id < I2C_SIM_MAX_BUSES) &&
+        (i2c_sim.device_count < I2C_SIM_MAX_DEVICES) &&
+        (i2c_sim_find(bus_id, bus_address) == NULL)) {
+        i2c_sim_slot_t *slot = &i2c_sim.devices[i2c_sim.device_count];
+
+        slot->bus_id = bus_id;
+        slot->bus_address = bus_address;
+        slot->ops = ops;
+        slot->device = device;
+        __atomic_store_n(&i2c_sim.device_count, i2c_sim.device_count + 1u, __ATOMIC_RELEASE);
+        status = STATUS_OK;
+    }
+
+    pthread_mutex_unlock(&i2c_sim.lock);
+    return status;
+}
+
+void i2c_sim_detach_all(void)
+{
+    pthread_mutex_lock(&i2c_sim.lock);
+    __atomic_store_n(&i2c_sim.device_count, 0u, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&i2c_sim.lock);
+}
+
+void i2c_sim_set_bus_speed(
+    uint8_t bus_id,
+    uint32_t bus_hz)
+{
+    if (bus_id < I2C_SIM_MAX_BUSES) {
+        pthread_mutex_lock(&i2c_sim.lock);
+        i2c_sim.bus_hz[bus_id] = bus_hz;
+        pthread_mutex_unlock(&i2c_sim.lock);
+    }
+}
+
+uint64_t i2c_sim_now_ns(void)
+{
+    uint64_t now_ns;
+
+    pthread_mutex_lock(&i2c_sim.lock);
+    now_ns = i2c_sim.now_ns;
+    pthread_mutex_unlock(&i2c_sim.lock);
+
+    return now_ns;
+}
+
+void i2c_sim_advance(uint64_t delta_ns)
+{
+    pthread_mutex_lock(&i2c_sim.lock);
+    i2c_sim_advance_locked(delta_ns);
+    pthread_mutex_unlock(&i2c_sim.lock);
+}
+
+void i2c_sim_get_bus_stats(
+    uint8_t bus_id,
+    i2c_sim_bus_stats_t *stats)
+{
+    i2c_sim_bus_stats_t empty = { 0 };
+
+    pthread_mutex_lock(&i2c_sim.lock);
+    *stats = (bus_id < I2C_SIM_MAX_BUSES) ? i2c_sim.stats[bus_id] : empty;
+    pthread_mutex_unlock(&i2c_sim.lock);
+}
+
+void i2c_sim_reset_bus_stats(void)
+{
+    pthread_mutex_lock(&i2c_sim.lock);
+    for (uint32_t i = 0; i < I2C_SIM_MAX_BUSES; ++i) {
+        i2c_sim_bus_stats_t empty = { 0 };
+        i2c_sim.stats[i] = empty;
+    }
+    pthread_mutex_unlock(&i2c_sim.lock);
+}
+
+uint64_t i2c_sim_transfer_ns(
+    uint32_t bus_hz,
+    uint8_t is_read,
+    uint16_t length)
+{
+    uint32_t bits = (1u + is_read) + 1u
+        + ((2u + is_read + length) * I2C_SIM_BITS_PER_BYTE);
+
+    return i2c_sim_bits_ns(bus_hz, bits);
+}
+
+/*
+ * Run count segments as one bus transaction. Every segment is served from the replay
+ * capture when one is active, otherwise played against the simulated device at the
+ * address, otherwise by the default stub. Only the first two touch shared state, so
+ * only they hold the simulation lock, for the whole list so nothing interleaves. Each
+ * segment is captured, traced and counted on its own once the lock is released.
+ */
+static status_t i2c_run(
+    uint8_t bus_id,
+    uint8_t bus_address,
+    i2c_msg_t *msgs,
+    uint16_t count)
+{
+    status_t status = STATUS_OK;
+    i2c_sim_slot_t *slot = i2c_sim_find(bus_id, bus_address);
+    int locked = (slot != NULL) || i2c_replay_is_active();
+    uint64_t start[I2C_TRANSFER_MAX_SEGMENTS];
+    uint64_t start_ns = 0u;
+    uint16_t done = 0u;
+    uint32_t played = 0u;
+
+    if (locked) {
+        pthread_mutex_lock(&i2c_sim.lock);
+        start_ns = i2c_sim.now_ns;
+    }
+
+    for (; (done < count) && (status == STATUS_OK); ++done) {
+        uint8_t is_read = (msgs[done].flags & I2C_MSG_READ) ? 1u : 0u;
+
+        start[done] = i2c_clock_ticks();
+
+        if (!i2c_replay_serve(is_read, bus_id, bus_address, msgs[done].register_address,
+                              msgs[done].length, msgs[done].buffer, &status)) {
+            status = STATUS_OK;
+
+            if (slot != NULL) {
+                i2c_sim_segment(slot, is_read, msgs[done].register_address, msgs[done].length, msgs[done].buffer);
+                played++;
+            } else if (is_read) {
+                /* Setting the output to some arbitrary value */
+                for (size_t j = 0; j < msgs[done].length; ++j) {
+                    msgs[done].buffer[j] = 0xff;
+                }
+            }
+            /* Writes to an address with no simulated device are discarded */
+        }
+    }
+
+    if (played != 0u) {
+        i2c_sim_stop(slot, start_ns);
+    }
+
+    if (locked) {
+        pthread_mutex_unlock(&i2c_sim.lock);
+    }
+
+    /* Every segment before the last one run succeeded */
+    for (uint16_t i = 0; i < done; ++i) {
+        uint8_t is_read = (msgs[i].flags & I2C_MSG_READ) ? 1u : 0u;
+        status_t segment_status = ((i + 1u) == done) ? status : STATUS_OK;
+
+        i2c_capture_record(is_read ? 0u : I2C_CAPTURE_WRITE, bus_id, bus_address,
+                           msgs[i].register_address, msgs[i].length, msgs[i].buffer, segment_status);
+        i2c_trace_record(start[i], is_read ? 0u : I2C_TRACE_WRITE, bus_id, bus_address,
+                         msgs[i].register_address, msgs[i].length, segment_status);
+        I2C_STATS_RECORD(bus_id, msgs[i].register_address, is_read, msgs[i].length, segment_status, start[i]);
+    }
+
+    return status;
+}
+
+status_t i2c_bus_read(
+    uint8_t bus_id,
     uint8_t bus_address,
     uint8_t register_address,
     uint16_t length,
     uint8_t *buffer)
 {
-    printf(
-        "write [%d] bytes to bus [%d] for register [%d]\n\t",
-        length,
-        bus_address,
-        register_address);
+    i2c_msg_t msg = { register_address, I2C_MSG_READ, length, buffer };
+
+    return i2c_run(bus_id, bus_address, &msg, 1u);
+}
+
+status_t i2c_bus_write(
+    uint8_t bus_id,
+    uint8_t bus_address,
+    uint8_t register_address,
+    uint16_t length,
+    uint8_t *buffer)
+{
+    i2c_msg_t msg = { register_address, I2C_MSG_WRITE, length, buffer };
 
-    for (size_t i = 0; i < length; ++i) {
-        printf("%p", buffer);
+    return i2c_run(bus_id, bus_address, &msg, 1u);
+}
+
+status_t i2c_transfer(
+    uint8_t bus_id,
+    uint8_t bus_address,
+    i2c_msg_t *msgs,
+    uint16_t count)
+{
+    if (count > I2C_TRANSFER_MAX_SEGMENTS) {
+        return STATUS_ERROR;
     }
-    printf("\n");
+
+    /* START, then a repeated-START before every further segment, STOP at the end */
+    (void)__atomic_fetch_add(&i2c_transfers, 1u, __ATOMIC_RELAXED);
+    (void)__atomic_fetch_add(&i2c_segments, count, __ATOMIC_RELAXED);
+
+    return i2c_run(bus_id, bus_address, msgs, count);
+}
+
+void i2c_get_transfer_counts(
+    uint32_t *transfers,
+    uint32_t *segments)
+{
+    *transfers = __atomic_load_n(&i2c_transfers, __ATOMIC_RELAXED);
+    *segments = __atomic_load_n(&i2c_segments, __ATOMIC_RELAXED);
+}
+
+static void *i2c_async_worker(void *arg)
+{
+    (void)arg;
+
+    for (;;) {
+        i2c_async_request_t request;
+        status_t status;
+
+        pthread_mutex_lock(&i2c_async.lock);
+        while ((i2c_async.head == i2c_async.tail) && !i2c_async.stopping) {
+            pthread_cond_wait(&i2c_async.not_empty, &i2c_async.lock);
+        }
+        /* Requests queued before the shutdown still complete */
+        if (i2c_async.head == i2c_async.tail) {
+            pthread_mutex_unlock(&i2c_async.lock);
+            break;
+        }
+        request = i2c_async.queue[i2c_async.tail % I2C_ASYNC_QUEUE_LEN];
+        i2c_async.tail++;
+        pthread_mutex_unlock(&i2c_async.lock);
+
+        if (request.is_write) {
+            status = i2c_bus_write(
+                request.bus_id,
+                request.bus_address,
+                request.register_address,
+                request.length,
+                request.buffer);
+        } else {
+            status = i2c_bus_read(
+                request.bus_id,
+                request.bus_address,
+                request.register_address,
+                request.length,
+                request.buffer);
+        }
+
+        if (request.callback != NULL) {
+            request.callback(status, request.context);
+        }
+    }
+
+    return NULL;
+}
+
+static status_t i2c_async_submit(const i2c_async_request_t *request)
+{
+    status_t status = STATUS_OK;
+
+    pthread_mutex_lock(&i2c_async.lock);
+
+    if (i2c_async.stopping) {
+        status = STATUS_ERROR;
+    } else if (!i2c_async.started) {
+        if (pthread_create(&i2c_async.worker, NULL, i2c_async_worker, NULL) == 0) {
+            i2c_async.started = 1;
+        } else {
+            status = STATUS_ERROR;
+        }
+    }
+
+    if (status == STATUS_OK) {
+        if (i2c_async.head - i2c_async.tail >= I2C_ASYNC_QUEUE_LEN) {
+            status = STATUS_ERROR;
+        } else {
+            i2c_async.queue[i2c_async.head % I2C_ASYNC_QUEUE_LEN] = *request;
+            i2c_async.head++;
+            pthread_cond_signal(&i2c_async.not_empty);
+        }
+    }
+
+    pthread_mutex_unlock(&i2c_async.lock);
+    return status;
+}
+
+status_t i2c_async_shutdown(void)
+{
+    pthread_t worker;
+
+    pthread_mutex_lock(&i2c_async.lock);
+
+    if (!i2c_async.started) {
+        pthread_mutex_unlock(&i2c_async.lock);
+        return STATUS_OK;
+    }
+    /* A second shutdown, or one from a completion callback, cannot join the worker */
+    if (i2c_async.stopping || pthread_equal(pthread_self(), i2c_async.worker)) {
+        pthread_mutex_unlock(&i2c_async.lock);
+        return STATUS_ERROR;
+    }
+    i2c_async.stopping = 1;
+    worker = i2c_async.worker;
+    pthread_cond_signal(&i2c_async.not_empty);
+    pthread_mutex_unlock(&i2c_async.lock);
+
+    pthread_join(worker, NULL);
+
+    pthread_mutex_lock(&i2c_async.lock);
+    i2c_async.started = 0;
+    i2c_async.stopping = 0;
+    pthread_mutex_unlock(&i2c_async.lock);
+
     return STATUS_OK;
 }
+
+status_t i2c_read_async(
+    uint8_t bus_id,
+    uint8_t bus_address,
+    uint8_t register_address,
+    uint16_t length,
+    uint8_t *buffer,
+    i2c_callback_t callback,
+    void *context)
+{
+    i2c_async_request_t request = {
+        .is_write = 0,
+        .bus_id = bus_id,
+        .bus_address = bus_address,
+        .register_address = register_address,
+        .length = length,
+        .buffer = buffer,
+        .callback = callback,
+        .context = context,
+    };
+
+    return i2c_async_submit(&request);
+}
+
+status_t i2c_write_async(
+    uint8_t bus_id,
+    uint8_t bus_address,
+    uint8_t register_address,
+    uint16_t length,
+    uint8_t *buffer,
+    i2c_callback_t callback,
+    void *context)
+{
+    i2c_async_request_t request = {
+        .is_write = 1,
+        .bus_id = bus_id,
+        .bus_address = bus_address,
+        .register_address = register_address,
+        .length = length,
+        .buffer = buffer,
+        .callback = callback,
+        .context = context,
+    };
+
+    return i2c_async_submit(&request);
+}
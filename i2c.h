@@ -3,12 +3,38 @@
 
 #include <stdint.h>
 
+/* Bus used by the single-bus i2c_read/i2c_write calls. */
+#define I2C_DEFAULT_BUS 0u
+
 typedef enum {
     STATUS_OK,
     STATUS_ERROR,
 	STATUS_DEFAULT
 } status_t;
 
+/* i2c_msg_t.flags */
+#define I2C_MSG_WRITE 0x00u
+#define I2C_MSG_READ  0x01u
+
+/*
+ * One register-addressed segment of an i2c_transfer: the register address is written,
+ * then length bytes are written from or read into buffer depending on flags.
+ */
+typedef struct {
+    uint8_t register_address;
+    uint8_t flags;
+    uint16_t length;
+    uint8_t *buffer;
+} i2c_msg_t;
+
+/*
+ * Completion callback for the asynchronous calls. Invoked once per submitted request,
+ * from the backend's completion context (a worker thread on the host, typically an
+ * ISR or DMA-complete handler on target), with the transfer status and the context
+ * pointer given at submission.
+ */
+typedef void (*i2c_callback_t)(status_t status, void *context);
+
 status_t i2c_read(
     uint8_t bus_address,
     uint8_t register_address,
@@ -21,4 +47,71 @@ status_t i2c_write(
     uint16_t length,
     uint8_t *buffer);
 
+/* Same as i2c_read/i2c_write, for a device on the bus identified by bus_id. */
+status_t i2c_bus_read(
+    uint8_t bus_id,
+    uint8_t bus_address,
+    uint8_t register_address,
+    uint16_t length,
+    uint8_t *buffer);
+
+status_t i2c_bus_write(
+    uint8_t bus_id,
+    uint8_t bus_address,
+    uint8_t register_address,
+    uint16_t length,
+    uint8_t *buffer);
+
+/* Longest segment list i2c_transfer accepts. */
+#define I2C_TRANSFER_MAX_SEGMENTS 16u
+
+/*
+ * Run count segments against one device as a single bus operation: segments are joined
+ * by repeated-start with a single STOP at the end, so no other master can interleave.
+ * Stops at the first failing segment; more than I2C_TRANSFER_MAX_SEGMENTS is an error.
+ * On the host, a list addressed to a simulated device (or served from a replay) runs
+ * under the bus simulation lock and counts as one transaction in the simulated bus
+ * statistics.
+ */
+status_t i2c_transfer(
+    uint8_t bus_id,
+    uint8_t bus_address,
+    i2c_msg_t *msgs,
+    uint16_t count);
+
+/* Host stub only: number of i2c_transfer calls and segments run so far. */
+void i2c_get_transfer_counts(
+    uint32_t *transfers,
+    uint32_t *segments);
+
+/*
+ * Non-blocking variants: queue the transfer and return immediately. STATUS_ERROR means
+ * the request could not be queued and the callback will not be invoked. The buffer must
+ * remain valid until the callback runs.
+ */
+status_t i2c_read_async(
+    uint8_t bus_id,
+    uint8_t bus_address,
+    uint8_t register_address,
+    uint16_t length,
+    uint8_t *buffer,
+    i2c_callback_t callback,
+    void *context);
+
+status_t i2c_write_async(
+    uint8_t bus_id,
+    uint8_t bus_address,
+    uint8_t register_address,
+    uint16_t length,
+    uint8_t *buffer,
+    i2c_callback_t callback,
+    void *context);
+
+/*
+ * Complete every queued request, then stop the host worker thread and wait for it.
+ * Submissions made meanwhile fail; a later one starts a new worker. Returns STATUS_ERROR
+ * when called from a completion callback or while another shutdown is running.
+ */
+status_t i2c_async_shutdown(void);
+
 #endif
@@ -0,0 +1,267 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "i2c_capture.h"
+#include "i2c_clock.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * Recording side: records are appended through a buffered stream under one lock. The
+ * file stays open from start to stop; active drops on the first failed write, which is
+ * latched in failed and reported by i2c_capture_stop.
+ */
+static struct {
+    pthread_mutex_t lock;
+    int active;
+    int failed;
+    FILE *file;
+    uint64_t last_ns;
+} i2c_capture = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+/* Replay side: the whole capture is mapped read-only and consumed with a cursor. */
+static struct {
+    pthread_mutex_t lock;
+    int active;
+    const uint8_t *base;
+    size_t size;
+    size_t offset;
+    i2c_replay_stats_t stats;
+} i2c_replay = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+status_t i2c_capture_start(const char *path)
+{
+    i2c_capture_file_header_t header = {
+        .magic = I2C_CAPTURE_MAGIC,
+        .version = I2C_CAPTURE_VERSION,
+    };
+    status_t status = STATUS_ERROR;
+
+    pthread_mutex_lock(&i2c_capture.lock);
+
+    if (i2c_capture.file == NULL) {
+        i2c_capture.file = fopen(path, "wb");
+        if (i2c_capture.file != NULL) {
+            if (fwrite(&header, sizeof(header), 1u, i2c_capture.file) == 1u) {
+                i2c_capture.last_ns = i2c_clock_now_ns();
+                i2c_capture.failed = 0;
+                __atomic_store_n(&i2c_capture.active, 1, __ATOMIC_RELEASE);
+                status = STATUS_OK;
+            } else {
+                fclose(i2c_capture.file);
+                i2c_capture.file = NULL;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&i2c_capture.lock);
+    return status;
+}
+
+status_t i2c_capture_stop(void)
+{
+    status_t status = STATUS_ERROR;
+
+    pthread_mutex_lock(&i2c_capture.lock);
+
+    if (i2c_capture.file != NULL) {
+        __atomic_store_n(&i2c_capture.active, 0, __ATOMIC_RELEASE);
+        status = ((fclose(i2c_capture.file) == 0) && !i2c_capture.failed) ? STATUS_OK : STATUS_ERROR;
+        i2c_capture.file = NULL;
+    }
+
+    pthread_mutex_unlock(&i2c_capture.lock);
+    return status;
+}
+
+void i2c_capture_record(
+    uint8_t flags,
+    uint8_t bus_id,
+    uint8_t bus_address,
+    uint8_t register_address,
+    uint16_t length,
+    const uint8_t *buffer,
+    status_t status)
+{
+    i2c_capture_record_t record;
+    uint64_t now_ns;
+    uint64_t delta_us;
+
+    if (!__atomic_load_n(&i2c_capture.active, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    now_ns = i2c_clock_now_ns();
+
+    pthread_mutex_lock(&i2c_capture.lock);
+
+    if (i2c_capture.active) {
+        delta_us = (now_ns > i2c_capture.last_ns) ? ((now_ns - i2c_capture.last_ns) / 1000u) : 0u;
+        /* Keep the sub-microsecond remainder so the captured timeline does not drift */
+        i2c_capture.last_ns += delta_us * 1000u;
+
+        record.delta_us = (delta_us > UINT32_MAX) ? UINT32_MAX : (uint32_t)delta_us;
+        record.flags = flags;
+        record.bus_id = bus_id;
+        record.bus_address = bus_address;
+        record.register_address = register_address;
+        record.length = length;
+        record.status = (uint8_t)status;
+        record.reserved = 0u;
+
+        /* A short write leaves a truncated last record, which readers stop at */
+        if ((fwrite(&record, sizeof(record), 1u, i2c_capture.file) != 1u) ||
+            (fwrite(buffer, 1u, length, i2c_capture.file) != length)) {
+            i2c_capture.failed = 1;
+            __atomic_store_n(&i2c_capture.active, 0, __ATOMIC_RELEASE);
+        }
+    }
+
+    pthread_mutex_unlock(&i2c_capture.lock);
+}
+
+status_t i2c_replay_open(const char *path)
+{
+    const i2c_capture_file_header_t *header;
+    struct stat info;
+    void *base;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return STATUS_ERROR;
+    }
+
+    if ((fstat(fd, &info) != 0) || ((size_t)info.st_size < sizeof(*header))) {
+        close(fd);
+        return STATUS_ERROR;
+    }
+
+    base = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return STATUS_ERROR;
+    }
+
+    header = base;
+    if ((memcmp(header->magic, I2C_CAPTURE_MAGIC, sizeof(header->magic)) != 0) ||
+        (header->version != I2C_CAPTURE_VERSION)) {
+        munmap(base, (size_t)info.st_size);
+        return STATUS_ERROR;
+    }
+
+    /* Replays walk the file once, front to back */
+    (void)posix_madvise(base, (size_t)info.st_size, POSIX_MADV_SEQUENTIAL);
+
+    i2c_replay_close();
+
+    pthread_mutex_lock(&i2c_replay.lock);
+    i2c_replay.base = base;
+    i2c_replay.size = (size_t)info.st_size;
+    i2c_replay.offset = sizeof(*header);
+    memset(&i2c_replay.stats, 0, sizeof(i2c_replay.stats));
+    __atomic_store_n(&i2c_replay.active, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&i2c_replay.lock);
+
+    return STATUS_OK;
+}
+
+void i2c_replay_close(void)
+{
+    pthread_mutex_lock(&i2c_replay.lock);
+
+    if (i2c_replay.active) {
+        __atomic_store_n(&i2c_replay.active, 0, __ATOMIC_RELEASE);
+        munmap((void *)i2c_replay.base, i2c_replay.size);
+        i2c_replay.base = NULL;
+    }
+
+    pthread_mutex_unlock(&i2c_replay.lock);
+}
+
+int i2c_replay_is_active(void)
+{
+    return __atomic_load_n(&i2c_replay.active, __ATOMIC_ACQUIRE);
+}
+
+int i2c_replay_serve(
+    uint8_t is_read,
+    uint8_t bus_id,
+    uint8_t bus_address,
+    uint8_t register_address,
+    uint16_t length,
+    uint8_t *buffer,
+    status_t *status)
+{
+    i2c_capture_record_t record;
+    const uint8_t *payload;
+    int matches;
+
+    if (!__atomic_load_n(&i2c_replay.active, __ATOMIC_ACQUIRE)) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&i2c_replay.lock);
+
+    if (!i2c_replay.active) {
+        pthread_mutex_unlock(&i2c_replay.lock);
+        return 0;
+    }
+
+    *status = STATUS_ERROR;
+
+    if ((i2c_replay.size - i2c_replay.offset) < sizeof(record)) {
+        /* Capture exhausted */
+        i2c_replay.stats.divergences++;
+        pthread_mutex_unlock(&i2c_replay.lock);
+        return 1;
+    }
+
+    /* Records are packed back to back, so they are not necessarily aligned */
+    memcpy(&record, i2c_replay.base + i2c_replay.offset, sizeof(record));
+    payload = i2c_replay.base + i2c_replay.offset + sizeof(record);
+
+    matches = ((record.flags & I2C_CAPTURE_WRITE) == (is_read ? 0u : I2C_CAPTURE_WRITE)) &&
+              (record.bus_id == bus_id) &&
+              (record.bus_address == bus_address) &&
+              (record.register_address == register_address) &&
+              (record.length == length) &&
+              ((i2c_replay.size - i2c_replay.offset - sizeof(record)) >= length);
+
+    if (matches && !is_read) {
+        matches = (memcmp(payload, buffer, length) == 0);
+    }
+
+    if (matches) {
+        if (is_read) {
+            memcpy(buffer, payload, length);
+        }
+        *status = (status_t)record.status;
+        i2c_replay.offset += sizeof(record) + length;
+        i2c_replay.stats.transactions++;
+        i2c_replay.stats.capture_us += record.delta_us;
+    } else {
+        i2c_replay.stats.divergences++;
+    }
+
+    pthread_mutex_unlock(&i2c_replay.lock);
+    return 1;
+}
+
+void i2c_replay_get_stats(i2c_replay_stats_t *stats)
+{
+    pthread_mutex_lock(&i2c_replay.lock);
+    *stats = i2c_replay.stats;
+    stats->bytes_left = i2c_replay.active ? (i2c_replay.size - i2c_replay.offset) : 0u;
+    pthread_mutex_unlock(&i2c_replay.lock);
+}
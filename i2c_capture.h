@@ -0,0 +1,93 @@
+#ifndef I2C_CAPTURE_HEADER_H
+#define I2C_CAPTURE_HEADER_H
+
+/*
+ * I2C traffic capture and deterministic replay behind i2c_bus_read/i2c_bus_write.
+ *
+ * While a capture is running every transaction is appended to a binary file together
+ * with its payload: the bytes returned for reads, the bytes sent for writes. A replay
+ * maps such a file and serves the transactions back in order instead of the bus, so a
+ * processing pipeline sees bit-identical inputs on every run, as fast as it can consume
+ * them. Requests that do not match the next captured transaction fail with STATUS_ERROR
+ * and are counted as divergences; the replay does not move past them.
+ *
+ * File layout: i2c_capture_file_header_t, then for each transaction an
+ * i2c_capture_record_t followed by length payload bytes.
+ */
+
+#include "i2c.h"
+
+#include <stdint.h>
+
+#define I2C_CAPTURE_MAGIC      "I2CCAPT"
+#define I2C_CAPTURE_VERSION    1u
+
+/* i2c_capture_record_t.flags */
+#define I2C_CAPTURE_WRITE      0x01u
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+} i2c_capture_file_header_t;
+
+typedef struct {
+    uint32_t delta_us;         /* Time since the previous record, saturated */
+    uint8_t flags;
+    uint8_t bus_id;
+    uint8_t bus_address;
+    uint8_t register_address;
+    uint16_t length;
+    uint8_t status;
+    uint8_t reserved;
+} i2c_capture_record_t;
+
+typedef struct {
+    uint64_t transactions;     /* Transactions served */
+    uint64_t divergences;      /* Requests that did not match the capture */
+    uint64_t capture_us;       /* Captured time of the last served transaction */
+    uint64_t bytes_left;       /* Unread part of the capture */
+} i2c_replay_stats_t;
+
+status_t i2c_capture_start(const char *path);
+
+/*
+ * Close the capture. Recording stops at the first write that fails (e.g. a full disk);
+ * the file then ends at that record and STATUS_ERROR is returned here.
+ */
+status_t i2c_capture_stop(void);
+
+/* Called by the i2c layer after every transaction; no-op unless a capture is running. */
+void i2c_capture_record(
+    uint8_t flags,
+    uint8_t bus_id,
+    uint8_t bus_address,
+    uint8_t register_address,
+    uint16_t length,
+    const uint8_t *buffer,
+    status_t status);
+
+/* Map path and serve every following transaction from it until i2c_replay_close. */
+status_t i2c_replay_open(const char *path);
+
+void i2c_replay_close(void);
+
+/* 1 while a replay is open. */
+int i2c_replay_is_active(void);
+
+/*
+ * Returns 1 and sets *status when a replay is open and the request was answered from
+ * it (including by a divergence error), 0 to fall through to the bus.
+ */
+int i2c_replay_serve(
+    uint8_t is_read,
+    uint8_t bus_id,
+    uint8_t bus_address,
+    uint8_t register_address,
+    uint16_t length,
+    uint8_t *buffer,
+    status_t *status);
+
+void i2c_replay_get_stats(i2c_replay_stats_t *stats);
+
+#endif
@@ -0,0 +1,47 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "i2c_clock.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <time.h>
+
+static pthread_once_t i2c_clock_calibrated = PTHREAD_ONCE_INIT;
+static uint64_t i2c_clock_tick_hz;
+
+/* Measure the tick rate against the monotonic clock once. */
+static void i2c_clock_calibrate(void)
+{
+#if defined(__aarch64__)
+    uint64_t frequency;
+
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    i2c_clock_tick_hz = frequency;
+#elif defined(__x86_64__) || defined(__i386__)
+    uint64_t start_ns = i2c_clock_now_ns();
+    uint64_t start_ticks = i2c_clock_ticks();
+    uint64_t elapsed_ns;
+
+    do {
+        elapsed_ns = i2c_clock_now_ns() - start_ns;
+    } while (elapsed_ns < 10000000u);
+
+    i2c_clock_tick_hz = ((i2c_clock_ticks() - start_ticks) * 1000000000ull) / elapsed_ns;
+#else
+    i2c_clock_tick_hz = 1000000000ull;
+#endif
+}
+
+uint64_t i2c_clock_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ull) + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t i2c_clock_ticks_per_second(void)
+{
+    pthread_once(&i2c_clock_calibrated, i2c_clock_calibrate);
+    return i2c_clock_tick_hz;
+}
@@ -0,0 +1,32 @@
+#ifndef I2C_CLOCK_HEADER_H
+#define I2C_CLOCK_HEADER_H
+
+/*
+ * Cheap timestamp source for the host I2C instrumentation and trace.
+ *
+ * Reads the CPU cycle counter where one is readable from user space (a clock_gettime
+ * call costs tens of ns on some hosts), the monotonic clock in ns otherwise. Ticks are
+ * only converted to time off the hot path, using i2c_clock_ticks_per_second.
+ */
+
+#include <stdint.h>
+
+uint64_t i2c_clock_now_ns(void);
+
+/* Rate of i2c_clock_ticks, measured once on first call. */
+uint64_t i2c_clock_ticks_per_second(void);
+
+static inline uint64_t i2c_clock_ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return i2c_clock_now_ns();
+#endif
+}
+
+#endif
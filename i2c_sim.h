@@ -0,0 +1,76 @@
+#ifndef I2C_SIM_HEADER_H
+#define I2C_SIM_HEADER_H
+
+/*
+ * Host-only simulation hooks behind the i2c.h API.
+ *
+ * Simulated devices are attached at a bus id and 7-bit address; i2c_bus_read,
+ * i2c_bus_write and i2c_transfer addressed to them are played out byte by byte against
+ * the device model instead of the default stub, an i2c_transfer as one transaction
+ * with a repeated-START per segment and a single STOP. Every transfer advances a
+ * shared virtual clock by its modelled duration on the wire, so device models see time
+ * pass mid-burst exactly as the bus clock dictates. Transfers to addresses with no device attached
+ * keep the default stub behaviour and do not take the simulation lock. Attach and detach
+ * devices while no transfer is running.
+ */
+
+#include "i2c.h"
+
+#include <stdint.h>
+
+#define I2C_SIM_MAX_BUSES    4u
+#define I2C_SIM_MAX_DEVICES  8u
+
+/* Bus clock used until i2c_sim_set_bus_speed is called. */
+#define I2C_SIM_DEFAULT_BUS_HZ 400000u
+
+typedef struct {
+    /* Sub-address phase: the register address byte as sent by the master. */
+    void (*select)(void *device, uint8_t register_address);
+    /* Data phase, one byte at a time. */
+    uint8_t (*read_byte)(void *device);
+    void (*write_byte)(void *device, uint8_t value);
+    /* STOP condition ending the transfer. Optional. */
+    void (*stop)(void *device);
+    /* Virtual clock moved forward to now_ns. Must not issue I2C transfers. */
+    void (*tick)(void *device, uint64_t now_ns);
+} i2c_sim_device_ops_t;
+
+typedef struct {
+    uint32_t transactions;
+    uint32_t bytes;          /* Bytes on the wire, address and sub-address phases included */
+    uint32_t data_bytes;     /* Payload bytes only */
+    uint64_t bus_ns;         /* Modelled time the bus was busy */
+} i2c_sim_bus_stats_t;
+
+status_t i2c_sim_attach(
+    uint8_t bus_id,
+    uint8_t bus_address,
+    const i2c_sim_device_ops_t *ops,
+    void *device);
+
+void i2c_sim_detach_all(void);
+
+void i2c_sim_set_bus_speed(
+    uint8_t bus_id,
+    uint32_t bus_hz);
+
+/* Virtual clock, shared by all buses and devices. */
+uint64_t i2c_sim_now_ns(void);
+
+/* Move the virtual clock forward by delta_ns, ticking every attached device. */
+void i2c_sim_advance(uint64_t delta_ns);
+
+void i2c_sim_get_bus_stats(
+    uint8_t bus_id,
+    i2c_sim_bus_stats_t *stats);
+
+void i2c_sim_reset_bus_stats(void);
+
+/* Modelled wire time of one register-addressed transfer of length data bytes. */
+uint64_t i2c_sim_transfer_ns(
+    uint32_t bus_hz,
+    uint8_t is_read,
+    uint16_t length);
+
+#endif
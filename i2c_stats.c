@@ -0,0 +1,194 @@
+#include "i2c_stats.h"
+
+#ifdef I2C_STATS_ENABLED
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * Counters are _Atomic so the snapshot may read them while owners write, but owners only
+ * ever use relaxed load + store on their own block: no lock prefix on the hot path.
+ */
+typedef struct {
+    atomic_uint_fast64_t reads;
+    atomic_uint_fast64_t writes;
+    atomic_uint_fast64_t bytes;
+    atomic_uint_fast64_t errors;
+} i2c_stats_cell_t;
+
+/* Per-bus totals are not kept here: the snapshot sums them from the register cells. */
+typedef struct {
+    i2c_stats_cell_t reg[I2C_STATS_MAX_BUSES][I2C_STATS_REGISTERS];
+#ifndef I2C_STATS_NO_LATENCY
+    atomic_uint_fast64_t latency[I2C_STATS_MAX_BUSES][I2C_STATS_LATENCY_BUCKETS];
+#endif
+} i2c_stats_block_t;
+
+static i2c_stats_block_t i2c_stats_blocks[I2C_STATS_MAX_THREADS];
+static atomic_uint i2c_stats_blocks_used;
+
+/* Shared by threads beyond I2C_STATS_MAX_THREADS; updated with atomic adds. */
+static i2c_stats_block_t i2c_stats_overflow;
+
+static _Thread_local i2c_stats_block_t *i2c_stats_own;
+static _Thread_local int i2c_stats_shared;
+
+static inline void i2c_stats_bump(atomic_uint_fast64_t *counter, uint64_t delta, int shared)
+{
+    if (shared) {
+        atomic_fetch_add_explicit(counter, delta, memory_order_relaxed);
+    } else {
+        atomic_store_explicit(counter,
+            atomic_load_explicit(counter, memory_order_relaxed) + delta,
+            memory_order_relaxed);
+    }
+}
+
+static i2c_stats_block_t *i2c_stats_block(void)
+{
+    if (i2c_stats_own == NULL) {
+        unsigned int index = atomic_fetch_add(&i2c_stats_blocks_used, 1u);
+
+        if (index < I2C_STATS_MAX_THREADS) {
+            i2c_stats_own = &i2c_stats_blocks[index];
+        } else {
+            i2c_stats_own = &i2c_stats_overflow;
+            i2c_stats_shared = 1;
+        }
+    }
+
+    return i2c_stats_own;
+}
+
+void i2c_stats_record(
+    uint8_t bus_id,
+    uint8_t register_address,
+    uint8_t is_read,
+    uint16_t length,
+    status_t status,
+    uint64_t latency_ticks)
+{
+    i2c_stats_block_t *block = i2c_stats_block();
+    int shared = i2c_stats_shared;
+    i2c_stats_cell_t *cell;
+
+    if (bus_id >= I2C_STATS_MAX_BUSES) {
+        return;
+    }
+
+    cell = &block->reg[bus_id][register_address % I2C_STATS_REGISTERS];
+    i2c_stats_bump(is_read ? &cell->reads : &cell->writes, 1u, shared);
+    i2c_stats_bump(&cell->bytes, length, shared);
+    if (status != STATUS_OK) {
+        i2c_stats_bump(&cell->errors, 1u, shared);
+    }
+
+#ifndef I2C_STATS_NO_LATENCY
+    {
+        /* Raw ticks, log2-bucketed: no conversion to ns on the hot path */
+        uint32_t bucket = (latency_ticks != 0u) ? (63u - (uint32_t)__builtin_clzll(latency_ticks)) : 0u;
+
+        if (bucket >= I2C_STATS_LATENCY_BUCKETS) {
+            bucket = I2C_STATS_LATENCY_BUCKETS - 1u;
+        }
+        i2c_stats_bump(&block->latency[bus_id][bucket], 1u, shared);
+    }
+#else
+    (void)latency_ticks;
+#endif
+}
+
+static void i2c_stats_sum_cell(i2c_stats_counters_t *sum, i2c_stats_cell_t *cell)
+{
+    sum->reads += atomic_load_explicit(&cell->reads, memory_order_relaxed);
+    sum->writes += atomic_load_explicit(&cell->writes, memory_order_relaxed);
+    sum->bytes += atomic_load_explicit(&cell->bytes, memory_order_relaxed);
+    sum->errors += atomic_load_explicit(&cell->errors, memory_order_relaxed);
+}
+
+static void i2c_stats_sum_block(i2c_stats_snapshot_t *snapshot, i2c_stats_block_t *block)
+{
+    for (uint32_t b = 0; b < I2C_STATS_MAX_BUSES; ++b) {
+        for (uint32_t r = 0; r < I2C_STATS_REGISTERS; ++r) {
+            i2c_stats_sum_cell(&snapshot->reg[b][r], &block->reg[b][r]);
+        }
+#ifndef I2C_STATS_NO_LATENCY
+        for (uint32_t h = 0; h < I2C_STATS_LATENCY_BUCKETS; ++h) {
+            snapshot->latency[b][h] += atomic_load_explicit(&block->latency[b][h], memory_order_relaxed);
+        }
+#endif
+    }
+}
+
+void i2c_stats_snapshot(i2c_stats_snapshot_t *snapshot)
+{
+    unsigned int used = atomic_load(&i2c_stats_blocks_used);
+
+    if (used > I2C_STATS_MAX_THREADS) {
+        used = I2C_STATS_MAX_THREADS;
+    }
+
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->ticks_per_second = i2c_clock_ticks_per_second();
+    for (unsigned int i = 0; i < used; ++i) {
+        i2c_stats_sum_block(snapshot, &i2c_stats_blocks[i]);
+    }
+    i2c_stats_sum_block(snapshot, &i2c_stats_overflow);
+
+    for (uint32_t b = 0; b < I2C_STATS_MAX_BUSES; ++b) {
+        for (uint32_t r = 0; r < I2C_STATS_REGISTERS; ++r) {
+            snapshot->bus[b].reads += snapshot->reg[b][r].reads;
+            snapshot->bus[b].writes += snapshot->reg[b][r].writes;
+            snapshot->bus[b].bytes += snapshot->reg[b][r].bytes;
+            snapshot->bus[b].errors += snapshot->reg[b][r].errors;
+        }
+    }
+}
+
+void i2c_stats_dump(
+    const i2c_stats_snapshot_t *snapshot,
+    FILE *stream)
+{
+    for (uint32_t b = 0; b < I2C_STATS_MAX_BUSES; ++b) {
+        const i2c_stats_counters_t *bus = &snapshot->bus[b];
+
+        if ((bus->reads + bus->writes) == 0u) {
+            continue;
+        }
+
+        fprintf(stream, "bus [%u] reads [%llu] writes [%llu] bytes [%llu] errors [%llu]\n",
+                b,
+                (unsigned long long)bus->reads,
+                (unsigned long long)bus->writes,
+                (unsigned long long)bus->bytes,
+                (unsigned long long)bus->errors);
+
+        for (uint32_t r = 0; r < I2C_STATS_REGISTERS; ++r) {
+            const i2c_stats_counters_t *reg = &snapshot->reg[b][r];
+
+            if ((reg->reads + reg->writes) != 0u) {
+                fprintf(stream, "\tregister [0x%02x] reads [%llu] writes [%llu] bytes [%llu] errors [%llu]\n",
+                        r,
+                        (unsigned long long)reg->reads,
+                        (unsigned long long)reg->writes,
+                        (unsigned long long)reg->bytes,
+                        (unsigned long long)reg->errors);
+            }
+        }
+
+        for (uint32_t h = 0; h < I2C_STATS_LATENCY_BUCKETS; ++h) {
+            if (snapshot->latency[b][h] != 0u) {
+                double ns_per_tick = 1e9 / (double)snapshot->ticks_per_second;
+
+                fprintf(stream, "\tlatency [%.0f..%.0f) ns [%llu]\n",
+                        (double)(1ull << h) * ns_per_tick,
+                        (double)(1ull << (h + 1u)) * ns_per_tick,
+                        (unsigned long long)snapshot->latency[b][h]);
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef I2C_STATS_HEADER_H
+#define I2C_STATS_HEADER_H
+
+/*
+ * Compiled-in I2C instrumentation behind i2c_bus_read/i2c_bus_write.
+ *
+ * Build with -DI2C_STATS_ENABLED to keep, per bus and per register, transaction counts,
+ * bytes and errors, plus per-bus log2-bucketed latency histograms. Each thread updates
+ * its own counter block with plain single-writer stores (no locks, no atomic
+ * read-modify-write); only the register counters are kept, and i2c_stats_snapshot sums
+ * the blocks and the per-bus totals on demand. Add -DI2C_STATS_NO_LATENCY to drop the
+ * histograms and with them the end-of-transaction clock read, the dearer half of the
+ * hot path where the tick source is slow. Without I2C_STATS_ENABLED the hooks expand to
+ * nothing and none of this is compiled in. bench/i2c_stats_bench checks the cost per
+ * transaction against its budget.
+ */
+
+#include "i2c.h"
+#include "i2c_clock.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define I2C_STATS_MAX_BUSES      4u
+#define I2C_STATS_REGISTERS      0x80u   /* Sub-address with the auto-increment bit stripped */
+#define I2C_STATS_LATENCY_BUCKETS 40u    /* Bucket n counts latencies in [2^n, 2^(n+1)) ticks */
+#define I2C_STATS_MAX_THREADS    16u     /* Further threads share one atomically updated block */
+
+typedef struct {
+    uint64_t reads;
+    uint64_t writes;
+    uint64_t bytes;
+    uint64_t errors;
+} i2c_stats_counters_t;
+
+typedef struct {
+    i2c_stats_counters_t bus[I2C_STATS_MAX_BUSES];
+    i2c_stats_counters_t reg[I2C_STATS_MAX_BUSES][I2C_STATS_REGISTERS];
+    uint64_t latency[I2C_STATS_MAX_BUSES][I2C_STATS_LATENCY_BUCKETS];
+    uint64_t ticks_per_second;   /* Rate of the latency tick source, see i2c_clock.h */
+} i2c_stats_snapshot_t;
+
+#ifdef I2C_STATS_ENABLED
+
+void i2c_stats_record(
+    uint8_t bus_id,
+    uint8_t register_address,
+    uint8_t is_read,
+    uint16_t length,
+    status_t status,
+    uint64_t latency_ticks);
+
+/* Sum of all thread blocks. Concurrent updates may or may not be included. */
+void i2c_stats_snapshot(i2c_stats_snapshot_t *snapshot);
+
+/* Human-readable dump of the non-zero entries of a snapshot, latencies in ns. */
+void i2c_stats_dump(
+    const i2c_stats_snapshot_t *snapshot,
+    FILE *stream);
+
+/* start is the i2c_clock_ticks() value taken when the transaction began. */
+#ifndef I2C_STATS_NO_LATENCY
+#define I2C_STATS_RECORD(bus_id, register_address, is_read, length, status, start) \
+    i2c_stats_record((bus_id), (register_address), (is_read), (length), (status),    \
+                     i2c_clock_ticks() - (start))
+#else
+#define I2C_STATS_RECORD(bus_id, register_address, is_read, length, status, start) \
+    ((void)(start), i2c_stats_record((bus_id), (register_address), (is_read), (length), (status), 0u))
+#endif
+
+#else
+
+#define I2C_STATS_RECORD(bus_id, register_address, is_read, length, status, start) ((void)(start))
+
+#endif
+
+#endif
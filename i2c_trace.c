@@ -0,0 +1,219 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "i2c_trace.h"
+#include "i2c_clock.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Header and rings are kept contiguous so a core dump holds them as a single region. */
+static struct {
+    i2c_trace_file_header_t header;
+    i2c_trace_ring_t rings[I2C_TRACE_MAX_THREADS];
+} i2c_trace_region = {
+    .header = {
+        .magic = I2C_TRACE_MAGIC,
+        .version = I2C_TRACE_VERSION,
+        .ring_count = I2C_TRACE_MAX_THREADS,
+        .ring_length = I2C_TRACE_RING_LEN,
+    },
+};
+
+static uint32_t i2c_trace_rings_used;
+static _Thread_local i2c_trace_ring_t *i2c_trace_own;
+static _Thread_local int i2c_trace_shared;
+static int i2c_trace_crash_fd = -1;
+
+static i2c_trace_ring_t *i2c_trace_ring(void)
+{
+    if (i2c_trace_own == NULL) {
+        uint32_t slot = __atomic_fetch_add(&i2c_trace_rings_used, 1u, __ATOMIC_RELAXED);
+
+        if (slot >= (I2C_TRACE_MAX_THREADS - 1u)) {
+            slot = I2C_TRACE_MAX_THREADS - 1u;
+            i2c_trace_shared = 1;
+        }
+        i2c_trace_own = &i2c_trace_region.rings[slot];
+        i2c_trace_own->thread_slot = slot;
+        __atomic_store_n(&i2c_trace_own->in_use, 1u, __ATOMIC_RELEASE);
+    }
+
+    return i2c_trace_own;
+}
+
+void i2c_trace_record(
+    uint64_t timestamp,
+    uint8_t flags,
+    uint8_t bus_id,
+    uint8_t bus_address,
+    uint8_t register_address,
+    uint16_t length,
+    status_t status)
+{
+    i2c_trace_ring_t *ring = i2c_trace_ring();
+    i2c_trace_record_t *record;
+    uint64_t head;
+
+    if (i2c_trace_shared) {
+        head = __atomic_fetch_add(&ring->head, 1u, __ATOMIC_ACQ_REL);
+    } else {
+        head = ring->head;
+    }
+
+    record = &ring->records[head & (I2C_TRACE_RING_LEN - 1u)];
+    __atomic_store_n(&record->sequence, 0u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    record->timestamp = timestamp;
+    record->flags = flags;
+    record->bus_id = bus_id;
+    record->bus_address = bus_address;
+    record->register_address = register_address;
+    record->length = length;
+    record->status = (uint8_t)status;
+    record->reserved = 0u;
+    __atomic_store_n(&record->sequence, head + 1u, __ATOMIC_RELEASE);
+
+    if (!i2c_trace_shared) {
+        __atomic_store_n(&ring->head, head + 1u, __ATOMIC_RELEASE);
+    }
+}
+
+/* Records copied per write() while dumping; the batch lives on the (signal) stack. */
+#define I2C_TRACE_DUMP_BATCH 64u
+
+/* Fields of i2c_trace_ring_t ahead of its records, as written by a dump. */
+typedef struct {
+    uint64_t head;
+    uint32_t thread_slot;
+    uint32_t in_use;
+} i2c_trace_ring_header_t;
+
+_Static_assert(sizeof(i2c_trace_ring_header_t) == offsetof(i2c_trace_ring_t, records),
+               "i2c_trace_ring_header_t must match the start of i2c_trace_ring_t");
+
+static status_t i2c_trace_write_all(int fd, const void *buffer, size_t size)
+{
+    const uint8_t *bytes = buffer;
+
+    while (size > 0u) {
+        ssize_t written = write(fd, bytes, size);
+
+        if (written <= 0) {
+            return STATUS_ERROR;
+        }
+        bytes += written;
+        size -= (size_t)written;
+    }
+
+    return STATUS_OK;
+}
+
+/* Copy a slot if it holds a complete record; a slot being rewritten is dumped as zeros. */
+static void i2c_trace_snapshot(const i2c_trace_record_t *slot, i2c_trace_record_t *copy)
+{
+    static const i2c_trace_record_t empty;
+    uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+
+    *copy = *slot;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    if ((sequence == 0u) || (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) != sequence)) {
+        *copy = empty;
+    } else {
+        copy->sequence = sequence;
+    }
+}
+
+status_t i2c_trace_dump_fd(int fd)
+{
+    i2c_trace_record_t batch[I2C_TRACE_DUMP_BATCH];
+
+    if (i2c_trace_write_all(fd, &i2c_trace_region.header, sizeof(i2c_trace_region.header)) != STATUS_OK) {
+        return STATUS_ERROR;
+    }
+
+    for (uint32_t r = 0; r < I2C_TRACE_MAX_THREADS; ++r) {
+        const i2c_trace_ring_t *ring = &i2c_trace_region.rings[r];
+        i2c_trace_ring_header_t ring_header;
+
+        ring_header.in_use = __atomic_load_n(&ring->in_use, __ATOMIC_ACQUIRE);
+        ring_header.thread_slot = ring->thread_slot;
+        ring_header.head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        if (i2c_trace_write_all(fd, &ring_header, sizeof(ring_header)) != STATUS_OK) {
+            return STATUS_ERROR;
+        }
+
+        for (uint32_t i = 0; i < I2C_TRACE_RING_LEN; i += I2C_TRACE_DUMP_BATCH) {
+            for (uint32_t j = 0; j < I2C_TRACE_DUMP_BATCH; ++j) {
+                i2c_trace_snapshot(&ring->records[i + j], &batch[j]);
+            }
+            if (i2c_trace_write_all(fd, batch, sizeof(batch)) != STATUS_OK) {
+                return STATUS_ERROR;
+            }
+        }
+    }
+
+    return STATUS_OK;
+}
+
+status_t i2c_trace_dump_file(const char *path)
+{
+    status_t status;
+    int fd;
+
+    i2c_trace_region.header.ticks_per_second = i2c_clock_ticks_per_second();
+
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return STATUS_ERROR;
+    }
+
+    status = i2c_trace_dump_fd(fd);
+    if (close(fd) != 0) {
+        status = STATUS_ERROR;
+    }
+
+    return status;
+}
+
+static void i2c_trace_crash(int signal_number)
+{
+    if (i2c_trace_crash_fd >= 0) {
+        (void)i2c_trace_dump_fd(i2c_trace_crash_fd);
+        (void)fsync(i2c_trace_crash_fd);
+    }
+
+    /* SA_RESETHAND restored the default action */
+    raise(signal_number);
+}
+
+status_t i2c_trace_install_crash_handler(const char *path)
+{
+    static const int signals[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+    struct sigaction action;
+
+    /* The rate cannot be measured from a signal handler: fix it up front */
+    i2c_trace_region.header.ticks_per_second = i2c_clock_ticks_per_second();
+
+    i2c_trace_crash_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (i2c_trace_crash_fd < 0) {
+        return STATUS_ERROR;
+    }
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = i2c_trace_crash;
+    action.sa_flags = SA_RESETHAND;
+    sigemptyset(&action.sa_mask);
+
+    for (size_t i = 0; i < sizeof(signals) / sizeof(signals[0]); ++i) {
+        if (sigaction(signals[i], &action, NULL) != 0) {
+            return STATUS_ERROR;
+        }
+    }
+
+    return STATUS_OK;
+}
@@ -0,0 +1,80 @@
+#ifndef I2C_TRACE_HEADER_H
+#define I2C_TRACE_HEADER_H
+
+/*
+ * Binary I2C trace behind i2c_bus_read/i2c_bus_write.
+ *
+ * Every transaction appends one fixed-size record (timestamp, direction, device,
+ * register, length, status) to a per-thread ring. The hot path does no formatting and
+ * takes no locks: the writer clears the slot's sequence word, fills the slot and then
+ * publishes it by storing the sequence with release. Threads past the first
+ * I2C_TRACE_MAX_THREADS - 1 share the last ring and claim slots with an atomic add.
+ * A dump copies a slot only if its sequence, loaded with acquire, is set and unchanged
+ * after the copy, so a record caught mid-write is dropped instead of torn. All rings
+ * live in one static region, so they can be written out from a fatal signal handler
+ * (i2c_trace_install_crash_handler) or found in a core dump by their magic, and
+ * rendered offline with tools/i2c_trace_decode.
+ */
+
+#include "i2c.h"
+
+#include <stdint.h>
+
+#define I2C_TRACE_MAGIC        "I2CTRACE"
+#define I2C_TRACE_VERSION      2u
+#define I2C_TRACE_RING_LEN     1024u   /* Records kept per thread, power of two */
+#define I2C_TRACE_MAX_THREADS  16u     /* The last ring is shared by any further threads */
+
+/* i2c_trace_record_t.flags */
+#define I2C_TRACE_WRITE        0x01u
+
+typedef struct {
+    uint64_t timestamp;        /* i2c_clock_ticks() at the start of the transaction */
+    uint64_t sequence;         /* Position in the ring's history + 1; 0 while unwritten or being written */
+    uint8_t flags;
+    uint8_t bus_id;
+    uint8_t bus_address;
+    uint8_t register_address;
+    uint16_t length;
+    uint8_t status;
+    uint8_t reserved;
+} i2c_trace_record_t;
+
+typedef struct {
+    uint64_t head;             /* Records ever written; the ring holds the last I2C_TRACE_RING_LEN */
+    uint32_t thread_slot;
+    uint32_t in_use;
+    i2c_trace_record_t records[I2C_TRACE_RING_LEN];
+} i2c_trace_ring_t;
+
+/* Layout of a dump file: this header followed by ring_count rings. */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t ring_count;
+    uint32_t ring_length;
+    uint32_t reserved;
+    uint64_t ticks_per_second;
+} i2c_trace_file_header_t;
+
+void i2c_trace_record(
+    uint64_t timestamp,
+    uint8_t flags,
+    uint8_t bus_id,
+    uint8_t bus_address,
+    uint8_t register_address,
+    uint16_t length,
+    status_t status);
+
+/* Write the trace region to fd. Async-signal-safe. */
+status_t i2c_trace_dump_fd(int fd);
+
+status_t i2c_trace_dump_file(const char *path);
+
+/*
+ * Open path now and dump the trace into it on SIGSEGV, SIGBUS, SIGILL, SIGFPE or
+ * SIGABRT, then re-raise the signal with the default action.
+ */
+status_t i2c_trace_install_crash_handler(const char *path);
+
+#endif
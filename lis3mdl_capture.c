@@ -0,0 +1,147 @@
+#include "lis3mdl_capture.h"
+#include "lis3mdl_register.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int lis3mdl_capture_from(const i2c_capture_record_t *record, uint8_t address)
+{
+    return (record->status == STATUS_OK) &&
+           ((address == LIS3MDL_CAPTURE_ADDRESS_ANY) || (record->bus_address == address));
+}
+
+int lis3mdl_capture_check(const uint8_t *base, size_t size)
+{
+    i2c_capture_file_header_t header;
+
+    if (size < sizeof(header)) {
+        return 0;
+    }
+    memcpy(&header, base, sizeof(header));
+    return (memcmp(header.magic, I2C_CAPTURE_MAGIC, sizeof(header.magic)) == 0) &&
+           (header.version == I2C_CAPTURE_VERSION);
+}
+
+void lis3mdl_capture_cursor_init(
+    lis3mdl_capture_cursor_t *cursor,
+    const uint8_t *base,
+    size_t begin,
+    size_t end)
+{
+    cursor->base = base;
+    cursor->end = end;
+    cursor->offset = begin;
+}
+
+int lis3mdl_capture_next(
+    lis3mdl_capture_cursor_t *cursor,
+    i2c_capture_record_t *record,
+    const uint8_t **payload)
+{
+    size_t left = (cursor->offset < cursor->end) ? (cursor->end - cursor->offset) : 0u;
+
+    if (left < sizeof(*record)) {
+        return 0;
+    }
+    memcpy(record, &cursor->base[cursor->offset], sizeof(*record));
+    if ((left - sizeof(*record)) < record->length) {
+        return 0;
+    }
+
+    *payload = &cursor->base[cursor->offset + sizeof(*record)];
+    cursor->offset += sizeof(*record) + record->length;
+    return 1;
+}
+
+Lis3mdlScale_t lis3mdl_capture_scale(
+    const i2c_capture_record_t *record,
+    const uint8_t *payload,
+    uint8_t address)
+{
+    uint8_t reg = record->register_address & (uint8_t)~LIS3MDL_AUTO_INCREMENT;
+    uint8_t value;
+
+    if (!(record->flags & I2C_CAPTURE_WRITE) || !lis3mdl_capture_from(record, address) ||
+        (record->length == 0u)) {
+        return LIS3MDL_SCALE_UNKNOWN;
+    }
+
+    if (reg == LIS3MDL_CTRL_REG2) {
+        /* Without auto-increment every byte lands in CTRL_REG2; the last one stays */
+        value = (record->register_address & LIS3MDL_AUTO_INCREMENT) ? payload[0] : payload[record->length - 1u];
+    } else if ((record->register_address & LIS3MDL_AUTO_INCREMENT) && (reg < LIS3MDL_CTRL_REG2) &&
+               ((reg + record->length) > LIS3MDL_CTRL_REG2)) {
+        value = payload[LIS3MDL_CTRL_REG2 - reg];
+    } else {
+        return LIS3MDL_SCALE_UNKNOWN;
+    }
+
+    return (Lis3mdlScale_t)((value & LIS3MDL_CTRL2_FS_MASK) >> LIS3MDL_CTRL2_FS_SHIFT);
+}
+
+int lis3mdl_capture_sample(
+    const i2c_capture_record_t *record,
+    const uint8_t *payload,
+    uint8_t address,
+    Lis3mdlSampleXYZ_st *sample,
+    int16_t *temperature)
+{
+    const uint8_t *xyz = NULL;
+
+    if ((record->flags & I2C_CAPTURE_WRITE) || !lis3mdl_capture_from(record, address)) {
+        return 0;
+    }
+
+    if ((record->register_address == (LIS3MDL_OUT_X_L | LIS3MDL_AUTO_INCREMENT)) && (record->length == 6u)) {
+        xyz = payload;
+    } else if ((record->register_address == (LIS3MDL_STATUS_REG | LIS3MDL_AUTO_INCREMENT)) &&
+               ((record->length == LIS3MDL_STATUS_BURST_LEN) || (record->length == LIS3MDL_TEMP_BURST_LEN))) {
+        if ((record->length == LIS3MDL_TEMP_BURST_LEN) && (temperature != NULL)) {
+            *temperature = (int16_t)((payload[8] << 8) | payload[7]);
+        }
+        xyz = (payload[0] & LIS3MDL_STATUS_ZYXDA) ? &payload[1] : NULL;
+    } else if ((record->register_address == (LIS3MDL_TEMP_OUT_L | LIS3MDL_AUTO_INCREMENT)) &&
+               (record->length == 2u) && (temperature != NULL)) {
+        *temperature = (int16_t)((payload[1] << 8) | payload[0]);
+    }
+
+    if (xyz == NULL) {
+        return 0;
+    }
+    sample->x_s16 = (int16_t)((xyz[1] << 8) | xyz[0]);
+    sample->y_s16 = (int16_t)((xyz[3] << 8) | xyz[2]);
+    sample->z_s16 = (int16_t)((xyz[5] << 8) | xyz[4]);
+    return 1;
+}
+
+uint8_t lis3mdl_capture_find_address(
+    const uint8_t *base,
+    size_t size)
+{
+    lis3mdl_capture_cursor_t cursor;
+    i2c_capture_record_t record;
+    const uint8_t *payload;
+    Lis3mdlSampleXYZ_st sample;
+
+    lis3mdl_capture_cursor_init(&cursor, base, sizeof(i2c_capture_file_header_t), size);
+    while (lis3mdl_capture_next(&cursor, &record, &payload)) {
+        if (lis3mdl_capture_sample(&record, payload, LIS3MDL_CAPTURE_ADDRESS_ANY, &sample, NULL)) {
+            return record.bus_address;
+        }
+    }
+    return LIS3MDL_CAPTURE_ADDRESS_ANY;
+}
+
+int lis3mdl_capture_parse_scale(
+    const char *text,
+    Lis3mdlScale_t *scale)
+{
+    switch (strtoul(text, NULL, 0)) {
+    case 4: *scale = LIS3MDL_SCALE_4G; return 1;
+    case 8: *scale = LIS3MDL_SCALE_8G; return 1;
+    case 12: *scale = LIS3MDL_SCALE_12G; return 1;
+    case 16: *scale = LIS3MDL_SCALE_16G; return 1;
+    default: return 0;
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef LIS3MDL_CAPTURE_HEADER_H
+#define LIS3MDL_CAPTURE_HEADER_H
+
+/*
+ * LIS3MDL view of an I2C capture (i2c_capture.h), shared by the offline tools.
+ *
+ * A cursor walks the records of a mapped capture in order. Each record is then decoded
+ * against one sensor: successful XYZ bursts (OUT_X_L, 6 bytes) and status bursts with
+ * ZYXDA set (STATUS_REG, 7 or 9 bytes) carry a sample, 9-byte status bursts and 2-byte
+ * TEMP_OUT reads carry a temperature, and successful writes covering CTRL_REG2 change
+ * the full scale. Records addressed to other devices carry nothing.
+ */
+
+#include "i2c.h"
+#include "i2c_capture.h"
+#include "lis3mdl.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Sensor address matching any device. */
+#define LIS3MDL_CAPTURE_ADDRESS_ANY 0xffu
+
+typedef struct {
+    const uint8_t *base;       /* Start of the capture, file header included */
+    size_t end;                /* Records must end at or before this offset */
+    size_t offset;             /* Offset of the next record */
+} lis3mdl_capture_cursor_t;
+
+/* 1 when the size bytes at base start with a capture header of the supported version. */
+int lis3mdl_capture_check(const uint8_t *base, size_t size);
+
+/* Walk the records in [begin, end); begin must be a record boundary. */
+void lis3mdl_capture_cursor_init(
+    lis3mdl_capture_cursor_t *cursor,
+    const uint8_t *base,
+    size_t begin,
+    size_t end);
+
+/*
+ * Returns 1 with the next record and its payload, 0 at the end of the range or at a
+ * truncated record (the cursor then stays on it).
+ */
+int lis3mdl_capture_next(
+    lis3mdl_capture_cursor_t *cursor,
+    i2c_capture_record_t *record,
+    const uint8_t **payload);
+
+/* Full scale written to the sensor at address, or LIS3MDL_SCALE_UNKNOWN when the record does not write CTRL_REG2. */
+Lis3mdlScale_t lis3mdl_capture_scale(
+    const i2c_capture_record_t *record,
+    const uint8_t *payload,
+    uint8_t address);
+
+/*
+ * Decode a successful read from the sensor at address: updates *temperature (when not
+ * NULL) if TEMP_OUT was read, and returns 1 with *sample if the record carries one.
+ */
+int lis3mdl_capture_sample(
+    const i2c_capture_record_t *record,
+    const uint8_t *payload,
+    uint8_t address,
+    Lis3mdlSampleXYZ_st *sample,
+    int16_t *temperature);
+
+/* Address of the first sample in the capture, or LIS3MDL_CAPTURE_ADDRESS_ANY when there is none. */
+uint8_t lis3mdl_capture_find_address(
+    const uint8_t *base,
+    size_t size);
+
+/* Parse a full scale given in gauss (4, 8, 12 or 16); returns 0 for anything else. */
+int lis3mdl_capture_parse_scale(
+    const char *text,
+    Lis3mdlScale_t *scale);
+
+#endif
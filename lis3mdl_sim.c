@@ -0,0 +1,395 @@
+#include "lis3mdl_sim.h"
+#include "i2c_sim.h"
+#include "lis3mdl_register.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* Conversion period per CTRL_REG1 DO[2:0]: 0.625 Hz .. 80 Hz */
+static const uint64_t lis3mdl_sim_do_period_ns[8] = {
+    1600000000ull, 800000000ull, 400000000ull, 200000000ull,
+    100000000ull, 50000000ull, 25000000ull, 12500000ull,
+};
+
+/* Conversion period with FAST_ODR, per CTRL_REG1 OM[1:0]: 1000/560/300/155 Hz */
+static const uint64_t lis3mdl_sim_fast_period_ns[4] = {
+    1000000ull, 1785714ull, 3333333ull, 6451613ull,
+};
+
+/* CTRL_REG1 bits that set the conversion period: writes changing none of them keep the schedule */
+#define LIS3MDL_SIM_CTRL1_TIMING (LIS3MDL_CTRL1_OM_MASK | LIS3MDL_CTRL1_DO_MASK | LIS3MDL_CTRL1_FAST_ODR)
+
+/* LSB/gauss per CTRL_REG2 FS[1:0]: +-4/8/12/16 gauss */
+static const double lis3mdl_sim_sensitivity[4] = {
+    6842.0, 3421.0, 2281.0, 1711.0,
+};
+
+static void lis3mdl_sim_reset(lis3mdl_sim_t *sim)
+{
+    memset(sim->regs, 0, sizeof(sim->regs));
+    sim->regs[LIS3MDL_WHO_AM_I] = LIS3MDL_WHO_AM_I_VALUE;
+    sim->regs[LIS3MDL_CTRL_REG1] = 0x10;
+    sim->regs[LIS3MDL_CTRL_REG3] = LIS3MDL_CTRL3_MD_POWER_DOWN;
+    sim->regs[LIS3MDL_INT_CFG] = 0xE8;
+    sim->bdu_latch = 0u;
+    sim->pending_valid = 0u;
+    sim->period_ns = 0u;
+}
+
+static uint64_t lis3mdl_sim_period(const lis3mdl_sim_t *sim)
+{
+    uint8_t ctrl1 = sim->regs[LIS3MDL_CTRL_REG1];
+
+    if (ctrl1 & LIS3MDL_CTRL1_FAST_ODR) {
+        return lis3mdl_sim_fast_period_ns[(ctrl1 & LIS3MDL_CTRL1_OM_MASK) >> LIS3MDL_CTRL1_OM_SHIFT];
+    }
+
+    return lis3mdl_sim_do_period_ns[(ctrl1 & LIS3MDL_CTRL1_DO_MASK) >> LIS3MDL_CTRL1_DO_SHIFT];
+}
+
+/* Re-evaluate the conversion schedule after CTRL_REG1 or CTRL_REG3 changed. */
+static void lis3mdl_sim_schedule(lis3mdl_sim_t *sim)
+{
+    uint8_t md = sim->regs[LIS3MDL_CTRL_REG3] & LIS3MDL_CTRL3_MD_MASK;
+
+    /* Single-conversion mode is only specified at the DO rates: refused under FAST_ODR */
+    if ((md == LIS3MDL_CTRL3_MD_SINGLE) && (sim->regs[LIS3MDL_CTRL_REG1] & LIS3MDL_CTRL1_FAST_ODR)) {
+        sim->regs[LIS3MDL_CTRL_REG3] |= LIS3MDL_CTRL3_MD_POWER_DOWN;
+        sim->period_ns = 0u;
+        return;
+    }
+
+    if ((md == LIS3MDL_CTRL3_MD_CONTINUOUS) || (md == LIS3MDL_CTRL3_MD_SINGLE)) {
+        sim->period_ns = lis3mdl_sim_period(sim);
+        sim->next_conversion_ns = sim->now_ns + sim->period_ns;
+    } else {
+        sim->period_ns = 0u;
+    }
+}
+
+static int16_t lis3mdl_sim_counts(const lis3mdl_sim_t *sim, uint32_t axis)
+{
+    uint8_t fs = (sim->regs[LIS3MDL_CTRL_REG2] & LIS3MDL_CTRL2_FS_MASK) >> LIS3MDL_CTRL2_FS_SHIFT;
+    double lsb = sim->field_gauss[axis] * lis3mdl_sim_sensitivity[fs];
+    int64_t counts = (int64_t)(lsb + ((lsb >= 0.0) ? 0.5 : -0.5))
+        + ((int64_t)sim->ramp_lsb * sim->conversions);
+
+    if (counts > INT16_MAX) {
+        counts = INT16_MAX;
+    } else if (counts < INT16_MIN) {
+        counts = INT16_MIN;
+    }
+
+    return (int16_t)counts;
+}
+
+static void lis3mdl_sim_evaluate_int(lis3mdl_sim_t *sim, uint64_t now_ns)
+{
+    static const uint8_t axis_enable[3] = {
+        LIS3MDL_INT_CFG_XIEN, LIS3MDL_INT_CFG_YIEN, LIS3MDL_INT_CFG_ZIEN,
+    };
+    static const uint8_t axis_pth[3] = {
+        LIS3MDL_INT_SRC_PTH_X, LIS3MDL_INT_SRC_PTH_Y, LIS3MDL_INT_SRC_PTH_Z,
+    };
+    static const uint8_t axis_nth[3] = {
+        LIS3MDL_INT_SRC_NTH_X, LIS3MDL_INT_SRC_NTH_Y, LIS3MDL_INT_SRC_NTH_Z,
+    };
+    uint8_t cfg = sim->regs[LIS3MDL_INT_CFG];
+    uint8_t old_src = sim->regs[LIS3MDL_INT_SRC];
+    int32_t ths = (int32_t)(((sim->regs[LIS3MDL_INT_THS_H] & 0x7F) << 8) | sim->regs[LIS3MDL_INT_THS_L]);
+    uint8_t src = 0u;
+
+    if (!(cfg & LIS3MDL_INT_CFG_IEN)) {
+        return;
+    }
+
+    for (uint32_t axis = 0; axis < 3u; ++axis) {
+        uint8_t lo = sim->regs[LIS3MDL_OUT_X_L + (2u * axis)];
+        uint8_t hi = sim->regs[LIS3MDL_OUT_X_H + (2u * axis)];
+        int32_t value = (int16_t)((hi << 8) | lo);
+
+        if (!(cfg & axis_enable[axis])) {
+            continue;
+        }
+        if (value > ths) {
+            src |= axis_pth[axis];
+        } else if (value < -ths) {
+            src |= axis_nth[axis];
+        }
+    }
+
+    if (src != 0u) {
+        src |= LIS3MDL_INT_SRC_INT;
+    }
+    if (cfg & LIS3MDL_INT_CFG_LIR) {
+        src |= old_src;
+    }
+
+    sim->regs[LIS3MDL_INT_SRC] = src;
+
+    if ((src & LIS3MDL_INT_SRC_INT) && !(old_src & LIS3MDL_INT_SRC_INT) && (sim->int_fn != NULL)) {
+        sim->int_fn(sim->int_context, now_ns);
+    }
+}
+
+/* Make a converted sample visible in the output registers. */
+static void lis3mdl_sim_publish(lis3mdl_sim_t *sim, const uint8_t *out, uint64_t now_ns)
+{
+    uint8_t *status = &sim->regs[LIS3MDL_STATUS_REG];
+
+    memcpy(&sim->regs[LIS3MDL_OUT_X_L], out, 6u);
+
+    if (*status & LIS3MDL_STATUS_ZYXDA) {
+        *status |= LIS3MDL_STATUS_ZYXOR | LIS3MDL_STATUS_ZOR | LIS3MDL_STATUS_YOR | LIS3MDL_STATUS_XOR;
+    }
+    *status |= LIS3MDL_STATUS_ZYXDA | LIS3MDL_STATUS_ZDA | LIS3MDL_STATUS_YDA | LIS3MDL_STATUS_XDA;
+
+    lis3mdl_sim_evaluate_int(sim, now_ns);
+
+    if (sim->drdy_fn != NULL) {
+        sim->drdy_fn(sim->drdy_context, now_ns);
+    }
+}
+
+/* Publish a conversion held back by BDU once no axis has a pending MSB read. */
+static void lis3mdl_sim_release(lis3mdl_sim_t *sim)
+{
+    if ((sim->bdu_latch == 0u) && sim->pending_valid) {
+        sim->pending_valid = 0u;
+        lis3mdl_sim_publish(sim, sim->pending_out, sim->now_ns);
+    }
+}
+
+static void lis3mdl_sim_convert(lis3mdl_sim_t *sim, uint64_t now_ns)
+{
+    uint8_t out[6];
+
+    for (uint32_t axis = 0; axis < 3u; ++axis) {
+        uint16_t counts = (uint16_t)lis3mdl_sim_counts(sim, axis);
+
+        out[2u * axis] = (uint8_t)(counts & 0xFF);
+        out[(2u * axis) + 1u] = (uint8_t)(counts >> 8);
+    }
+    sim->conversions++;
+
+    if (sim->regs[LIS3MDL_CTRL_REG1] & LIS3MDL_CTRL1_TEMP_EN) {
+        /* 8 LSB/degC, 0 at 25 degC */
+        int16_t temp = (int16_t)((sim->temperature_c - 25.0) * 8.0);
+
+        sim->regs[LIS3MDL_TEMP_OUT_L] = (uint8_t)((uint16_t)temp & 0xFF);
+        sim->regs[LIS3MDL_TEMP_OUT_H] = (uint8_t)((uint16_t)temp >> 8);
+    }
+
+    if ((sim->regs[LIS3MDL_CTRL_REG5] & LIS3MDL_CTRL5_BDU) && (sim->bdu_latch != 0u)) {
+        /* Output registers are frozen until the pending MSB reads complete */
+        if (sim->pending_valid) {
+            sim->regs[LIS3MDL_STATUS_REG] |= LIS3MDL_STATUS_ZYXOR;
+        }
+        memcpy(sim->pending_out, out, sizeof(out));
+        sim->pending_valid = 1u;
+        return;
+    }
+
+    lis3mdl_sim_publish(sim, out, now_ns);
+}
+
+static void lis3mdl_sim_tick(void *device, uint64_t now_ns)
+{
+    lis3mdl_sim_t *sim = device;
+
+    sim->now_ns = now_ns;
+
+    while ((sim->period_ns != 0u) && (now_ns >= sim->next_conversion_ns)) {
+        uint64_t behind = now_ns - sim->next_conversion_ns;
+        int single = (sim->regs[LIS3MDL_CTRL_REG3] & LIS3MDL_CTRL3_MD_MASK) == LIS3MDL_CTRL3_MD_SINGLE;
+
+        /*
+         * Skip straight to the latest conversion after a long jump of the clock. Only in
+         * continuous mode: a single conversion happens once, however late the tick.
+         */
+        if (!single && (behind >= (2u * sim->period_ns))) {
+            uint64_t missed = (behind / sim->period_ns) - 1u;
+
+            sim->conversions += (uint32_t)missed;
+            sim->next_conversion_ns += missed * sim->period_ns;
+            sim->regs[LIS3MDL_STATUS_REG] |= LIS3MDL_STATUS_ZYXDA;
+        }
+
+        lis3mdl_sim_convert(sim, sim->next_conversion_ns);
+
+        if (single) {
+            sim->regs[LIS3MDL_CTRL_REG3] |= LIS3MDL_CTRL3_MD_POWER_DOWN;
+            sim->period_ns = 0u;
+        } else {
+            sim->next_conversion_ns += sim->period_ns;
+        }
+    }
+}
+
+static void lis3mdl_sim_select(void *device, uint8_t register_address)
+{
+    lis3mdl_sim_t *sim = device;
+
+    sim->pointer = register_address & (uint8_t)~LIS3MDL_AUTO_INCREMENT;
+    sim->auto_increment = (register_address & LIS3MDL_AUTO_INCREMENT) != 0u;
+}
+
+/* Auto-increment wraps at the end of the register map; an unmapped pointer stays put. */
+static void lis3mdl_sim_advance_pointer(lis3mdl_sim_t *sim)
+{
+    if (!sim->auto_increment || (sim->pointer >= LIS3MDL_SIM_REG_COUNT)) {
+        return;
+    }
+
+    if ((sim->regs[LIS3MDL_CTRL_REG5] & LIS3MDL_CTRL5_FAST_READ) &&
+        ((sim->pointer == LIS3MDL_OUT_X_H) || (sim->pointer == LIS3MDL_OUT_Y_H))) {
+        sim->pointer += 2u;
+    } else {
+        sim->pointer = (uint8_t)((sim->pointer + 1u) % LIS3MDL_SIM_REG_COUNT);
+    }
+}
+
+static uint8_t lis3mdl_sim_read_byte(void *device)
+{
+    lis3mdl_sim_t *sim = device;
+    uint8_t reg = sim->pointer;
+    uint8_t value;
+
+    /* Sub-addresses past the register map read as 0 */
+    if (reg >= LIS3MDL_SIM_REG_COUNT) {
+        return 0u;
+    }
+    value = sim->regs[reg];
+
+    if ((reg >= LIS3MDL_OUT_X_L) && (reg <= LIS3MDL_OUT_Z_H)) {
+        uint8_t axis = (uint8_t)((reg - LIS3MDL_OUT_X_L) / 2u);
+
+        if (((reg - LIS3MDL_OUT_X_L) & 1u) == 0u) {
+            if (sim->regs[LIS3MDL_CTRL_REG5] & LIS3MDL_CTRL5_BDU) {
+                sim->bdu_latch |= (uint8_t)(1u << axis);
+            }
+        } else {
+            /* Reading the MSB consumes the axis data */
+            sim->bdu_latch &= (uint8_t)~(1u << axis);
+            sim->regs[LIS3MDL_STATUS_REG] &= (uint8_t)~((LIS3MDL_STATUS_XDA << axis) |
+                                                        (LIS3MDL_STATUS_XOR << axis));
+            if (!(sim->regs[LIS3MDL_STATUS_REG] & (LIS3MDL_STATUS_XDA | LIS3MDL_STATUS_YDA | LIS3MDL_STATUS_ZDA))) {
+                sim->regs[LIS3MDL_STATUS_REG] &= (uint8_t)~(LIS3MDL_STATUS_ZYXDA | LIS3MDL_STATUS_ZYXOR);
+            }
+            lis3mdl_sim_release(sim);
+        }
+    } else if ((reg == LIS3MDL_INT_SRC) && (sim->regs[LIS3MDL_INT_CFG] & LIS3MDL_INT_CFG_LIR)) {
+        sim->regs[LIS3MDL_INT_SRC] = 0u;
+    }
+
+    lis3mdl_sim_advance_pointer(sim);
+    return value;
+}
+
+static void lis3mdl_sim_write_byte(void *device, uint8_t value)
+{
+    lis3mdl_sim_t *sim = device;
+    uint8_t reg = sim->pointer;
+
+    switch (reg) {
+    case LIS3MDL_CTRL_REG1:
+        /* TEMP_EN and ST leave the conversion timing alone */
+        if ((sim->regs[reg] ^ value) & LIS3MDL_SIM_CTRL1_TIMING) {
+            sim->regs[reg] = value;
+            lis3mdl_sim_schedule(sim);
+        } else {
+            sim->regs[reg] = value;
+        }
+        break;
+    case LIS3MDL_CTRL_REG3:
+        sim->regs[reg] = value;
+        lis3mdl_sim_schedule(sim);
+        break;
+    case LIS3MDL_CTRL_REG2:
+        if (value & LIS3MDL_CTRL2_SOFT_RST) {
+            lis3mdl_sim_reset(sim);
+        } else {
+            /* REBOOT and SOFT_RST self-clear */
+            sim->regs[reg] = value & (uint8_t)~(LIS3MDL_CTRL2_REBOOT | LIS3MDL_CTRL2_SOFT_RST);
+        }
+        break;
+    case LIS3MDL_CTRL_REG4:
+    case LIS3MDL_CTRL_REG5:
+    case LIS3MDL_INT_THS_L:
+    case LIS3MDL_INT_THS_H:
+        sim->regs[reg] = value;
+        break;
+    case LIS3MDL_INT_CFG:
+        /* Bit 3 is reserved and reads back as 1 */
+        sim->regs[reg] = value | 0x08;
+        break;
+    default:
+        /* Read-only, reserved or past the register map: ignored */
+        break;
+    }
+
+    lis3mdl_sim_advance_pointer(sim);
+}
+
+static const i2c_sim_device_ops_t lis3mdl_sim_ops = {
+    .select = lis3mdl_sim_select,
+    .read_byte = lis3mdl_sim_read_byte,
+    .write_byte = lis3mdl_sim_write_byte,
+    .tick = lis3mdl_sim_tick,
+};
+
+status_t lis3mdl_sim_init(
+    lis3mdl_sim_t *sim,
+    uint8_t bus_id,
+    uint8_t bus_address)
+{
+    memset(sim, 0, sizeof(*sim));
+    sim->temperature_c = 25.0;
+    sim->now_ns = i2c_sim_now_ns();
+    lis3mdl_sim_reset(sim);
+
+    return i2c_sim_attach(bus_id, bus_address, &lis3mdl_sim_ops, sim);
+}
+
+void lis3mdl_sim_set_field(
+    lis3mdl_sim_t *sim,
+    double x_gauss,
+    double y_gauss,
+    double z_gauss)
+{
+    sim->field_gauss[0] = x_gauss;
+    sim->field_gauss[1] = y_gauss;
+    sim->field_gauss[2] = z_gauss;
+}
+
+void lis3mdl_sim_set_ramp(
+    lis3mdl_sim_t *sim,
+    int32_t ramp_lsb)
+{
+    sim->ramp_lsb = ramp_lsb;
+}
+
+void lis3mdl_sim_set_temperature(
+    lis3mdl_sim_t *sim,
+    double temperature_c)
+{
+    sim->temperature_c = temperature_c;
+}
+
+void lis3mdl_sim_set_drdy_callback(
+    lis3mdl_sim_t *sim,
+    lis3mdl_sim_pin_fn fn,
+    void *context)
+{
+    sim->drdy_fn = fn;
+    sim->drdy_context = context;
+}
+
+void lis3mdl_sim_set_int_callback(
+    lis3mdl_sim_t *sim,
+    lis3mdl_sim_pin_fn fn,
+    void *context)
+{
+    sim->int_fn = fn;
+    sim->int_context = context;
+}
@@ -0,0 +1,81 @@
+#ifndef LIS3MDL_SIM_HEADER_H
+#define LIS3MDL_SIM_HEADER_H
+
+/*
+ * Host-only register-accurate LIS3MDL model, attached behind the i2c.h API via i2c_sim.h.
+ *
+ * Models the register file (WHO_AM_I, CTRL_REG1..5, STATUS_REG, OUT_*, TEMP_OUT, INT_*),
+ * sub-address auto-increment including FAST_READ (wrapping at the end of the map; addresses
+ * past it read as 0 and ignore writes), block data update (per axis, as in the datasheet:
+ * the output block stays frozen from an LSB read until the matching MSB is read),
+ * continuous and single-conversion modes at the configured ODR/FAST_ODR against the
+ * virtual clock (a single conversion is refused under FAST_ODR and the device stays
+ * powered down), STATUS data-ready/overrun flags, and threshold interrupts on INT_SRC.
+ * The DRDY and INT pins are reported through callbacks invoked from the virtual clock.
+ */
+
+#include "i2c.h"
+
+#include <stdint.h>
+
+#define LIS3MDL_SIM_REG_COUNT 0x40u
+
+/* Pin edge callback. Runs with the bus simulation locked: must not issue I2C transfers. */
+typedef void (*lis3mdl_sim_pin_fn)(void *context, uint64_t now_ns);
+
+typedef struct {
+    uint8_t regs[LIS3MDL_SIM_REG_COUNT];
+    uint8_t pointer;             /* Register address of the next data byte */
+    uint8_t auto_increment;      /* Sub-address MSB of the current transfer */
+    uint8_t bdu_latch;           /* Axes whose LSB was read while BDU is set */
+    uint8_t pending_valid;       /* A conversion is held back by BDU */
+    uint8_t pending_out[6];
+    uint64_t now_ns;             /* Virtual time of the last tick */
+    uint64_t period_ns;          /* 0 while powered down */
+    uint64_t next_conversion_ns;
+    uint32_t conversions;
+    double field_gauss[3];
+    int32_t ramp_lsb;            /* Added to every axis once per conversion */
+    double temperature_c;
+    lis3mdl_sim_pin_fn drdy_fn;
+    void *drdy_context;
+    lis3mdl_sim_pin_fn int_fn;
+    void *int_context;
+} lis3mdl_sim_t;
+
+/* Reset the model to its power-on state and attach it at bus_id/bus_address. */
+status_t lis3mdl_sim_init(
+    lis3mdl_sim_t *sim,
+    uint8_t bus_id,
+    uint8_t bus_address);
+
+/* Field seen by the sensor, in gauss; applied from the next conversion. */
+void lis3mdl_sim_set_field(
+    lis3mdl_sim_t *sim,
+    double x_gauss,
+    double y_gauss,
+    double z_gauss);
+
+/*
+ * Add ramp_lsb * conversion_index to every axis, so consecutive samples differ by a
+ * known step (used to detect torn or repeated samples).
+ */
+void lis3mdl_sim_set_ramp(
+    lis3mdl_sim_t *sim,
+    int32_t ramp_lsb);
+
+void lis3mdl_sim_set_temperature(
+    lis3mdl_sim_t *sim,
+    double temperature_c);
+
+void lis3mdl_sim_set_drdy_callback(
+    lis3mdl_sim_t *sim,
+    lis3mdl_sim_pin_fn fn,
+    void *context);
+
+void lis3mdl_sim_set_int_callback(
+    lis3mdl_sim_t *sim,
+    lis3mdl_sim_pin_fn fn,
+    void *context);
+
+#endif
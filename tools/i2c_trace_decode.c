@@ -0,0 +1,122 @@
+/*
+ * Offline decoder for I2C trace dumps written by i2c_trace_dump_file or the crash handler.
+ *
+ * Merges the per-thread rings by timestamp and renders one line per transaction, with
+ * times relative to the oldest record still held in the rings. A slot counts when its
+ * sequence word places it at that slot; slots dumped mid-write carry a zero sequence.
+ *
+ * Build from the repository root:
+ *   cc -O2 -std=c11 -I. tools/i2c_trace_decode.c -o i2c_trace_decode
+ *
+ * Usage: i2c_trace_decode <dump file>
+ */
+
+#include "i2c_trace.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    i2c_trace_record_t record;
+    uint32_t thread_slot;
+} decoded_record_t;
+
+static int decoded_record_compare(const void *a, const void *b)
+{
+    const decoded_record_t *lhs = a;
+    const decoded_record_t *rhs = b;
+
+    if (lhs->record.timestamp != rhs->record.timestamp) {
+        return (lhs->record.timestamp < rhs->record.timestamp) ? -1 : 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    i2c_trace_file_header_t header;
+    i2c_trace_ring_t *ring;
+    decoded_record_t *records;
+    size_t count = 0u;
+    FILE *file;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <dump file>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    file = fopen(argv[1], "rb");
+    if (file == NULL) {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    if ((fread(&header, sizeof(header), 1u, file) != 1u) ||
+        (memcmp(header.magic, I2C_TRACE_MAGIC, sizeof(header.magic)) != 0) ||
+        (header.version != I2C_TRACE_VERSION) ||
+        (header.ring_length != I2C_TRACE_RING_LEN)) {
+        fprintf(stderr, "%s: not an I2C trace dump of version %u\n", argv[1], I2C_TRACE_VERSION);
+        fclose(file);
+        return EXIT_FAILURE;
+    }
+
+    ring = malloc(sizeof(*ring));
+    records = malloc((size_t)header.ring_count * I2C_TRACE_RING_LEN * sizeof(*records));
+    if ((ring == NULL) || (records == NULL)) {
+        fprintf(stderr, "out of memory\n");
+        fclose(file);
+        return EXIT_FAILURE;
+    }
+
+    for (uint32_t r = 0; r < header.ring_count; ++r) {
+        if (fread(ring, sizeof(*ring), 1u, file) != 1u) {
+            fprintf(stderr, "%s: truncated at ring %u\n", argv[1], r);
+            break;
+        }
+        if (!ring->in_use) {
+            continue;
+        }
+
+        /* The shared ring's head runs ahead of records still being written: trust the sequence */
+        for (uint32_t i = 0; i < I2C_TRACE_RING_LEN; ++i) {
+            const i2c_trace_record_t *record = &ring->records[i];
+
+            if ((record->sequence == 0u) || (((record->sequence - 1u) & (I2C_TRACE_RING_LEN - 1u)) != i)) {
+                continue;
+            }
+            records[count].record = *record;
+            records[count].thread_slot = ring->thread_slot;
+            count++;
+        }
+    }
+    fclose(file);
+
+    qsort(records, count, sizeof(*records), decoded_record_compare);
+
+    for (size_t i = 0; i < count; ++i) {
+        const i2c_trace_record_t *record = &records[i].record;
+        double us = 0.0;
+
+        if (header.ticks_per_second != 0u) {
+            us = ((double)(record->timestamp - records[0].record.timestamp) * 1e6) /
+                 (double)header.ticks_per_second;
+        }
+
+        printf("[%12.3f us] thread [%u] %s [%d] bytes %s bus [%d] device [%d] for register [%d] status [%d]\n",
+               us,
+               records[i].thread_slot,
+               (record->flags & I2C_TRACE_WRITE) ? "write" : "read",
+               record->length,
+               (record->flags & I2C_TRACE_WRITE) ? "to" : "from",
+               record->bus_id,
+               record->bus_address,
+               record->register_address,
+               record->status);
+    }
+
+    free(records);
+    free(ring);
+    return EXIT_SUCCESS;
+}
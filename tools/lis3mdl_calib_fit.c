@@ -0,0 +1,303 @@
+/*
+ * Offline hard-iron/soft-iron calibration of a recorded LIS3MDL data set.
+ *
+ * Maps the input and splits it into one chunk per thread. Every thread accumulates the
+ * ellipsoid-fit moments of its chunk (Lis3mdlCalibFitAccumulate), the per-thread fits are
+ * merged and solved once. The calibration is printed as a Lis3mdlCalib_st initializer
+ * and, with -o, written to a file as the raw struct.
+ *
+ * Inputs:
+ *   - an I2C capture (i2c_capture_start). Samples are the successful XYZ bursts
+ *     (OUT_X_L, 6 bytes) and status bursts with ZYXDA set (STATUS_REG, 7 or 9 bytes) read from
+ *     the sensor; writes to CTRL_REG2 update the full scale. The capture is walked up
+ *     front to find the sensor address (unless given with -a), then the record
+ *     boundaries and the full scale at each chunk start.
+ *   - with -r, a flat array of Lis3mdlSampleXYZ_st in host byte order, taken at -s.
+ *
+ * Build from the repository root:
+ *   cc -O2 -std=c11 -pthread -I. -IMagnetometer_Driver tools/lis3mdl_calib_fit.c \
+ *      Magnetometer_Driver/lis3mdl.c Magnetometer_Driver/lis3mdl_calib.c \
+ *      Magnetometer_Driver/lis3mdl_convert.c i2c.c i2c_capture.c i2c_clock.c i2c_stats.c \
+ *      i2c_trace.c lis3mdl_capture.c -lm -o lis3mdl_calib_fit
+ *
+ * Usage: lis3mdl_calib_fit [-t threads] [-a address] [-s 4|8|12|16] [-f gauss] [-o file] [-r] <input>
+ *   -t  worker threads (default: online CPUs)
+ *   -a  7-bit sensor address in a capture (default: that of the first sample)
+ *   -s  full scale in gauss before the first CTRL_REG2 write, or of a raw file (default 4)
+ *   -f  local field magnitude in gauss (default: keep the fitted size)
+ *   -o  also write the Lis3mdlCalib_st to this file
+ *   -r  input is a raw sample array instead of a capture
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "i2c.h"
+#include "i2c_capture.h"
+#include "lis3mdl.h"
+#include "lis3mdl_calib.h"
+#include "lis3mdl_capture.h"
+#include "lis3mdl_convert.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FIT_BATCH          1024u     /* Samples converted and accumulated at a time */
+#define FIT_MAX_THREADS    256u
+
+typedef struct {
+    const uint8_t *base;
+    size_t begin;              /* Byte range of the chunk; record aligned in a capture */
+    size_t end;
+    Lis3mdlScale_t scale;      /* Full scale at the start of the chunk */
+    uint8_t address;
+    uint8_t raw;
+    Lis3mdlCalibFit_st fit;
+    pthread_t thread;
+} fit_chunk_t;
+
+static uint64_t fit_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ull) + (uint64_t)ts.tv_nsec;
+}
+
+static void fit_flush(fit_chunk_t *chunk, Lis3mdlScale_t scale, const Lis3mdlSampleXYZ_st *samples,
+                      uint32_t count, float *field)
+{
+    if ((count == 0u) ||
+        (Lis3mdlConvertToFloat(scale, LIS3MDL_UNIT_GAUSS, samples, count, field) != STATUS_OK)) {
+        return;
+    }
+    Lis3mdlCalibFitAccumulate(&chunk->fit, field, count);
+}
+
+static void *fit_worker(void *arg)
+{
+    fit_chunk_t *chunk = arg;
+    static _Thread_local Lis3mdlSampleXYZ_st batch[FIT_BATCH];
+    static _Thread_local float field[3u * FIT_BATCH];
+    Lis3mdlScale_t scale = chunk->scale;
+    uint32_t count = 0u;
+    lis3mdl_capture_cursor_t cursor;
+    i2c_capture_record_t record;
+    const uint8_t *payload;
+
+    Lis3mdlCalibFitInit(&chunk->fit);
+
+    if (chunk->raw) {
+        const Lis3mdlSampleXYZ_st *samples = (const Lis3mdlSampleXYZ_st *)(const void *)&chunk->base[chunk->begin];
+        size_t total = (chunk->end - chunk->begin) / sizeof(*samples);
+
+        for (size_t i = 0; i < total; i += FIT_BATCH) {
+            count = ((total - i) < FIT_BATCH) ? (uint32_t)(total - i) : FIT_BATCH;
+            fit_flush(chunk, scale, &samples[i], count, field);
+        }
+        return NULL;
+    }
+
+    lis3mdl_capture_cursor_init(&cursor, chunk->base, chunk->begin, chunk->end);
+    while (lis3mdl_capture_next(&cursor, &record, &payload)) {
+        Lis3mdlScale_t written = lis3mdl_capture_scale(&record, payload, chunk->address);
+
+        if ((written != LIS3MDL_SCALE_UNKNOWN) && (written != scale)) {
+            fit_flush(chunk, scale, batch, count, field);
+            count = 0u;
+            scale = written;
+        }
+
+        if (lis3mdl_capture_sample(&record, payload, chunk->address, &batch[count], NULL) &&
+            (++count == FIT_BATCH)) {
+            fit_flush(chunk, scale, batch, count, field);
+            count = 0u;
+        }
+    }
+    fit_flush(chunk, scale, batch, count, field);
+
+    return NULL;
+}
+
+/*
+ * Split a capture into record-aligned chunks of about equal size and note the full
+ * scale in effect at each chunk start. Returns the end of the last complete record.
+ * The sensor address must be known: full-scale writes before the first sample count
+ * only when they are addressed to it, as in the workers.
+ */
+static size_t fit_split_capture(const uint8_t *base, size_t size, Lis3mdlScale_t scale, uint8_t address,
+                                fit_chunk_t *chunks, uint32_t threads)
+{
+    lis3mdl_capture_cursor_t cursor;
+    uint32_t next = 0u;
+    i2c_capture_record_t record;
+    const uint8_t *payload;
+
+    size_t chunk_bytes = (size - sizeof(i2c_capture_file_header_t)) / threads;
+    size_t boundary = sizeof(i2c_capture_file_header_t);
+
+    lis3mdl_capture_cursor_init(&cursor, base, sizeof(i2c_capture_file_header_t), size);
+
+    /* A dependent hop per record: only writes need decoding */
+    for (;;) {
+        size_t offset = cursor.offset;
+        Lis3mdlScale_t written;
+
+        if (!lis3mdl_capture_next(&cursor, &record, &payload)) {
+            break;
+        }
+        while ((next < threads) && (offset >= boundary)) {
+            chunks[next].begin = offset;
+            chunks[next].scale = scale;
+            next++;
+            boundary += chunk_bytes;
+        }
+
+        written = lis3mdl_capture_scale(&record, payload, address);
+        scale = (written != LIS3MDL_SCALE_UNKNOWN) ? written : scale;
+    }
+
+    /* Chunks starting past the last record are left empty */
+    for (; next < threads; ++next) {
+        chunks[next].begin = cursor.offset;
+        chunks[next].scale = scale;
+    }
+    return cursor.offset;
+}
+
+int main(int argc, char **argv)
+{
+    static fit_chunk_t chunks[FIT_MAX_THREADS];
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t threads = (online > 0) ? (uint32_t)online : 1u;
+    uint8_t address = LIS3MDL_CAPTURE_ADDRESS_ANY;
+    Lis3mdlScale_t scale = LIS3MDL_SCALE_4G;
+    float field_gauss = 0.0f;
+    const char *output = NULL;
+    int raw = 0;
+    Lis3mdlCalibFit_st fit;
+    Lis3mdlCalib_st calib;
+    struct stat info;
+    const uint8_t *base;
+    size_t end;
+    uint64_t start;
+    uint64_t split_ns;
+    uint64_t total_ns;
+    int opt;
+    int fd;
+
+    while ((opt = getopt(argc, argv, "t:a:s:f:o:r")) != -1) {
+        switch (opt) {
+        case 't': threads = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'a': address = (uint8_t)strtoul(optarg, NULL, 0); break;
+        case 's':
+            if (!lis3mdl_capture_parse_scale(optarg, &scale)) {
+                fprintf(stderr, "%s: full scale must be 4, 8, 12 or 16\n", argv[0]);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'f': field_gauss = strtof(optarg, NULL); break;
+        case 'o': output = optarg; break;
+        case 'r': raw = 1; break;
+        default: threads = 0u; break;
+        }
+    }
+
+    if ((optind != (argc - 1)) || (threads == 0u) || (threads > FIT_MAX_THREADS)) {
+        fprintf(stderr, "usage: %s [-t threads] [-a address] [-s 4|8|12|16] [-f gauss] [-o file] [-r] <input>\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    fd = open(argv[optind], O_RDONLY);
+    if ((fd < 0) || (fstat(fd, &info) != 0)) {
+        perror(argv[optind]);
+        return EXIT_FAILURE;
+    }
+    if (info.st_size == 0) {
+        fprintf(stderr, "%s: empty input\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+    base = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        perror("mmap");
+        return EXIT_FAILURE;
+    }
+
+    start = fit_now_ns();
+    if (raw) {
+        size_t samples = (size_t)info.st_size / sizeof(Lis3mdlSampleXYZ_st);
+
+        end = samples * sizeof(Lis3mdlSampleXYZ_st);
+        for (uint32_t i = 0; i < threads; ++i) {
+            chunks[i].begin = ((samples * i) / threads) * sizeof(Lis3mdlSampleXYZ_st);
+            chunks[i].scale = scale;
+        }
+    } else {
+        if (!lis3mdl_capture_check(base, (size_t)info.st_size)) {
+            fprintf(stderr, "%s: not an I2C capture of version %u (use -r for raw samples)\n",
+                    argv[optind], I2C_CAPTURE_VERSION);
+            return EXIT_FAILURE;
+        }
+        if (address == LIS3MDL_CAPTURE_ADDRESS_ANY) {
+            address = lis3mdl_capture_find_address(base, (size_t)info.st_size);
+        }
+        end = fit_split_capture(base, (size_t)info.st_size, scale, address, chunks, threads);
+    }
+    split_ns = fit_now_ns() - start;
+
+    for (uint32_t i = 0; i < threads; ++i) {
+        chunks[i].base = base;
+        chunks[i].end = ((i + 1u) < threads) ? chunks[i + 1u].begin : end;
+        chunks[i].address = address;
+        chunks[i].raw = (uint8_t)raw;
+        if (pthread_create(&chunks[i].thread, NULL, fit_worker, &chunks[i]) != 0) {
+            fprintf(stderr, "%s: cannot start worker %u\n", argv[0], i);
+            return EXIT_FAILURE;
+        }
+    }
+
+    Lis3mdlCalibFitInit(&fit);
+    for (uint32_t i = 0; i < threads; ++i) {
+        pthread_join(chunks[i].thread, NULL);
+        Lis3mdlCalibFitMerge(&fit, &chunks[i].fit);
+    }
+
+    if (Lis3mdlCalibFitSolve(&fit, field_gauss, &calib) != STATUS_OK) {
+        fprintf(stderr, "%s: %llu samples do not determine an ellipsoid\n",
+                argv[optind], (unsigned long long)fit.count_u64);
+        return EXIT_FAILURE;
+    }
+    total_ns = fit_now_ns() - start;
+
+    printf("static const Lis3mdlCalib_st calib =\n{\n");
+    printf("    { %.9gf, %.9gf, %.9gf },\n", calib.offset_af32[0], calib.offset_af32[1], calib.offset_af32[2]);
+    printf("    { %.9gf, %.9gf, %.9gf,\n      %.9gf, %.9gf, %.9gf,\n      %.9gf, %.9gf, %.9gf }\n};\n",
+           calib.softIron_af32[0], calib.softIron_af32[1], calib.softIron_af32[2],
+           calib.softIron_af32[3], calib.softIron_af32[4], calib.softIron_af32[5],
+           calib.softIron_af32[6], calib.softIron_af32[7], calib.softIron_af32[8]);
+
+    fprintf(stderr, "%llu samples, %u threads, split %.3f s, total %.3f s, %.1f Msamples/s\n",
+            (unsigned long long)fit.count_u64, threads, (double)split_ns / 1e9, (double)total_ns / 1e9,
+            ((double)fit.count_u64 * 1e3) / (double)total_ns);
+
+    if (output != NULL) {
+        FILE *file = fopen(output, "wb");
+
+        if ((file == NULL) || (fwrite(&calib, sizeof(calib), 1u, file) != 1u) || (fclose(file) != 0)) {
+            perror(output);
+            return EXIT_FAILURE;
+        }
+    }
+
+    munmap((void *)base, (size_t)info.st_size);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+/*
+ * Plan the LIS3MDL configuration for a sampling requirement.
+ *
+ * Takes the rate every sensor must deliver, the RMS noise it may have, the full scale,
+ * the I2C clock and the bus of each sensor, and prints the configuration drawing the
+ * least supply current that meets them (Lis3mdlPlanChoose): operating mode, ODR or
+ * FAST_ODR, continuous or single-conversion sampling and full or FAST_READ reads, with
+ * the predicted current, busiest-bus utilisation and worst-case latency, and the
+ * Lis3mdlSpeedConfig_st to program. With -a every candidate is listed, feasible or not.
+ *
+ * The figures come from the typical datasheet values in lis3mdl_plan.c.
+ *
+ * Build from the repository root:
+ *   cc -O2 -std=c11 -I. -IMagnetometer_Driver tools/lis3mdl_plan.c \
+ *      Magnetometer_Driver/lis3mdl_plan.c Magnetometer_Driver/lis3mdl.c \
+ *      i2c.c i2c_capture.c i2c_clock.c i2c_stats.c i2c_trace.c -pthread -lm -o lis3mdl_plan
+ *
+ * Usage: lis3mdl_plan [-n mgauss] [-s 4|8|12|16] [-c hz] [-u fraction] [-d bus,bus,...] [-a] <rate_hz>
+ *   -n  largest RMS noise per axis in milligauss (default: any)
+ *   -s  full scale in gauss (default 4)
+ *   -c  I2C clock in Hz (default 400000)
+ *   -u  largest busy fraction of any bus (default 1)
+ *   -d  bus of each sensor, one entry per sensor (default 0: a single sensor on bus 0)
+ *   -a  list every candidate
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "i2c.h"
+#include "lis3mdl.h"
+#include "lis3mdl_plan.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char *const plan_mode_name[] = { "LP", "MP", "HP", "UHP" };
+static const char *const plan_mode_enum[] = {
+    "LIS3MDL_MODE_LP", "LIS3MDL_MODE_MP", "LIS3MDL_MODE_HP", "LIS3MDL_MODE_UHP"
+};
+static const char *const plan_odr_enum[] = {
+    "LIS3MDL_ODR_0_625_HZ", "LIS3MDL_ODR_1_25_HZ", "LIS3MDL_ODR_2_5_HZ", "LIS3MDL_ODR_5_HZ",
+    "LIS3MDL_ODR_10_HZ", "LIS3MDL_ODR_20_HZ", "LIS3MDL_ODR_40_HZ", "LIS3MDL_ODR_80_HZ"
+};
+
+static int plan_parse_scale(const char *text, Lis3mdlScale_t *scale)
+{
+    switch (strtoul(text, NULL, 0)) {
+    case 4: *scale = LIS3MDL_SCALE_4G; return 1;
+    case 8: *scale = LIS3MDL_SCALE_8G; return 1;
+    case 12: *scale = LIS3MDL_SCALE_12G; return 1;
+    case 16: *scale = LIS3MDL_SCALE_16G; return 1;
+    default: return 0;
+    }
+}
+
+static int plan_parse_buses(const char *text, Lis3mdlPlanRequest_st *request)
+{
+    char *end;
+
+    request->deviceCount_u8 = 0u;
+    do {
+        unsigned long bus = strtoul(text, &end, 0);
+
+        if ((end == text) || (bus > UINT8_MAX) || (request->deviceCount_u8 >= LIS3MDL_PLAN_MAX_DEVICES)) {
+            return 0;
+        }
+        request->bus_au8[request->deviceCount_u8++] = (uint8_t)bus;
+        text = end + 1;
+    } while (*end == ',');
+
+    return (*end == '\0');
+}
+
+static void plan_print(const Lis3mdlPlan_st *plan)
+{
+    printf("%-4s %-10s %-4s %9.3f Hz %9.1f uA %9.1f uA %6.2f mG %6.2f %% %8u us%s\n",
+           plan_mode_name[plan->speed_st.operatingMode_en],
+           (plan->sampling_en == LIS3MDL_PLAN_CONTINUOUS) ? "continuous" : "single",
+           (plan->read_en == LIS3MDL_PLAN_READ_FAST) ? "fast" : "full",
+           plan->conversionMilliHz_u32 / 1000.0, plan->currentMicroAmp_f32, plan->totalCurrentMicroAmp_f32,
+           plan->noiseMilliGauss_f32, plan->busUtilization_f32 * 100.0f, plan->latencyUs_u32,
+           plan->feasible_u8 ? "" : "  (over limits)");
+}
+
+int main(int argc, char **argv)
+{
+    Lis3mdlPlanRequest_st request;
+    Lis3mdlPlan_st plan;
+    double rate_hz = 0.0;
+    int list = 0;
+    int opt;
+
+    memset(&request, 0, sizeof(request));
+    request.scale_en = LIS3MDL_SCALE_4G;
+    request.busHz_u32 = 400000u;
+    request.deviceCount_u8 = 1u;
+
+    while ((opt = getopt(argc, argv, "n:s:c:u:d:a")) != -1) {
+        switch (opt) {
+        case 'n': request.noiseMilliGauss_f32 = strtof(optarg, NULL); break;
+        case 's':
+            if (!plan_parse_scale(optarg, &request.scale_en)) {
+                fprintf(stderr, "%s: full scale must be 4, 8, 12 or 16\n", argv[0]);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'c': request.busHz_u32 = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'u': request.maxBusUtilization_f32 = strtof(optarg, NULL); break;
+        case 'd':
+            if (!plan_parse_buses(optarg, &request)) {
+                fprintf(stderr, "%s: -d takes 1 to %u comma-separated bus numbers\n", argv[0],
+                        LIS3MDL_PLAN_MAX_DEVICES);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'a': list = 1; break;
+        default: optind = argc; break;
+        }
+    }
+
+    if (optind == (argc - 1)) {
+        rate_hz = strtod(argv[optind], NULL);
+    }
+    if ((rate_hz <= 0.0) || (rate_hz > 4294967.0)) {
+        fprintf(stderr, "usage: %s [-n mgauss] [-s 4|8|12|16] [-c hz] [-u fraction] [-d bus,bus,...] [-a] <rate_hz>\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+    request.rateMilliHz_u32 = (uint32_t)ceil(rate_hz * 1000.0);
+
+    if (list) {
+        printf("%-4s %-10s %-4s %12s %12s %12s %9s %8s %11s\n", "mode", "sampling", "read", "conversions",
+               "per sensor", "total", "noise", "bus", "latency");
+        for (uint32_t mode = 0u; mode < 4u; ++mode) {
+            for (uint32_t sampling = LIS3MDL_PLAN_CONTINUOUS; sampling <= LIS3MDL_PLAN_SINGLE; ++sampling) {
+                for (uint32_t read = LIS3MDL_PLAN_READ_FULL; read <= LIS3MDL_PLAN_READ_FAST; ++read) {
+                    if (Lis3mdlPlanEvaluate(&request, (Lis3mdlOperatingMode_t)mode, (Lis3mdlPlanSampling_t)sampling,
+                                            (Lis3mdlPlanRead_t)read, &plan) == STATUS_OK) {
+                        plan_print(&plan);
+                    }
+                }
+            }
+        }
+        printf("\n");
+    }
+
+    if (Lis3mdlPlanChoose(&request, &plan) != STATUS_OK) {
+        fprintf(stderr, "%s: no configuration delivers %g Hz from %u sensor(s) within the limits\n",
+                argv[0], rate_hz, request.deviceCount_u8);
+        return EXIT_FAILURE;
+    }
+
+    printf("chosen:\n");
+    plan_print(&plan);
+    printf("\nstatic const Lis3mdlSpeedConfig_st speed = { %s, %s, %uu };\n",
+           plan_odr_enum[plan.speed_st.dataRate_en], plan_mode_enum[plan.speed_st.operatingMode_en],
+           plan.speed_st.fastOdr_u8);
+    printf("/* %s sampling, %s reads */\n",
+           (plan.sampling_en == LIS3MDL_PLAN_CONTINUOUS) ? "continuous (MD = 00)" : "single-conversion (lis3mdl_sched)",
+           (plan.read_en == LIS3MDL_PLAN_READ_FAST) ? "FAST_READ" : "16-bit");
+
+    return EXIT_SUCCESS;
+}
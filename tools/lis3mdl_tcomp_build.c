@@ -0,0 +1,337 @@
+/*
+ * Build a LIS3MDL temperature compensation table from thermal-chamber captures.
+ *
+ * Every input is an I2C capture (i2c_capture_start) recorded while the chamber sweeps
+ * temperature with the sensor in a known, constant field, given after the file name in
+ * gauss (default 0,0,0 for a shielded run). Samples are decoded by lis3mdl_capture.h,
+ * as in lis3mdl_calib_fit (XYZ and status bursts, CTRL_REG2 writes track the full scale);
+ * the temperature is the latest TEMP_OUT read, either inside a 9-byte status burst or on
+ * its own. Samples read before the first temperature are ignored.
+ *
+ * Per table point and axis the measurement is fitted as m = r / gain + offset by least
+ * squares, with samples weighted by their linear interpolation weight towards the point
+ * (the weight Lis3mdlTcompLookup gives the point at that temperature). Inputs at two or
+ * more distinct reference fields on an axis are needed to resolve its gain; otherwise the
+ * gain stays 1 and only the offset is fitted. Points without samples are interpolated
+ * from their neighbours.
+ *
+ * The table is printed as a Lis3mdlTcompTable_st initializer and, with -o, written to a
+ * file as the raw struct.
+ *
+ * Build from the repository root:
+ *   cc -O2 -std=c11 -I. -IMagnetometer_Driver tools/lis3mdl_tcomp_build.c \
+ *      Magnetometer_Driver/lis3mdl.c i2c.c i2c_capture.c i2c_clock.c i2c_stats.c i2c_trace.c \
+ *      lis3mdl_capture.c -pthread -lm -o lis3mdl_tcomp_build
+ *
+ * Usage: lis3mdl_tcomp_build [-a address] [-s 4|8|12|16] [-d degC] [-o file] <capture[:bx,by,bz]>...
+ *   -a  7-bit sensor address (default: that of the first sample of each capture)
+ *   -s  full scale in gauss before the first CTRL_REG2 write (default 4)
+ *   -d  temperature step between table points in degrees Celsius (default 5)
+ *   -o  also write the Lis3mdlTcompTable_st to this file
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "i2c.h"
+#include "i2c_capture.h"
+#include "lis3mdl.h"
+#include "lis3mdl_capture.h"
+#include "lis3mdl_tcomp.h"
+
+#include <fcntl.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define BUILD_TEMP_BINS       65536u    /* One bin per TEMP_OUT value */
+#define BUILD_TEMP_LSB_DEGC   8.0       /* TEMP_OUT sensitivity */
+#define BUILD_GAIN_MIN_VAR    1e-6      /* Reference field variance (gauss^2) needed to fit a gain */
+
+/* Sufficient statistics of the per-axis regression of measurement m on reference r */
+typedef struct {
+    double n;
+    double r[3];
+    double m[3];
+    double rr[3];
+    double rm[3];
+} build_stats_t;
+
+static build_stats_t build_bins[BUILD_TEMP_BINS];
+
+static void build_add(int16_t temperature, const double *measured, const double *reference)
+{
+    build_stats_t *bin = &build_bins[(uint16_t)temperature];
+
+    bin->n += 1.0;
+    for (uint32_t axis = 0; axis < 3u; ++axis) {
+        bin->r[axis] += reference[axis];
+        bin->m[axis] += measured[axis];
+        bin->rr[axis] += reference[axis] * reference[axis];
+        bin->rm[axis] += reference[axis] * measured[axis];
+    }
+}
+
+/* Accumulate one capture; returns the number of samples used, or -1 on error. */
+static long build_capture(const char *path, const double *reference, uint8_t address, Lis3mdlScale_t scale)
+{
+    int16_t temperature = LIS3MDL_TEMP_INVALID;
+    uint16_t lsb_per_gauss = 0u;
+    long used = 0;
+    struct stat info;
+    const uint8_t *base;
+    size_t size;
+    lis3mdl_capture_cursor_t cursor;
+    i2c_capture_record_t record;
+    const uint8_t *payload;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if ((fd < 0) || (fstat(fd, &info) != 0)) {
+        perror(path);
+        return -1;
+    }
+    size = (size_t)info.st_size;
+    if ((size < sizeof(i2c_capture_file_header_t)) ||
+        ((base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)) {
+        fprintf(stderr, "%s: cannot map capture\n", path);
+        close(fd);
+        return -1;
+    }
+    close(fd);
+
+    if (!lis3mdl_capture_check(base, size)) {
+        fprintf(stderr, "%s: not an I2C capture of version %u\n", path, I2C_CAPTURE_VERSION);
+        munmap((void *)base, size);
+        return -1;
+    }
+
+    /* The first sensor seen owns the capture, setup writes before its first sample included */
+    if (address == LIS3MDL_CAPTURE_ADDRESS_ANY) {
+        address = lis3mdl_capture_find_address(base, size);
+    }
+    (void)Lis3mdlGetSensitivity(scale, &lsb_per_gauss);
+
+    lis3mdl_capture_cursor_init(&cursor, base, sizeof(i2c_capture_file_header_t), size);
+    while (lis3mdl_capture_next(&cursor, &record, &payload)) {
+        Lis3mdlScale_t written = lis3mdl_capture_scale(&record, payload, address);
+        Lis3mdlSampleXYZ_st sample;
+        double measured[3];
+
+        if ((written != LIS3MDL_SCALE_UNKNOWN) && (Lis3mdlGetSensitivity(written, &lsb_per_gauss) != STATUS_OK)) {
+            lsb_per_gauss = 0u;
+        }
+
+        if (!lis3mdl_capture_sample(&record, payload, address, &sample, &temperature) ||
+            (temperature == LIS3MDL_TEMP_INVALID) || (lsb_per_gauss == 0u)) {
+            continue;
+        }
+        measured[0] = (double)sample.x_s16 / lsb_per_gauss;
+        measured[1] = (double)sample.y_s16 / lsb_per_gauss;
+        measured[2] = (double)sample.z_s16 / lsb_per_gauss;
+        build_add(temperature, measured, reference);
+        used++;
+    }
+
+    munmap((void *)base, size);
+    return used;
+}
+
+/* Weighted least squares of m = r / gain + offset for every point and axis. */
+static void build_solve(Lis3mdlTcompTable_st *table, int32_t first, uint32_t step, int32_t low, int32_t high)
+{
+    static build_stats_t points[LIS3MDL_TCOMP_MAX_POINTS];
+    uint8_t valid[LIS3MDL_TCOMP_MAX_POINTS] = { 0 };
+
+    memset(points, 0, sizeof(points));
+
+    /* Spread each bin over its two neighbouring points with the lookup's weights */
+    for (int32_t t = low; t <= high; ++t) {
+        const build_stats_t *bin = &build_bins[(uint16_t)t];
+        uint32_t index = (uint32_t)(t - first) / step;
+        double frac = (double)((uint32_t)(t - first) - (index * step)) / (double)step;
+
+        if (bin->n == 0.0) {
+            continue;
+        }
+        for (uint32_t side = 0; side < 2u; ++side) {
+            double w = side ? frac : (1.0 - frac);
+            build_stats_t *point = &points[index + side];
+
+            if ((w == 0.0) || ((index + side) >= table->count_u16)) {
+                continue;
+            }
+            point->n += w * bin->n;
+            for (uint32_t axis = 0; axis < 3u; ++axis) {
+                point->r[axis] += w * bin->r[axis];
+                point->m[axis] += w * bin->m[axis];
+                point->rr[axis] += w * bin->rr[axis];
+                point->rm[axis] += w * bin->rm[axis];
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < table->count_u16; ++i) {
+        const build_stats_t *point = &points[i];
+
+        if (point->n < 1.0) {
+            continue;
+        }
+        valid[i] = 1u;
+        for (uint32_t axis = 0; axis < 3u; ++axis) {
+            double mean_r = point->r[axis] / point->n;
+            double mean_m = point->m[axis] / point->n;
+            double var_r = (point->rr[axis] / point->n) - (mean_r * mean_r);
+            double cov = (point->rm[axis] / point->n) - (mean_r * mean_m);
+            double slope = (var_r > BUILD_GAIN_MIN_VAR) ? (cov / var_r) : 1.0;
+
+            table->point_ast[i].gain_af32[axis] = (float)(1.0 / slope);
+            table->point_ast[i].offset_af32[axis] = (float)(mean_m - (slope * mean_r));
+        }
+    }
+
+    /* Fill empty points from the nearest valid ones on each side */
+    for (uint32_t i = 0; i < table->count_u16; ++i) {
+        int32_t left = (int32_t)i;
+        uint32_t right = i;
+
+        if (valid[i]) {
+            continue;
+        }
+        while ((left >= 0) && !valid[left]) {
+            left--;
+        }
+        while ((right < table->count_u16) && !valid[right]) {
+            right++;
+        }
+        if (left < 0) {
+            table->point_ast[i] = table->point_ast[right];
+        } else if (right >= table->count_u16) {
+            table->point_ast[i] = table->point_ast[left];
+        } else {
+            float frac = (float)(i - (uint32_t)left) / (float)(right - (uint32_t)left);
+            const Lis3mdlTcompPoint_st *a = &table->point_ast[left];
+            const Lis3mdlTcompPoint_st *b = &table->point_ast[right];
+
+            for (uint32_t axis = 0; axis < 3u; ++axis) {
+                table->point_ast[i].offset_af32[axis] =
+                    a->offset_af32[axis] + (frac * (b->offset_af32[axis] - a->offset_af32[axis]));
+                table->point_ast[i].gain_af32[axis] =
+                    a->gain_af32[axis] + (frac * (b->gain_af32[axis] - a->gain_af32[axis]));
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static Lis3mdlTcompTable_st table;
+    uint8_t address = LIS3MDL_CAPTURE_ADDRESS_ANY;
+    Lis3mdlScale_t scale = LIS3MDL_SCALE_4G;
+    double step_degc = 5.0;
+    const char *output = NULL;
+    int32_t low = INT16_MAX;
+    int32_t high = INT16_MIN;
+    uint32_t step;
+    long total = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "a:s:d:o:")) != -1) {
+        switch (opt) {
+        case 'a': address = (uint8_t)strtoul(optarg, NULL, 0); break;
+        case 's':
+            if (!lis3mdl_capture_parse_scale(optarg, &scale)) {
+                fprintf(stderr, "%s: full scale must be 4, 8, 12 or 16\n", argv[0]);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'd': step_degc = strtod(optarg, NULL); break;
+        case 'o': output = optarg; break;
+        default: step_degc = 0.0; break;
+        }
+    }
+
+    step = (uint32_t)lround(step_degc * BUILD_TEMP_LSB_DEGC);
+    if ((optind >= argc) || (step == 0u) || (step > UINT16_MAX)) {
+        fprintf(stderr, "usage: %s [-a address] [-s 4|8|12|16] [-d degC] [-o file] <capture[:bx,by,bz]>...\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (int i = optind; i < argc; ++i) {
+        char path[4096];
+        double reference[3] = { 0.0, 0.0, 0.0 };
+        char *field;
+        long used;
+
+        snprintf(path, sizeof(path), "%s", argv[i]);
+        field = strrchr(path, ':');
+        if (field != NULL) {
+            *field++ = '\0';
+            if (sscanf(field, "%lf,%lf,%lf", &reference[0], &reference[1], &reference[2]) != 3) {
+                fprintf(stderr, "%s: reference field must be bx,by,bz in gauss\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+
+        used = build_capture(path, reference, address, scale);
+        if (used < 0) {
+            return EXIT_FAILURE;
+        }
+        fprintf(stderr, "%s: %ld samples at (%g, %g, %g) gauss\n", path, used,
+                reference[0], reference[1], reference[2]);
+        total += used;
+    }
+
+    for (int32_t t = INT16_MIN + 1; t <= INT16_MAX; ++t) {
+        if (build_bins[(uint16_t)t].n != 0.0) {
+            low = (t < low) ? t : low;
+            high = t;
+        }
+    }
+    if (total == 0) {
+        fprintf(stderr, "%s: no samples with a temperature reading\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    table.tempFirst_s16 = (int16_t)low;
+    table.tempStep_u16 = (uint16_t)step;
+    table.count_u16 = (uint16_t)((((uint32_t)(high - low) + step - 1u) / step) + 1u);
+    if (table.count_u16 > LIS3MDL_TCOMP_MAX_POINTS) {
+        fprintf(stderr, "%s: %.1f to %.1f degC needs %u points of %g degC, at most %u fit (raise -d)\n",
+                argv[0], 25.0 + (low / BUILD_TEMP_LSB_DEGC), 25.0 + (high / BUILD_TEMP_LSB_DEGC),
+                table.count_u16, step_degc, LIS3MDL_TCOMP_MAX_POINTS);
+        return EXIT_FAILURE;
+    }
+    build_solve(&table, low, step, low, high);
+
+    printf("static const Lis3mdlTcompTable_st tcomp =\n{\n");
+    printf("    %d, %u, %u,\n    {\n", table.tempFirst_s16, table.tempStep_u16, table.count_u16);
+    for (uint32_t i = 0; i < table.count_u16; ++i) {
+        const Lis3mdlTcompPoint_st *point = &table.point_ast[i];
+
+        printf("        { { %.9gf, %.9gf, %.9gf }, { %.9gf, %.9gf, %.9gf } },  /* %.1f degC */\n",
+               point->offset_af32[0], point->offset_af32[1], point->offset_af32[2],
+               point->gain_af32[0], point->gain_af32[1], point->gain_af32[2],
+               25.0 + ((table.tempFirst_s16 + (double)(i * step)) / BUILD_TEMP_LSB_DEGC));
+    }
+    printf("    }\n};\n");
+
+    fprintf(stderr, "%ld samples, %u points from %.1f degC every %g degC\n", total, table.count_u16,
+            25.0 + (low / BUILD_TEMP_LSB_DEGC), step_degc);
+
+    if (output != NULL) {
+        FILE *file = fopen(output, "wb");
+
+        if ((file == NULL) || (fwrite(&table, sizeof(table), 1u, file) != 1u) || (fclose(file) != 0)) {
+            perror(output);
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}